@@ -0,0 +1,159 @@
+#ifndef __hmath_Aligned__
+#define __hmath_Aligned__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace hm {
+
+/* Size in bytes of a cache line on the targeted hardware. */
+const static std::size_t CacheLineSize = 64;
+
+/**
+ * Alignment of Vector<N> storage.
+ *
+ * By default vectors are aligned as plain floats.  Defining HMATH_ALIGNED_STORAGE before including any hmath header
+ * raises Vector<4> to 16 bytes so that it can be moved with aligned SIMD loads and stores.  The option must be set
+ * identically in every translation unit.
+ *
+ * Before C++17, std::allocator and plain new ignore alignments above that of max_align_t, so with the option defined
+ * arrays of Vector<4> and Matrix<4, 4>, or of types containing them, must be stored in an AlignedArray.  hmath's own
+ * containers do so.
+ */
+template<int N>
+struct VectorAlignment {
+	static const std::size_t value = alignof(float);
+};
+
+/**
+ * Alignment of Matrix<Rows, Cols> storage.
+ *
+ * With HMATH_ALIGNED_STORAGE defined, Matrix<4, 4> is aligned to a full cache line so that it never straddles two lines.
+ */
+template<int Rows, int Cols>
+struct MatrixAlignment {
+	static const std::size_t value = alignof(float);
+};
+
+#if defined(HMATH_ALIGNED_STORAGE)
+template<>
+struct VectorAlignment<4> {
+	static const std::size_t value = 16;
+};
+
+template<>
+struct MatrixAlignment<4, 4> {
+	static const std::size_t value = CacheLineSize;
+};
+#endif
+
+/**
+ * Returns true if the given pointer is a multiple of the given alignment.
+ *
+ * @param ptr       Pointer to test.
+ * @param alignment Alignment in bytes; must be a power of two.
+ */
+inline bool isAligned( const void* ptr, std::size_t alignment ) {
+	return (reinterpret_cast<std::uintptr_t>(ptr) & (alignment - 1)) == 0;
+}
+
+/**
+ * Allocates a block of memory with the given alignment.  Must be released with alignedFree.  Returns null if the
+ * memory is not available, including sizes too large to pad for the alignment.
+ *
+ * @param size      Size in bytes.
+ * @param alignment Alignment in bytes; must be a power of two.
+ */
+inline void* alignedMalloc( std::size_t size, std::size_t alignment ) {
+	// over-allocate and stash the original pointer immediately before the aligned block
+	const std::size_t offset = alignment - 1 + sizeof(void*);
+	if( size > std::numeric_limits<std::size_t>::max() - offset ) {
+		return nullptr;
+	}
+	void* raw = std::malloc(size + offset);
+	if( !raw ) {
+		return nullptr;
+	}
+	const std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(raw) + offset) & ~static_cast<std::uintptr_t>(alignment - 1);
+	reinterpret_cast<void**>(aligned)[-1] = raw;
+	return reinterpret_cast<void*>(aligned);
+}
+
+/**
+ * Releases a block of memory allocated with alignedMalloc.
+ *
+ * @param ptr Pointer returned by alignedMalloc, or null.
+ */
+inline void alignedFree( void* ptr ) {
+	if( ptr ) {
+		std::free(reinterpret_cast<void**>(ptr)[-1]);
+	}
+}
+
+/**
+ * Standard allocator returning memory aligned to at least Alignment bytes (a cache line by default).
+ *
+ * Using it with std::vector makes bulk arrays of hmath types cache-line-aligned, which allows aligned loads and
+ * streaming stores over the whole array and keeps over-aligned types (see HMATH_ALIGNED_STORAGE) correctly aligned.
+ */
+template<typename T, std::size_t Alignment = (alignof(T) > CacheLineSize ? alignof(T) : CacheLineSize)>
+class AlignedAllocator {
+public:
+	static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+	static_assert(Alignment >= alignof(T), "Alignment must be at least that of the allocated type.");
+
+	using value_type = T;
+
+	template<typename U>
+	struct rebind {
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	AlignedAllocator() {
+	}
+
+	template<typename U>
+	AlignedAllocator( const AlignedAllocator<U, Alignment>& ) {
+	}
+
+	std::size_t max_size() const {
+		return std::numeric_limits<std::size_t>::max() / sizeof(T);
+	}
+
+	T* allocate( std::size_t count ) {
+		if( count > max_size() ) {
+			throw std::bad_array_new_length();
+		}
+		void* ptr = alignedMalloc(count * sizeof(T), Alignment);
+		if( !ptr ) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(ptr);
+	}
+
+	void deallocate( T* ptr, std::size_t ) {
+		alignedFree(ptr);
+	}
+};
+
+template<typename T, typename U, std::size_t Alignment>
+inline bool operator==( const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>& ) {
+	return true;
+}
+
+template<typename T, typename U, std::size_t Alignment>
+inline bool operator!=( const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>& ) {
+	return false;
+}
+
+/* std::vector whose storage starts on a cache line boundary. */
+template<typename T>
+using AlignedArray = std::vector<T, AlignedAllocator<T>>;
+
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef __hmath_AnimationTrack__
+#define __hmath_AnimationTrack__
+
+#include <algorithm>
+#include <vector>
+#include "Simd.hpp"
+#include "Tracing.hpp"
+#include "Vector.hpp"
+
+namespace hm {
+
+enum class Interpolation : int {
+	Step,    // holds the value of the previous key
+	Linear,  // lerp between the surrounding keys
+	Hermite  // cubic Hermite spline through the keys, with per-key in and out tangents
+};
+
+/**
+ * Keyframed curve of Vector<N> values over time.
+ *
+ * Keys are stored as structure-of-arrays: one array of times, and one array per component of the values (and of the
+ * tangents, for Hermite tracks), so that searching the times touches nothing else.  Sampling before the first key or
+ * after the last one clamps to the first or last value.
+ *
+ * Looking up the segment that contains a time is a binary search, unless a hint from the previous sample is given: a
+ * hint for the same or the previous segment is resolved in constant time, which makes sequential playback O(1) per
+ * sample.  AnimationSampler keeps such a hint, and the batch sampleTracks takes one per track.
+ */
+template<int N>
+class AnimationTrack {
+public:
+	AnimationTrack();
+
+	/**
+	 * Replaces the keys with step or linear keys, or Hermite keys with automatic tangents.
+	 *
+	 * @param times         Key times, strictly increasing.
+	 * @param values        Key values.
+	 * @param count         Number of keys.
+	 * @param interpolation Interpolation between keys.  Hermite tangents are finite differences of the neighboring keys.
+	 */
+	void setKeys( const float* times, const Vector<N>* values, int count, Interpolation interpolation=Interpolation::Linear );
+
+	/**
+	 * Replaces the keys with Hermite keys.
+	 *
+	 * @param times       Key times, strictly increasing.
+	 * @param values      Key values.
+	 * @param inTangents  Derivatives with respect to time arriving at each key.
+	 * @param outTangents Derivatives with respect to time leaving each key.
+	 * @param count       Number of keys.
+	 */
+	void setKeys( const float* times, const Vector<N>* values, const Vector<N>* inTangents, const Vector<N>* outTangents, int count );
+
+	int size() const;
+	Interpolation interpolation() const;
+	float startTime() const;
+	float endTime() const;
+	float keyTime( int key ) const;
+	Vector<N> keyValue( int key ) const;
+
+	/**
+	 * Finds the segment [keyTime(s), keyTime(s+1)) containing a time, clamped to the first and last segments.
+	 *
+	 * @param time Time to search for.
+	 * @param hint Segment returned by a previous search, or -1.  The search is O(1) if the result is hint or hint+1.
+	 */
+	int findSegment( float time, int hint=-1 ) const;
+
+	/**
+	 * Samples the track.  Returns the zero vector if the track has no keys.
+	 */
+	Vector<N> sample( float time ) const;
+
+	/**
+	 * Samples the track, using and updating a segment hint.  See findSegment.
+	 */
+	Vector<N> sample( float time, int& segmentHint ) const;
+
+	// raw key arrays, for custom evaluation; component c of key k is at [k] of the component's array
+	const float* times() const;
+	const float* values( int component ) const;
+	const float* inTangents( int component ) const;
+	const float* outTangents( int component ) const;
+
+private:
+	void resize( int count, Interpolation interpolation );
+
+	std::vector<float> times_;
+	std::vector<float> values_;      // N arrays of size() values
+	std::vector<float> inTangents_;  // same layout as values_, Hermite only
+	std::vector<float> outTangents_;
+	Interpolation interpolation_;
+};
+
+/**
+ * Samples one track, caching the segment of the last sample.
+ */
+template<int N>
+class AnimationSampler {
+public:
+	AnimationSampler();
+	explicit AnimationSampler( const AnimationTrack<N>* track );
+
+	/**
+	 * Changes the sampled track and drops the cached segment.  The track must outlive the sampler.
+	 */
+	void setTrack( const AnimationTrack<N>* track );
+	const AnimationTrack<N>* track() const;
+
+	Vector<N> sample( float time );
+
+private:
+	const AnimationTrack<N>* track_;
+	int segment_;
+};
+
+/**
+ * Samples many tracks at one time.  Segments are found per track; the interpolation runs on SIMD lanes, one track per
+ * lane, with step, linear and Hermite tracks mixed freely.
+ *
+ * @param tracks       Tracks to sample.
+ * @param count        Number of tracks.
+ * @param time         Time to sample at.
+ * @param results      Receives count samples.
+ * @param segmentHints If not null, one segment hint per track, used and updated as in AnimationTrack::sample.
+ *                     Initialize them to -1.
+ */
+template<int N>
+inline void sampleTracks( const AnimationTrack<N>* tracks, int count, float time, Vector<N>* results, int* segmentHints=nullptr );
+
+#include "AnimationTrack.inl"
+
+}
+
+#endif
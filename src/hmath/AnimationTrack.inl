@@ -0,0 +1,299 @@
+namespace detail {
+
+// weights of p0, m0 * dt, p1 and m1 * dt for the segment parameter u
+inline void interpolationWeights( Interpolation interpolation, float u, float* w ) {
+	switch( interpolation ) {
+		case Interpolation::Step: {
+			w[2] = (u >= 1.0f) ? 1.0f : 0.0f;
+			w[0] = 1.0f - w[2];
+			w[1] = w[3] = 0.0f;
+			break;
+		}
+		// unknown values interpolate linearly rather than leaving the weights unset
+		case Interpolation::Linear:
+		default: {
+			w[0] = 1.0f - u;
+			w[2] = u;
+			w[1] = w[3] = 0.0f;
+			break;
+		}
+		case Interpolation::Hermite: {
+			const float u2 = u * u;
+			const float u3 = u2 * u;
+			w[2] = 3.0f * u2 - 2.0f * u3;
+			w[0] = 1.0f - w[2];
+			w[1] = u3 - 2.0f * u2 + u;
+			w[3] = u3 - u2;
+			break;
+		}
+	}
+}
+
+// parameter of a time within the segment, clamped to [0, 1]
+inline float segmentParameter( float time, float t0, float t1 ) {
+	return (t1 > t0) ? clamp01((time - t0) / (t1 - t0)) : ((time >= t1) ? 1.0f : 0.0f);
+}
+
+template<int N>
+inline void sampleTracksBlock( const AnimationTrack<N>* tracks, int count, float time, Vector<N>* results, int* segmentHints ) {
+	using simd::Float;
+	const int W = SimdWidth;
+	const int n = std::min(count, W);
+
+	// gather the segment of each track into lanes, with the tangents already scaled by the segment duration
+	float u[W], step[W], hermite[W];
+	float p0[N * W], p1[N * W], m0[N * W], m1[N * W];
+	for( int lane = 0; lane < W; ++lane ) {
+		const int size = (lane < n) ? tracks[lane].size() : 0;
+		if( size == 0 ) {
+			u[lane] = step[lane] = hermite[lane] = 0.0f;
+			for( int c = 0; c < N; ++c ) {
+				p0[c*W + lane] = p1[c*W + lane] = m0[c*W + lane] = m1[c*W + lane] = 0.0f;
+			}
+			continue;
+		}
+
+		const AnimationTrack<N>& track = tracks[lane];
+		const int s = track.findSegment(time, segmentHints ? segmentHints[lane] : -1);
+		if( segmentHints ) {
+			segmentHints[lane] = s;
+		}
+		const int next = std::min(s + 1, size - 1);
+		const float t0 = track.times()[s];
+		const float t1 = track.times()[next];
+		u[lane] = segmentParameter(time, t0, t1);
+		step[lane] = (track.interpolation() == Interpolation::Step) ? 1.0f : 0.0f;
+		const bool isHermite = (track.interpolation() == Interpolation::Hermite);
+		hermite[lane] = isHermite ? 1.0f : 0.0f;
+		const float dt = t1 - t0;
+		for( int c = 0; c < N; ++c ) {
+			const float* values = track.values(c);
+			p0[c*W + lane] = values[s];
+			p1[c*W + lane] = values[next];
+			m0[c*W + lane] = isHermite ? track.outTangents(c)[s] * dt : 0.0f;
+			m1[c*W + lane] = isHermite ? track.inTangents(c)[next] * dt : 0.0f;
+		}
+	}
+
+	const Float U = Float::load(u);
+	const Float U2 = U * U;
+	const Float U3 = U2 * U;
+	const Float one(1.0f);
+	const simd::Mask isStep = Float::load(step) != Float(0.0f);
+	const simd::Mask isHermite = Float::load(hermite) != Float(0.0f);
+	// linear weights, replaced by the Hermite basis or the step for those lanes; the tangents are zero for the others
+	Float w2 = simd::select(isHermite, Float(3.0f) * U2 - Float(2.0f) * U3, U);
+	w2 = simd::select(isStep, simd::select(U >= one, one, Float(0.0f)), w2);
+	const Float w0 = one - w2;
+	const Float w1 = U3 - Float(2.0f) * U2 + U;
+	const Float w3 = U3 - U2;
+
+	float r[N * W];
+	for( int c = 0; c < N; ++c ) {
+		const Float value = w0 * Float::load(p0 + c*W) + w2 * Float::load(p1 + c*W) + w1 * Float::load(m0 + c*W) + w3 * Float::load(m1 + c*W);
+		value.store(r + c*W);
+	}
+	simd::storeTransposed(r, N, n, &results[0][0]);
+}
+
+}
+
+template<int N>
+AnimationTrack<N>::AnimationTrack()
+	: interpolation_(Interpolation::Linear) {
+}
+
+template<int N>
+void AnimationTrack<N>::resize( int count, Interpolation interpolation ) {
+	count = std::max(count, 0);
+	interpolation_ = interpolation;
+	times_.resize(count);
+	values_.resize(N * count);
+	const int numTangents = (interpolation == Interpolation::Hermite) ? N * count : 0;
+	inTangents_.resize(numTangents);
+	outTangents_.resize(numTangents);
+}
+
+template<int N>
+void AnimationTrack<N>::setKeys( const float* times, const Vector<N>* values, int count, Interpolation interpolation ) {
+	resize(count, interpolation);
+	count = size();
+	for( int k = 0; k < count; ++k ) {
+		assert(k == 0 || times[k] > times[k - 1]);
+		times_[k] = times[k];
+		for( int c = 0; c < N; ++c ) {
+			values_[c * count + k] = values[k][c];
+		}
+	}
+
+	if( interpolation == Interpolation::Hermite ) {
+		// finite differences over the neighboring keys, one-sided at the ends
+		for( int k = 0; k < count; ++k ) {
+			const int prev = std::max(k - 1, 0);
+			const int next = std::min(k + 1, count - 1);
+			const float dt = times_[next] - times_[prev];
+			for( int c = 0; c < N; ++c ) {
+				const float tangent = (dt > 0.0f) ? (values_[c * count + next] - values_[c * count + prev]) / dt : 0.0f;
+				inTangents_[c * count + k] = tangent;
+				outTangents_[c * count + k] = tangent;
+			}
+		}
+	}
+}
+
+template<int N>
+void AnimationTrack<N>::setKeys( const float* times, const Vector<N>* values, const Vector<N>* inTangents, const Vector<N>* outTangents, int count ) {
+	resize(count, Interpolation::Hermite);
+	count = size();
+	for( int k = 0; k < count; ++k ) {
+		assert(k == 0 || times[k] > times[k - 1]);
+		times_[k] = times[k];
+		for( int c = 0; c < N; ++c ) {
+			values_[c * count + k] = values[k][c];
+			inTangents_[c * count + k] = inTangents[k][c];
+			outTangents_[c * count + k] = outTangents[k][c];
+		}
+	}
+}
+
+template<int N>
+int AnimationTrack<N>::size() const {
+	return static_cast<int>(times_.size());
+}
+
+template<int N>
+Interpolation AnimationTrack<N>::interpolation() const {
+	return interpolation_;
+}
+
+template<int N>
+float AnimationTrack<N>::startTime() const {
+	return times_.empty() ? 0.0f : times_.front();
+}
+
+template<int N>
+float AnimationTrack<N>::endTime() const {
+	return times_.empty() ? 0.0f : times_.back();
+}
+
+template<int N>
+float AnimationTrack<N>::keyTime( int key ) const {
+	return times_[key];
+}
+
+template<int N>
+Vector<N> AnimationTrack<N>::keyValue( int key ) const {
+	Vector<N> result;
+	for( int c = 0; c < N; ++c ) {
+		result[c] = values_[c * size() + key];
+	}
+	return result;
+}
+
+template<int N>
+int AnimationTrack<N>::findSegment( float time, int hint ) const {
+	const int last = size() - 2;
+	if( last <= 0 ) {
+		return 0;
+	}
+
+	if( hint >= 0 && hint <= last ) {
+		if( time >= times_[hint] ) {
+			if( hint == last || time < times_[hint + 1] ) {
+				return hint;
+			}
+			// playback moved on to the next segment
+			if( hint + 1 == last || time < times_[hint + 2] ) {
+				return hint + 1;
+			}
+		} else if( hint == 0 ) {
+			return 0;
+		}
+	}
+
+	const int segment = static_cast<int>(std::upper_bound(times_.begin(), times_.end(), time) - times_.begin()) - 1;
+	return std::max(0, std::min(segment, last));
+}
+
+template<int N>
+Vector<N> AnimationTrack<N>::sample( float time ) const {
+	int segmentHint = -1;
+	return sample(time, segmentHint);
+}
+
+template<int N>
+Vector<N> AnimationTrack<N>::sample( float time, int& segmentHint ) const {
+	Vector<N> result(std::array<float, N>{});
+	const int count = size();
+	if( count == 0 ) {
+		return result;
+	}
+
+	const int s = findSegment(time, segmentHint);
+	segmentHint = s;
+	const int next = std::min(s + 1, count - 1);
+	const float dt = times_[next] - times_[s];
+	float w[4];
+	detail::interpolationWeights(interpolation_, detail::segmentParameter(time, times_[s], times_[next]), w);
+	for( int c = 0; c < N; ++c ) {
+		result[c] = w[0] * values_[c * count + s] + w[2] * values_[c * count + next];
+		if( interpolation_ == Interpolation::Hermite ) {
+			result[c] += (w[1] * outTangents_[c * count + s] + w[3] * inTangents_[c * count + next]) * dt;
+		}
+	}
+	return result;
+}
+
+template<int N>
+const float* AnimationTrack<N>::times() const {
+	return times_.data();
+}
+
+template<int N>
+const float* AnimationTrack<N>::values( int component ) const {
+	return values_.data() + component * size();
+}
+
+template<int N>
+const float* AnimationTrack<N>::inTangents( int component ) const {
+	return inTangents_.empty() ? nullptr : inTangents_.data() + component * size();
+}
+
+template<int N>
+const float* AnimationTrack<N>::outTangents( int component ) const {
+	return outTangents_.empty() ? nullptr : outTangents_.data() + component * size();
+}
+
+template<int N>
+AnimationSampler<N>::AnimationSampler()
+	: track_(nullptr), segment_(-1) {
+}
+
+template<int N>
+AnimationSampler<N>::AnimationSampler( const AnimationTrack<N>* track )
+	: track_(track), segment_(-1) {
+}
+
+template<int N>
+void AnimationSampler<N>::setTrack( const AnimationTrack<N>* track ) {
+	track_ = track;
+	segment_ = -1;
+}
+
+template<int N>
+const AnimationTrack<N>* AnimationSampler<N>::track() const {
+	return track_;
+}
+
+template<int N>
+Vector<N> AnimationSampler<N>::sample( float time ) {
+	return track_ ? track_->sample(time, segment_) : Vector<N>(std::array<float, N>{});
+}
+
+template<int N>
+void sampleTracks( const AnimationTrack<N>* tracks, int count, float time, Vector<N>* results, int* segmentHints ) {
+	HMATH_TRACE_BATCH(SampleTracksBatch, N, count);
+	for( int i = 0; i < count; i += SimdWidth ) {
+		detail::sampleTracksBlock(tracks + i, count - i, time, results + i, segmentHints ? segmentHints + i : nullptr);
+	}
+}
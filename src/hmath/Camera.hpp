@@ -0,0 +1,148 @@
+#ifndef __hmath_Camera__
+#define __hmath_Camera__
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "Matrix4x4.hpp"
+#include "Simd.hpp"
+#include "Tracing.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+
+namespace hm {
+
+/**
+ * A view built with makeLookAt and a projection built with makePerspective or makeOrthographic, with every derived
+ * matrix cached.
+ *
+ * The matrices follow the library's conventions: a world point p goes to clip space as (p, 1) * viewProjection(), and
+ * viewProjection() is projection() * view() (Matrix products compose right to left).  Each matrix is computed on
+ * first use after a change, and a change only invalidates what depends on it: moving the camera keeps the projection
+ * and its inverse, and resizing the viewport keeps the view and its inverse.  The view is rigid, so its inverse is
+ * built directly rather than by a general inversion, and the inverse view-projection is the product of the two
+ * inverses.
+ *
+ * The caches make the const accessors non-reentrant: a Camera must not be read from several threads while any cache is
+ * stale.  Calling viewProjection() and inverseViewProjection() once after changing it makes it safe to share.
+ */
+class Camera {
+public:
+	/**
+	 * Camera at the origin looking down -z, with a 60 degree perspective projection, square aspect and near and far
+	 * planes at 0.1 and 1000.
+	 */
+	Camera();
+
+	/**
+	 * Places the camera.  See makeLookAt.
+	 *
+	 * @param eye    Eye position.
+	 * @param target Look at target.
+	 * @param up     Local up vector.
+	 */
+	void setLookAt( const Vector3& eye, const Vector3& target, const Vector3& up );
+
+	/**
+	 * Uses a perspective projection.  See makePerspective.
+	 *
+	 * @param fovY   Vertical field of view in radians.
+	 * @param aspect Aspect ratio (width over height).
+	 * @param near   Near plane distance.
+	 * @param far    Far plane distance.
+	 */
+	void setPerspective( float fovY, float aspect, float near, float far );
+
+	/**
+	 * Uses an orthographic projection.  See makeOrthographic.
+	 *
+	 * @param left   Left coordinate of the viewport.
+	 * @param right  Right coordinate of the viewport.
+	 * @param bottom Bottom coordinate of the viewport.
+	 * @param top    Top coordinate of the viewport.
+	 * @param near   Near plane distance.
+	 * @param far    Far plane distance.
+	 */
+	void setOrthographic( float left, float right, float bottom, float top, float near, float far );
+
+	/**
+	 * Changes the aspect ratio of a perspective projection, keeping its other parameters.  Has no effect on an
+	 * orthographic projection.
+	 */
+	void setAspect( float aspect );
+
+	Vector3 const& eye() const;
+	Vector3 const& target() const;
+	Vector3 const& up() const;
+	bool isPerspective() const;
+	float fovY() const;
+	float aspect() const;
+	float nearPlane() const;
+	float farPlane() const;
+
+	Matrix4x4 const& view() const;
+	Matrix4x4 const& projection() const;
+	Matrix4x4 const& viewProjection() const;
+	Matrix4x4 const& inverseView() const;
+	Matrix4x4 const& inverseProjection() const;
+	Matrix4x4 const& inverseViewProjection() const;
+
+	/**
+	 * Builds the world-space ray through a point of the viewport.
+	 *
+	 * @param pixel     Viewport coordinates, from (0, 0) at the top left to (width, height) at the bottom right.
+	 * @param width     Viewport width.
+	 * @param height    Viewport height.
+	 * @param origin    Receives the ray origin, on the near plane.
+	 * @param direction Receives the unit ray direction, towards the far plane.
+	 */
+	void screenRay( const Vector2& pixel, float width, float height, Vector3& origin, Vector3& direction ) const;
+
+	/**
+	 * Builds the world-space rays through many points of the viewport, SimdWidth at a time.  See screenRay.
+	 *
+	 * @param pixels     Viewport coordinates.
+	 * @param count      Number of points.
+	 * @param width      Viewport width.
+	 * @param height     Viewport height.
+	 * @param origins    Receives count ray origins.
+	 * @param directions Receives count unit ray directions.
+	 */
+	void screenRays( const Vector2* pixels, int count, float width, float height, Vector3* origins, Vector3* directions ) const;
+
+private:
+	enum Cache {
+		ViewCache = 1 << 0,
+		ProjectionCache = 1 << 1,
+		ViewProjectionCache = 1 << 2,
+		InverseViewCache = 1 << 3,
+		InverseProjectionCache = 1 << 4,
+		InverseViewProjectionCache = 1 << 5
+	};
+
+	void invalidate( unsigned caches );
+
+	Vector3 eye_;
+	Vector3 target_;
+	Vector3 up_;
+	bool perspective_;
+	float fovY_;
+	float aspect_;
+	float left_, right_, bottom_, top_;
+	float near_;
+	float far_;
+
+	mutable unsigned valid_;
+	mutable Matrix4x4 view_;
+	mutable Matrix4x4 projection_;
+	mutable Matrix4x4 viewProjection_;
+	mutable Matrix4x4 inverseView_;
+	mutable Matrix4x4 inverseProjection_;
+	mutable Matrix4x4 inverseViewProjection_;
+};
+
+#include "Camera.inl"
+
+}
+
+#endif
@@ -0,0 +1,190 @@
+inline Camera::Camera()
+	: eye_(std::array<float, 3>{0.0f, 0.0f, 0.0f}), target_(std::array<float, 3>{0.0f, 0.0f, -1.0f}), up_(std::array<float, 3>{0.0f, 1.0f, 0.0f}),
+	  perspective_(true), fovY_(1.04719755f), aspect_(1.0f), left_(-1.0f), right_(1.0f), bottom_(-1.0f), top_(1.0f), near_(0.1f), far_(1000.0f),
+	  valid_(0) {
+}
+
+inline void Camera::setLookAt( const Vector3& eye, const Vector3& target, const Vector3& up ) {
+	eye_ = eye;
+	target_ = target;
+	up_ = up;
+	invalidate(ViewCache | ViewProjectionCache | InverseViewCache | InverseViewProjectionCache);
+}
+
+inline void Camera::setPerspective( float fovY, float aspect, float near, float far ) {
+	perspective_ = true;
+	fovY_ = fovY;
+	aspect_ = aspect;
+	near_ = near;
+	far_ = far;
+	invalidate(ProjectionCache | ViewProjectionCache | InverseProjectionCache | InverseViewProjectionCache);
+}
+
+inline void Camera::setOrthographic( float left, float right, float bottom, float top, float near, float far ) {
+	perspective_ = false;
+	left_ = left;
+	right_ = right;
+	bottom_ = bottom;
+	top_ = top;
+	near_ = near;
+	far_ = far;
+	invalidate(ProjectionCache | ViewProjectionCache | InverseProjectionCache | InverseViewProjectionCache);
+}
+
+inline void Camera::setAspect( float aspect ) {
+	if( perspective_ ) {
+		setPerspective(fovY_, aspect, near_, far_);
+	}
+}
+
+inline Vector3 const& Camera::eye() const {
+	return eye_;
+}
+
+inline Vector3 const& Camera::target() const {
+	return target_;
+}
+
+inline Vector3 const& Camera::up() const {
+	return up_;
+}
+
+inline bool Camera::isPerspective() const {
+	return perspective_;
+}
+
+inline float Camera::fovY() const {
+	return fovY_;
+}
+
+inline float Camera::aspect() const {
+	return aspect_;
+}
+
+inline float Camera::nearPlane() const {
+	return near_;
+}
+
+inline float Camera::farPlane() const {
+	return far_;
+}
+
+inline Matrix4x4 const& Camera::view() const {
+	if( !(valid_ & ViewCache) ) {
+		view_ = makeLookAt(eye_, target_, up_);
+		valid_ |= ViewCache;
+	}
+	return view_;
+}
+
+inline Matrix4x4 const& Camera::projection() const {
+	if( !(valid_ & ProjectionCache) ) {
+		projection_ = perspective_ ? makePerspective(fovY_, aspect_, near_, far_) : makeOrthographic(left_, right_, bottom_, top_, near_, far_);
+		valid_ |= ProjectionCache;
+	}
+	return projection_;
+}
+
+inline Matrix4x4 const& Camera::viewProjection() const {
+	if( !(valid_ & ViewProjectionCache) ) {
+		viewProjection_ = projection() * view();
+		valid_ |= ViewProjectionCache;
+	}
+	return viewProjection_;
+}
+
+inline Matrix4x4 const& Camera::inverseView() const {
+	if( !(valid_ & InverseViewCache) ) {
+		// the rotation block is orthonormal, so it inverts by transposition, and the translation inverts to the eye
+		const Matrix4x4& V = view();
+		for( int r = 0; r < 3; ++r ) {
+			for( int c = 0; c < 3; ++c ) {
+				inverseView_(r, c) = V(c, r);
+			}
+			inverseView_(r, 3) = 0.0f;
+			inverseView_(3, r) = eye_[r];
+		}
+		inverseView_(3, 3) = 1.0f;
+		valid_ |= InverseViewCache;
+	}
+	return inverseView_;
+}
+
+inline Matrix4x4 const& Camera::inverseProjection() const {
+	if( !(valid_ & InverseProjectionCache) ) {
+		inverseProjection_ = inverse(projection());
+		valid_ |= InverseProjectionCache;
+	}
+	return inverseProjection_;
+}
+
+inline Matrix4x4 const& Camera::inverseViewProjection() const {
+	if( !(valid_ & InverseViewProjectionCache) ) {
+		// the inverse of projection() * view() is inverseView() * inverseProjection()
+		inverseViewProjection_ = inverseView() * inverseProjection();
+		valid_ |= InverseViewProjectionCache;
+	}
+	return inverseViewProjection_;
+}
+
+inline void Camera::invalidate( unsigned caches ) {
+	valid_ &= ~caches;
+}
+
+namespace detail {
+
+// unprojects normalized device coordinates on the near (z = -1) and far (z = 1) planes into a world-space ray
+template<typename T>
+inline void unprojectRay( const Matrix4x4& inv, const T& x, const T& y, T (&origin)[3], T (&direction)[3] ) {
+	T base[4], depth[4];
+	for( int c = 0; c < 4; ++c ) {
+		base[c] = x * T(inv(0, c)) + y * T(inv(1, c)) + T(inv(3, c));
+		depth[c] = T(inv(2, c));
+	}
+	const T invNearW = T(1.0f) / (base[3] - depth[3]);
+	const T invFarW = T(1.0f) / (base[3] + depth[3]);
+	T sqrLength = T(0.0f);
+	for( int c = 0; c < 3; ++c ) {
+		origin[c] = (base[c] - depth[c]) * invNearW;
+		direction[c] = (base[c] + depth[c]) * invFarW - origin[c];
+		sqrLength += direction[c] * direction[c];
+	}
+	using std::sqrt;
+	const T invLength = T(1.0f) / sqrt(sqrLength);
+	for( int c = 0; c < 3; ++c ) {
+		direction[c] *= invLength;
+	}
+}
+
+}
+
+inline void Camera::screenRay( const Vector2& pixel, float width, float height, Vector3& origin, Vector3& direction ) const {
+	float o[3], d[3];
+	detail::unprojectRay(inverseViewProjection(), pixel[0] * (2.0f / width) - 1.0f, pixel[1] * (-2.0f / height) + 1.0f, o, d);
+	origin = Vector3(std::array<float, 3>{o[0], o[1], o[2]});
+	direction = Vector3(std::array<float, 3>{d[0], d[1], d[2]});
+}
+
+inline void Camera::screenRays( const Vector2* pixels, int count, float width, float height, Vector3* origins, Vector3* directions ) const {
+	HMATH_TRACE_BATCH(ScreenRaysBatch, 0, count);
+	using simd::Float;
+	const int W = SimdWidth;
+	const Matrix4x4& inv = inverseViewProjection();
+	const Float scaleX(2.0f / width), scaleY(-2.0f / height);
+	for( int i = 0; i < count; i += W ) {
+		const int n = std::min(count - i, W);
+		float soa[2 * W];
+		simd::loadTransposed(&pixels[i][0], 2, n, soa);
+		Float o[3], d[3];
+		detail::unprojectRay(inv, Float::load(soa) * scaleX - Float(1.0f), Float::load(soa + W) * scaleY + Float(1.0f), o, d);
+		float out[3 * W];
+		for( int c = 0; c < 3; ++c ) {
+			o[c].store(out + c*W);
+		}
+		simd::storeTransposed(out, 3, n, &origins[i][0]);
+		for( int c = 0; c < 3; ++c ) {
+			d[c].store(out + c*W);
+		}
+		simd::storeTransposed(out, 3, n, &directions[i][0]);
+	}
+}
@@ -0,0 +1,189 @@
+#ifndef __hmath_Cholesky__
+#define __hmath_Cholesky__
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "Matrix.hpp"
+#include "Simd.hpp"
+#include "Tracing.hpp"
+#include "Unroll.hpp"
+#include "Vector.hpp"
+
+namespace hm {
+
+/**
+ * LDL^T (square-root-free Cholesky) factorization of a symmetric positive-definite Matrix<N, N>, M = L D L^T with L
+ * unit lower triangular and D diagonal.
+ *
+ * Symmetric positive-definite systems (normal equations, mass and stiffness matrices) need no pivoting, and the
+ * factorization only computes one triangle, so it takes about N^3/6 multiply-adds against N^3/3 for LU.  Only the
+ * lower triangle of the input is read.  A matrix whose factorization meets a pivot that is not clearly positive is
+ * reported as not positive definite; solving with it then yields zero, as inverse does for singular matrices.
+ *
+ * CholeskyDecomposition<0> is the same for matrices whose size is only known at runtime.
+ */
+template<int N>
+class CholeskyDecomposition {
+public:
+	CholeskyDecomposition();
+	explicit CholeskyDecomposition( const Matrix<N, N>& M );
+
+	/**
+	 * Factors a Matrix, replacing any previous factorization.
+	 *
+	 * @param M Symmetric Matrix; only its lower triangle is read.
+	 * @return Whether or not M is positive definite.
+	 */
+	bool factor( const Matrix<N, N>& M );
+
+	bool isPositiveDefinite() const;
+
+	/**
+	 * Solves M x = b.
+	 *
+	 * @param b Right-hand side.
+	 * @return x, or zero if M is not positive definite.
+	 */
+	Vector<N> solve( const Vector<N>& b ) const;
+
+	// inverse of M, or zero if M is not positive definite
+	Matrix<N, N> inverse() const;
+	// product of the diagonal of D
+	float determinant() const;
+
+	// the unit lower triangular L
+	Matrix<N, N> unitLower() const;
+	// the diagonal of D
+	Vector<N> diagonal() const;
+	// the lower triangular Cholesky factor G = L D^(1/2), with M = G G^T
+	Matrix<N, N> lower() const;
+	// L below the diagonal and D on it, zero above it
+	Matrix<N, N> const& packed() const;
+
+	/**
+	 * Updates the factorization to that of M + v v^T in O(N^2) rather than refactoring in O(N^3).
+	 *
+	 * @param v Update vector.
+	 * @return False, leaving the factorization unchanged, if M is not positive definite.
+	 */
+	bool update( const Vector<N>& v );
+
+	/**
+	 * Updates the factorization to that of M - v v^T in O(N^2).
+	 *
+	 * @param v Downdate vector.
+	 * @return False, leaving the factorization unchanged, if M - v v^T would not be positive definite.
+	 */
+	bool downdate( const Vector<N>& v );
+
+private:
+	template<int Size>
+	friend void factorCholesky( const Matrix<Size, Size>* M, CholeskyDecomposition<Size>* result, int count );
+
+	Matrix<N, N> factor_;
+	bool positiveDefinite_;
+};
+
+/**
+ * LDL^T factorization of a symmetric positive-definite matrix whose size is only known at runtime.  Matrices are
+ * row-major arrays of size*size floats, as for GaussianElimination.  See CholeskyDecomposition<N>.
+ */
+template<>
+class CholeskyDecomposition<0> {
+public:
+	CholeskyDecomposition();
+	CholeskyDecomposition( int size, const float* M );
+
+	/**
+	 * Factors a matrix, replacing any previous factorization.
+	 *
+	 * @param size Number of rows and columns.
+	 * @param M    Symmetric row-major matrix; only its lower triangle is read.
+	 * @return Whether or not M is positive definite.
+	 */
+	bool factor( int size, const float* M );
+
+	int size() const;
+	bool isPositiveDefinite() const;
+
+	/**
+	 * Solves M x = b.
+	 *
+	 * @param b Right-hand side of size() floats.
+	 * @param x Receives size() floats, zero if M is not positive definite.  May be the same array as b.
+	 * @return Whether or not M is positive definite.
+	 */
+	bool solve( const float* b, float* x ) const;
+
+	/**
+	 * Computes the inverse of M.
+	 *
+	 * @param inverseM Receives size()*size() floats, zero if M is not positive definite.
+	 * @return Whether or not M is positive definite.
+	 */
+	bool inverse( float* inverseM ) const;
+
+	// product of the diagonal of D
+	float determinant() const;
+	// L below the diagonal and D on it, zero above it, as size()*size() row-major floats
+	const float* packed() const;
+
+	/**
+	 * Updates the factorization to that of M + v v^T in O(size^2).
+	 *
+	 * @param v Update vector of size() floats.
+	 * @return False, leaving the factorization unchanged, if M is not positive definite.
+	 */
+	bool update( const float* v );
+
+	/**
+	 * Updates the factorization to that of M - v v^T in O(size^2).
+	 *
+	 * @param v Downdate vector of size() floats.
+	 * @return False, leaving the factorization unchanged, if M - v v^T would not be positive definite.
+	 */
+	bool downdate( const float* v );
+
+private:
+	int size_;
+	bool positiveDefinite_;
+	std::vector<float> factor_;
+	std::vector<float> scratch_;
+};
+
+/**
+ * Factors an array of Matrices.  See CholeskyDecomposition.
+ *
+ * Up to 8x8, Matrices are processed in blocks of SimdWidth, transposed into per-element lanes so that one
+ * factorization runs on all Matrices of a block at once.  Larger ones are factored one at a time, as their lanes no
+ * longer fit in registers.
+ *
+ * @param M      Symmetric input Matrices; only their lower triangles are read.
+ * @param result Output factorizations.
+ * @param count  Number of Matrices.
+ */
+template<int N>
+inline void factorCholesky( const Matrix<N, N>* M, CholeskyDecomposition<N>* result, int count );
+
+/**
+ * Solves the systems M[i] x[i] = b[i] of an array of symmetric positive-definite Matrices, factoring and solving in
+ * SIMD lanes as factorCholesky does.
+ *
+ * @param M                  Symmetric input Matrices; only their lower triangles are read.
+ * @param b                  Right-hand sides.
+ * @param x                  Receives the solutions, zero where M[i] is not positive definite.  May be the same
+ *                           array as b.
+ * @param isPositiveDefinite If not null, returns whether or not each Matrix is positive definite.
+ * @param count              Number of systems.
+ */
+template<int N>
+inline void solveCholesky( const Matrix<N, N>* M, const Vector<N>* b, Vector<N>* x, bool* isPositiveDefinite, int count );
+
+#include "Cholesky.inl"
+
+}
+
+#endif
@@ -0,0 +1,486 @@
+namespace detail {
+
+inline bool choleskyAnd( bool a, bool b ) {
+	return a && b;
+}
+
+inline simd::Mask choleskyAnd( const simd::Mask& a, const simd::Mask& b ) {
+	return a & b;
+}
+
+inline float choleskySelect( bool mask, float a, float b ) {
+	return mask ? a : b;
+}
+
+inline simd::Float choleskySelect( const simd::Mask& mask, const simd::Float& a, const simd::Float& b ) {
+	return simd::select(mask, a, b);
+}
+
+inline float choleskyMax( float a, float b ) {
+	return std::max(a, b);
+}
+
+inline simd::Float choleskyMax( const simd::Float& a, const simd::Float& b ) {
+	return simd::maximum(a, b);
+}
+
+// pivots must exceed this fraction of the largest diagonal entry; smaller ones are rounding noise of a singular matrix
+inline float choleskyTolerance( int size ) {
+	return static_cast<float>(size) * std::numeric_limits<float>::epsilon();
+}
+
+/**
+ * Factors the symmetric matrix whose lower triangle is in the row-major array a into LDL^T in place, leaving L below
+ * the diagonal and D on it; the upper triangle is not touched.  Returns whether each lane is positive definite.
+ * Pivots of lanes that are not are replaced by 1 so that all lanes stay finite.
+ */
+template<int N, typename T>
+inline auto factorLDLT( T* a ) -> decltype(a[0] > a[0]) {
+	T largest = a[0];
+	unroll<N>([&]( auto i ) {
+		largest = choleskyMax(largest, a[i * N + i]);
+	});
+	const T tolerance = largest * T(choleskyTolerance(N));
+
+	auto positive = (T(1.0f) > T(0.0f));
+	// row i of L, scaled by D
+	T scaled[N];
+	T invD[N];
+	unroll<N>([&]( auto i ) {
+		T* row = a + i * N;
+		for( int j = 0; j < i; ++j ) {
+			T s = row[j];
+			for( int k = 0; k < j; ++k ) {
+				s -= scaled[k] * a[j * N + k];
+			}
+			scaled[j] = s;
+			row[j] = s * invD[j];
+		}
+		T d = row[i];
+		for( int k = 0; k < i; ++k ) {
+			d -= scaled[k] * row[k];
+		}
+		const auto lane = (d > tolerance);
+		positive = choleskyAnd(positive, lane);
+		d = choleskySelect(lane, d, T(1.0f));
+		row[i] = d;
+		invD[i] = T(1.0f) / d;
+	});
+	return positive;
+}
+
+// solves L D L^T x = b in place, with the factors as left by factorLDLT
+template<int N, typename T>
+inline void solveLDLT( const T* f, T* x ) {
+	unroll<N>([&]( auto i ) {
+		for( int k = 0; k < i; ++k ) {
+			x[i] -= f[i * N + k] * x[k];
+		}
+	});
+	unroll<N>([&]( auto i ) {
+		x[i] = x[i] / f[i * N + i];
+	});
+	for( int i = N - 1; i > 0; --i ) {
+		for( int k = 0; k < i; ++k ) {
+			x[k] -= f[i * N + k] * x[i];
+		}
+	}
+}
+
+// Rank-one modification of packed LDL^T factors to those of M + alpha w w^T; w is overwritten.  Method C1 of Gill,
+// Golub, Murray and Saunders, "Methods for modifying matrix factorizations" (1974).
+inline void ldltRankOne( float* f, int n, float* w, float alpha ) {
+	for( int j = 0; j < n; ++j ) {
+		const float p = w[j];
+		const float d = f[j * n + j];
+		const float updated = d + alpha * p * p;
+		const float beta = p * alpha / updated;
+		alpha = d * alpha / updated;
+		f[j * n + j] = updated;
+		for( int r = j + 1; r < n; ++r ) {
+			w[r] -= p * f[r * n + j];
+			f[r * n + j] += beta * w[r];
+		}
+	}
+}
+
+// Returns whether M - v v^T stays positive definite, i.e. whether v^T M^-1 v < 1; w receives L^-1 v.
+inline bool ldltCanDowndate( const float* f, int n, const float* v, float* w ) {
+	float sum = 0.0f;
+	for( int i = 0; i < n; ++i ) {
+		float s = v[i];
+		for( int k = 0; k < i; ++k ) {
+			s -= f[i * n + k] * w[k];
+		}
+		w[i] = s;
+		sum += s * s / f[i * n + i];
+	}
+	return 1.0f - sum > choleskyTolerance(n);
+}
+
+template<int N>
+inline void factorCholeskyBlock( const Matrix<N, N>* M, Matrix<N, N>* packed, bool* positive, int count ) {
+	using simd::Float;
+	const int W = SimdWidth;
+
+	// unused lanes are zero and come out as not positive definite
+	float m[N * N * W];
+	simd::loadTransposed(&M[0][0], N * N, count, m);
+	Float a[N * N];
+	unroll<N * N>([&]( auto i ) {
+		a[i] = Float::load(m + i * W);
+	});
+
+	const simd::Mask lanes = factorLDLT<N>(a);
+	unroll<N>([&]( auto r ) {
+		unroll<N>([&]( auto c ) {
+			(c > r ? Float(0.0f) : a[r * N + c]).store(m + (r * N + c) * W);
+		});
+	});
+	simd::storeTransposed(m, N * N, count, &packed[0][0]);
+	for( int l = 0; l < count && l < W; ++l ) {
+		positive[l] = lanes[l];
+	}
+}
+
+template<int N>
+inline void solveCholeskyBlock( const Matrix<N, N>* M, const Vector<N>* b, Vector<N>* x, bool* isPositiveDefinite, int count ) {
+	using simd::Float;
+	const int W = SimdWidth;
+
+	float m[N * N * W];
+	simd::loadTransposed(&M[0][0], N * N, count, m);
+	Float a[N * N];
+	unroll<N * N>([&]( auto i ) {
+		a[i] = Float::load(m + i * W);
+	});
+	float v[N * W];
+	simd::loadTransposed(&b[0][0], N, count, v);
+	Float y[N];
+	unroll<N>([&]( auto i ) {
+		y[i] = Float::load(v + i * W);
+	});
+
+	const simd::Mask lanes = factorLDLT<N>(a);
+	solveLDLT<N>(a, y);
+	unroll<N>([&]( auto i ) {
+		simd::select(lanes, y[i], Float(0.0f)).store(v + i * W);
+	});
+	simd::storeTransposed(v, N, count, &x[0][0]);
+	if( isPositiveDefinite ) {
+		for( int l = 0; l < count && l < W; ++l ) {
+			isPositiveDefinite[l] = lanes[l];
+		}
+	}
+}
+
+template<int N>
+inline void factorCholeskyBlock( const Matrix<N, N>* M, Matrix<N, N>* packed, bool* positive, int count, std::true_type ) {
+	factorCholeskyBlock(M, packed, positive, count);
+}
+
+template<int N>
+inline void factorCholeskyBlock( const Matrix<N, N>* M, Matrix<N, N>* packed, bool* positive, int count, std::false_type ) {
+	for( int l = 0; l < count && l < SimdWidth; ++l ) {
+		const CholeskyDecomposition<N> ldlt(M[l]);
+		packed[l] = ldlt.packed();
+		positive[l] = ldlt.isPositiveDefinite();
+	}
+}
+
+template<int N>
+inline void solveCholesky( const Matrix<N, N>* M, const Vector<N>* b, Vector<N>* x, bool* isPositiveDefinite, int count, std::true_type ) {
+	for( int i = 0; i < count; i += SimdWidth ) {
+		solveCholeskyBlock(M + i, b + i, x + i, isPositiveDefinite ? isPositiveDefinite + i : nullptr, count - i);
+	}
+}
+
+template<int N>
+inline void solveCholesky( const Matrix<N, N>* M, const Vector<N>* b, Vector<N>* x, bool* isPositiveDefinite, int count, std::false_type ) {
+	for( int i = 0; i < count; ++i ) {
+		const CholeskyDecomposition<N> ldlt(M[i]);
+		x[i] = ldlt.solve(b[i]);
+		if( isPositiveDefinite ) {
+			isPositiveDefinite[i] = ldlt.isPositiveDefinite();
+		}
+	}
+}
+
+}
+
+template<int N>
+CholeskyDecomposition<N>::CholeskyDecomposition()
+	: factor_(Matrix<N, N>::zero()), positiveDefinite_(false) {
+}
+
+template<int N>
+CholeskyDecomposition<N>::CholeskyDecomposition( const Matrix<N, N>& M ) {
+	factor(M);
+}
+
+template<int N>
+bool CholeskyDecomposition<N>::factor( const Matrix<N, N>& M ) {
+	float* a = &factor_[0];
+	detail::unroll<N>([&]( auto r ) {
+		detail::unroll<N>([&]( auto c ) {
+			a[r * N + c] = (c > r) ? 0.0f : M(r, c);
+		});
+	});
+	positiveDefinite_ = detail::factorLDLT<N>(a);
+	return positiveDefinite_;
+}
+
+template<int N>
+bool CholeskyDecomposition<N>::isPositiveDefinite() const {
+	return positiveDefinite_;
+}
+
+template<int N>
+Vector<N> CholeskyDecomposition<N>::solve( const Vector<N>& b ) const {
+	Vector<N> x = b;
+	if( !positiveDefinite_ ) {
+		x.makeZero();
+		return x;
+	}
+	detail::solveLDLT<N>(&factor_[0], &x[0]);
+	return x;
+}
+
+template<int N>
+Matrix<N, N> CholeskyDecomposition<N>::inverse() const {
+	Matrix<N, N> result = Matrix<N, N>::zero();
+	if( !positiveDefinite_ ) {
+		return result;
+	}
+	// column c solves M x = e_c; M^-1 is symmetric, so it is stored as row c
+	for( int c = 0; c < N; ++c ) {
+		float* x = &result[c * N];
+		x[c] = 1.0f;
+		detail::solveLDLT<N>(&factor_[0], x);
+	}
+	return result;
+}
+
+template<int N>
+float CholeskyDecomposition<N>::determinant() const {
+	if( !positiveDefinite_ ) {
+		return 0.0f;
+	}
+	float product = 1.0f;
+	detail::unroll<N>([&]( auto i ) {
+		product *= factor_(i, i);
+	});
+	return product;
+}
+
+template<int N>
+Matrix<N, N> CholeskyDecomposition<N>::unitLower() const {
+	Matrix<N, N> L = factor_;
+	detail::unroll<N>([&]( auto i ) {
+		L(i, i) = 1.0f;
+	});
+	return L;
+}
+
+template<int N>
+Vector<N> CholeskyDecomposition<N>::diagonal() const {
+	Vector<N> d;
+	detail::unroll<N>([&]( auto i ) {
+		d[i] = factor_(i, i);
+	});
+	return d;
+}
+
+template<int N>
+Matrix<N, N> CholeskyDecomposition<N>::lower() const {
+	Matrix<N, N> G = factor_;
+	detail::unroll<N>([&]( auto c ) {
+		const float scale = std::sqrt(factor_(c, c));
+		G(c, c) = scale;
+		for( int r = c + 1; r < N; ++r ) {
+			G(r, c) *= scale;
+		}
+	});
+	return G;
+}
+
+template<int N>
+Matrix<N, N> const& CholeskyDecomposition<N>::packed() const {
+	return factor_;
+}
+
+template<int N>
+bool CholeskyDecomposition<N>::update( const Vector<N>& v ) {
+	if( !positiveDefinite_ ) {
+		return false;
+	}
+	Vector<N> w = v;
+	detail::ldltRankOne(&factor_[0], N, &w[0], 1.0f);
+	return true;
+}
+
+template<int N>
+bool CholeskyDecomposition<N>::downdate( const Vector<N>& v ) {
+	Vector<N> w;
+	if( !positiveDefinite_ || !detail::ldltCanDowndate(&factor_[0], N, &v[0], &w[0]) ) {
+		return false;
+	}
+	w = v;
+	detail::ldltRankOne(&factor_[0], N, &w[0], -1.0f);
+	return true;
+}
+
+inline CholeskyDecomposition<0>::CholeskyDecomposition()
+	: size_(0), positiveDefinite_(false) {
+}
+
+inline CholeskyDecomposition<0>::CholeskyDecomposition( int size, const float* M )
+	: size_(0), positiveDefinite_(false) {
+	factor(size, M);
+}
+
+inline bool CholeskyDecomposition<0>::factor( int size, const float* M ) {
+	HMATH_TRACE_SCOPE(Cholesky, size);
+	const int n = std::max(size, 0);
+	size_ = n;
+	factor_.assign(static_cast<size_t>(n) * n, 0.0f);
+	scratch_.resize(n);
+	float largest = 0.0f;
+	for( int r = 0; r < n; ++r ) {
+		std::copy(M + r * n, M + r * n + r + 1, &factor_[r * n]);
+		largest = std::max(largest, M[r * n + r]);
+	}
+	const float tolerance = largest * detail::choleskyTolerance(n);
+
+	// rows of L are computed in turn; the inner products run along rows, so memory is read contiguously
+	float* scaled = scratch_.data();
+	for( int i = 0; i < n; ++i ) {
+		float* row = &factor_[i * n];
+		for( int j = 0; j < i; ++j ) {
+			const float* rowJ = &factor_[j * n];
+			float s = row[j];
+			for( int k = 0; k < j; ++k ) {
+				s -= scaled[k] * rowJ[k];
+			}
+			scaled[j] = s;
+			row[j] = s / rowJ[j];
+		}
+		float d = row[i];
+		for( int k = 0; k < i; ++k ) {
+			d -= scaled[k] * row[k];
+		}
+		if( !(d > tolerance) ) {
+			positiveDefinite_ = false;
+			return false;
+		}
+		row[i] = d;
+	}
+	positiveDefinite_ = (n > 0);
+	return positiveDefinite_;
+}
+
+inline int CholeskyDecomposition<0>::size() const {
+	return size_;
+}
+
+inline bool CholeskyDecomposition<0>::isPositiveDefinite() const {
+	return positiveDefinite_;
+}
+
+inline bool CholeskyDecomposition<0>::solve( const float* b, float* x ) const {
+	const int n = size_;
+	if( !positiveDefinite_ ) {
+		std::fill(x, x + n, 0.0f);
+		return false;
+	}
+	if( x != b ) {
+		std::copy(b, b + n, x);
+	}
+	const float* f = factor_.data();
+	for( int i = 1; i < n; ++i ) {
+		float s = x[i];
+		for( int k = 0; k < i; ++k ) {
+			s -= f[i * n + k] * x[k];
+		}
+		x[i] = s;
+	}
+	for( int i = 0; i < n; ++i ) {
+		x[i] /= f[i * n + i];
+	}
+	// L^T x = y by rows of L, once each x[i] is final
+	for( int i = n - 1; i > 0; --i ) {
+		const float xi = x[i];
+		for( int k = 0; k < i; ++k ) {
+			x[k] -= f[i * n + k] * xi;
+		}
+	}
+	return true;
+}
+
+inline bool CholeskyDecomposition<0>::inverse( float* inverseM ) const {
+	const int n = size_;
+	std::fill(inverseM, inverseM + static_cast<size_t>(n) * n, 0.0f);
+	if( !positiveDefinite_ ) {
+		return false;
+	}
+	// M^-1 is symmetric, so column c is stored as row c
+	for( int c = 0; c < n; ++c ) {
+		float* x = inverseM + static_cast<size_t>(c) * n;
+		x[c] = 1.0f;
+		solve(x, x);
+	}
+	return true;
+}
+
+inline float CholeskyDecomposition<0>::determinant() const {
+	if( !positiveDefinite_ ) {
+		return 0.0f;
+	}
+	float product = 1.0f;
+	for( int i = 0; i < size_; ++i ) {
+		product *= factor_[i * size_ + i];
+	}
+	return product;
+}
+
+inline const float* CholeskyDecomposition<0>::packed() const {
+	return factor_.data();
+}
+
+inline bool CholeskyDecomposition<0>::update( const float* v ) {
+	if( !positiveDefinite_ ) {
+		return false;
+	}
+	scratch_.assign(v, v + size_);
+	detail::ldltRankOne(factor_.data(), size_, scratch_.data(), 1.0f);
+	return true;
+}
+
+inline bool CholeskyDecomposition<0>::downdate( const float* v ) {
+	if( !positiveDefinite_ || !detail::ldltCanDowndate(factor_.data(), size_, v, scratch_.data()) ) {
+		return false;
+	}
+	scratch_.assign(v, v + size_);
+	detail::ldltRankOne(factor_.data(), size_, scratch_.data(), -1.0f);
+	return true;
+}
+
+template<int N>
+void factorCholesky( const Matrix<N, N>* M, CholeskyDecomposition<N>* result, int count ) {
+	HMATH_TRACE_BATCH(CholeskyBatch, N, count);
+	Matrix<N, N> packed[SimdWidth];
+	bool positive[SimdWidth];
+	for( int i = 0; i < count; i += SimdWidth ) {
+		detail::factorCholeskyBlock(M + i, packed, positive, count - i, std::integral_constant<bool, (N <= 8)>());
+		for( int l = 0; l < SimdWidth && i + l < count; ++l ) {
+			result[i + l].factor_ = packed[l];
+			result[i + l].positiveDefinite_ = positive[l];
+		}
+	}
+}
+
+template<int N>
+void solveCholesky( const Matrix<N, N>* M, const Vector<N>* b, Vector<N>* x, bool* isPositiveDefinite, int count ) {
+	HMATH_TRACE_BATCH(CholeskyBatch, N, count);
+	detail::solveCholesky(M, b, x, isPositiveDefinite, count, std::integral_constant<bool, (N <= 8)>());
+}
@@ -0,0 +1,129 @@
+#ifndef __hmath_ClosestPoint__
+#define __hmath_ClosestPoint__
+
+#include <limits>
+#include "Functions.hpp"
+#include "MatrixBlock.hpp"
+#include "Simd.hpp"
+#include "Vector3.hpp"
+
+namespace hm {
+
+/**
+ * Closest-point queries between points, segments, triangles and oriented boxes.
+ *
+ * Each query is written without branches: every case (the regions of a triangle, the clamping of segment parameters,
+ * degenerate segments) is computed and the right one is picked with selects.  The same code therefore runs on one
+ * query or on SimdWidth queries at once in Vector3Block (SoA) form, and lanes never diverge.  Degenerate input is
+ * handled: zero-length segments act as points, and collinear triangles as their longest edge.
+ *
+ * All queries return squared distances, as KdTree does.
+ */
+
+/**
+ * Box with arbitrary orientation.
+ */
+struct OrientedBox {
+	Vector3 center;
+	// unit axes, orthogonal to each other
+	Vector3 axes[3];
+	// half of the size along each axis
+	Vector3 halfExtents;
+};
+
+/**
+ * SimdWidth OrientedBoxes in SoA form.
+ */
+struct OrientedBoxBlock {
+	Vector3Block center;
+	Vector3Block axes[3];
+	Vector3Block halfExtents;
+};
+
+/**
+ * Finds the point of a segment closest to a point.
+ *
+ * @param p       Query point.
+ * @param a       Start of the segment.
+ * @param b       End of the segment.
+ * @param closest Receives the closest point, a + t (b - a).
+ * @param t       Receives the parameter of the closest point, in [0, 1].
+ * @return Squared distance between p and closest.
+ */
+inline float closestPointOnSegment( const Vector3& p, const Vector3& a, const Vector3& b, Vector3& closest, float& t );
+
+/**
+ * Finds the point of a triangle closest to a point.
+ *
+ * @param p           Query point.
+ * @param a           First corner.
+ * @param b           Second corner.
+ * @param c           Third corner.
+ * @param closest     Receives the closest point.
+ * @param barycentric Receives the weights of a, b and c in the closest point.
+ * @return Squared distance between p and closest.
+ */
+inline float closestPointOnTriangle( const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c, Vector3& closest, Vector3& barycentric );
+
+/**
+ * Finds the closest pair of points of two segments.  If the segments are parallel, one of the closest pairs is chosen.
+ *
+ * @param p0       Start of the first segment.
+ * @param q0       End of the first segment.
+ * @param p1       Start of the second segment.
+ * @param q1       End of the second segment.
+ * @param closest0 Receives the closest point of the first segment, p0 + s (q0 - p0).
+ * @param closest1 Receives the closest point of the second segment, p1 + t (q1 - p1).
+ * @param s        Receives the parameter of closest0, in [0, 1].
+ * @param t        Receives the parameter of closest1, in [0, 1].
+ * @return Squared distance between closest0 and closest1.
+ */
+inline float closestPointsOnSegments( const Vector3& p0, const Vector3& q0, const Vector3& p1, const Vector3& q1, Vector3& closest0, Vector3& closest1, float& s, float& t );
+
+/**
+ * Finds the point of an oriented box, including its inside, closest to a point.
+ *
+ * @param p       Query point.
+ * @param box     Box.
+ * @param closest Receives the closest point, which is p if p is inside the box.
+ * @param local   Receives the coordinates of closest along the axes of the box, relative to its center.
+ * @return Squared distance between p and closest.
+ */
+inline float closestPointOnBox( const Vector3& p, const OrientedBox& box, Vector3& closest, Vector3& local );
+
+/**
+ * SoA form of closestPointOnSegment, for SimdWidth queries at once.
+ *
+ * @param t           Receives SimdWidth parameters.
+ * @param sqrDistance Receives SimdWidth squared distances.
+ */
+inline void closestPointOnSegment( const Vector3Block& p, const Vector3Block& a, const Vector3Block& b, Vector3Block& closest, float* t, float* sqrDistance );
+
+/**
+ * SoA form of closestPointOnTriangle, for SimdWidth queries at once.
+ *
+ * @param sqrDistance Receives SimdWidth squared distances.
+ */
+inline void closestPointOnTriangle( const Vector3Block& p, const Vector3Block& a, const Vector3Block& b, const Vector3Block& c, Vector3Block& closest, Vector3Block& barycentric, float* sqrDistance );
+
+/**
+ * SoA form of closestPointsOnSegments, for SimdWidth queries at once.
+ *
+ * @param s           Receives SimdWidth parameters on the first segments.
+ * @param t           Receives SimdWidth parameters on the second segments.
+ * @param sqrDistance Receives SimdWidth squared distances.
+ */
+inline void closestPointsOnSegments( const Vector3Block& p0, const Vector3Block& q0, const Vector3Block& p1, const Vector3Block& q1, Vector3Block& closest0, Vector3Block& closest1, float* s, float* t, float* sqrDistance );
+
+/**
+ * SoA form of closestPointOnBox, for SimdWidth queries at once.
+ *
+ * @param sqrDistance Receives SimdWidth squared distances.
+ */
+inline void closestPointOnBox( const Vector3Block& p, const OrientedBoxBlock& box, Vector3Block& closest, Vector3Block& local, float* sqrDistance );
+
+#include "ClosestPoint.inl"
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+namespace detail {
+
+inline float closestSelect( bool mask, float a, float b ) {
+	return mask ? a : b;
+}
+
+inline simd::Float closestSelect( const simd::Mask& mask, const simd::Float& a, const simd::Float& b ) {
+	return simd::select(mask, a, b);
+}
+
+inline bool closestAnd( bool a, bool b ) {
+	return a && b;
+}
+
+inline simd::Mask closestAnd( const simd::Mask& a, const simd::Mask& b ) {
+	return a & b;
+}
+
+template<typename T>
+inline T closestClamp01( const T& x ) {
+	return minimum(maximum(x, T(0.0f)), T(1.0f));
+}
+
+// n / d for d >= 0, giving 0 rather than a division by zero when n is 0 as well
+template<typename T>
+inline T closestDivide( const T& n, const T& d ) {
+	return n / maximum(d, T(std::numeric_limits<float>::min()));
+}
+
+template<typename T>
+inline T closestDot( const T* a, const T* b ) {
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+template<typename T>
+inline T closestSqrDistance( const T* a, const T* b ) {
+	const T d[3] = {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+	return closestDot(d, d);
+}
+
+template<typename T>
+inline T closestOnSegment( const T* p, const T* a, const T* b, T* closest, T& t ) {
+	const T ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+	const T ap[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+	t = closestClamp01(closestDivide(closestDot(ap, ab), closestDot(ab, ab)));
+	for( int i = 0; i < 3; ++i ) {
+		closest[i] = a[i] + ab[i] * t;
+	}
+	return closestSqrDistance(p, closest);
+}
+
+template<typename T>
+inline T closestOnTriangle( const T* p, const T* a, const T* b, const T* c, T* closest, T* barycentric ) {
+	// the closest point of each edge, keeping the nearest
+	T onEdge[3][3];
+	T t[3];
+	const T d0 = closestOnSegment(p, a, b, onEdge[0], t[0]);
+	const T d1 = closestOnSegment(p, b, c, onEdge[1], t[1]);
+	const T d2 = closestOnSegment(p, c, a, onEdge[2], t[2]);
+	const auto pick1 = d1 < d0;
+	T best = closestSelect(pick1, d1, d0);
+	const auto pick2 = d2 < best;
+	best = closestSelect(pick2, d2, best);
+	const T zero(0.0f), one(1.0f);
+	barycentric[0] = closestSelect(pick2, t[2], closestSelect(pick1, zero, one - t[0]));
+	barycentric[1] = closestSelect(pick2, zero, closestSelect(pick1, one - t[1], t[0]));
+	barycentric[2] = closestSelect(pick2, one - t[2], closestSelect(pick1, t[1], zero));
+	for( int i = 0; i < 3; ++i ) {
+		closest[i] = closestSelect(pick2, onEdge[2][i], closestSelect(pick1, onEdge[1][i], onEdge[0][i]));
+	}
+
+	// the projection onto the plane wins when it falls inside the triangle, which needs a triangle of nonzero area
+	const T ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+	const T ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+	const T ap[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+	const T d00 = closestDot(ab, ab);
+	const T d01 = closestDot(ab, ac);
+	const T d11 = closestDot(ac, ac);
+	const T d20 = closestDot(ap, ab);
+	const T d21 = closestDot(ap, ac);
+	const T denominator = d00 * d11 - d01 * d01;
+	const T v = closestDivide(d11 * d20 - d01 * d21, denominator);
+	const T w = closestDivide(d00 * d21 - d01 * d20, denominator);
+	const T u = one - v - w;
+	const T epsilon(std::numeric_limits<float>::epsilon());
+	const auto inside = closestAnd(closestAnd(denominator > epsilon * d00 * d11, u >= zero), closestAnd(v >= zero, w >= zero));
+	T projection[3];
+	for( int i = 0; i < 3; ++i ) {
+		projection[i] = a[i] + ab[i] * v + ac[i] * w;
+	}
+	best = closestSelect(inside, closestSqrDistance(p, projection), best);
+	barycentric[0] = closestSelect(inside, u, barycentric[0]);
+	barycentric[1] = closestSelect(inside, v, barycentric[1]);
+	barycentric[2] = closestSelect(inside, w, barycentric[2]);
+	for( int i = 0; i < 3; ++i ) {
+		closest[i] = closestSelect(inside, projection[i], closest[i]);
+	}
+	return best;
+}
+
+template<typename T>
+inline T closestOnSegments( const T* p0, const T* q0, const T* p1, const T* q1, T* closest0, T* closest1, T& s, T& t ) {
+	// Ericson, "Real-Time Collision Detection", 5.1.9, with each branch turned into a select
+	const T d0[3] = {q0[0] - p0[0], q0[1] - p0[1], q0[2] - p0[2]};
+	const T d1[3] = {q1[0] - p1[0], q1[1] - p1[1], q1[2] - p1[2]};
+	const T r[3] = {p0[0] - p1[0], p0[1] - p1[1], p0[2] - p1[2]};
+	const T a = closestDot(d0, d0);
+	const T b = closestDot(d0, d1);
+	const T c = closestDot(d0, r);
+	const T e = closestDot(d1, d1);
+	const T f = closestDot(d1, r);
+	const T zero(0.0f);
+
+	// the closest points of the infinite lines, or s = 0 if they are parallel
+	const T denominator = a * e - b * b;
+	const T epsilon(std::numeric_limits<float>::epsilon());
+	s = closestSelect(denominator > epsilon * a * e, closestClamp01(closestDivide(b * f - c * e, denominator)), zero);
+	// the point of the second segment closest to that, and s again if t had to be clamped
+	const T tNumerator = b * s + f;
+	t = closestClamp01(closestDivide(tNumerator, e));
+	s = closestSelect(tNumerator < zero, closestClamp01(closestDivide(-c, a)), s);
+	s = closestSelect(tNumerator > e, closestClamp01(closestDivide(b - c, a)), s);
+	// a second segment of zero length is a point, and only s is free
+	const auto point = e <= T(std::numeric_limits<float>::min());
+	s = closestSelect(point, closestClamp01(closestDivide(-c, a)), s);
+	t = closestSelect(point, zero, t);
+
+	for( int i = 0; i < 3; ++i ) {
+		closest0[i] = p0[i] + d0[i] * s;
+		closest1[i] = p1[i] + d1[i] * t;
+	}
+	return closestSqrDistance(closest0, closest1);
+}
+
+template<typename T>
+inline T closestOnBox( const T* p, const T* center, const T axes[3][3], const T* halfExtents, T* closest, T* local ) {
+	const T d[3] = {p[0] - center[0], p[1] - center[1], p[2] - center[2]};
+	for( int i = 0; i < 3; ++i ) {
+		local[i] = minimum(maximum(closestDot(d, axes[i]), -halfExtents[i]), halfExtents[i]);
+	}
+	for( int i = 0; i < 3; ++i ) {
+		closest[i] = center[i] + axes[0][i] * local[0] + axes[1][i] * local[1] + axes[2][i] * local[2];
+	}
+	return closestSqrDistance(p, closest);
+}
+
+inline void closestLoad( const Vector3Block& block, simd::Float* v ) {
+	for( int i = 0; i < 3; ++i ) {
+		v[i] = simd::Float::load(block.lanes(0, i));
+	}
+}
+
+inline void closestStore( const simd::Float* v, Vector3Block& block ) {
+	for( int i = 0; i < 3; ++i ) {
+		v[i].store(block.lanes(0, i));
+	}
+}
+
+}
+
+inline float closestPointOnSegment( const Vector3& p, const Vector3& a, const Vector3& b, Vector3& closest, float& t ) {
+	return detail::closestOnSegment(&p[0], &a[0], &b[0], &closest[0], t);
+}
+
+inline float closestPointOnTriangle( const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c, Vector3& closest, Vector3& barycentric ) {
+	return detail::closestOnTriangle(&p[0], &a[0], &b[0], &c[0], &closest[0], &barycentric[0]);
+}
+
+inline float closestPointsOnSegments( const Vector3& p0, const Vector3& q0, const Vector3& p1, const Vector3& q1, Vector3& closest0, Vector3& closest1, float& s, float& t ) {
+	return detail::closestOnSegments(&p0[0], &q0[0], &p1[0], &q1[0], &closest0[0], &closest1[0], s, t);
+}
+
+inline float closestPointOnBox( const Vector3& p, const OrientedBox& box, Vector3& closest, Vector3& local ) {
+	float axes[3][3];
+	for( int i = 0; i < 3; ++i ) {
+		for( int c = 0; c < 3; ++c ) {
+			axes[i][c] = box.axes[i][c];
+		}
+	}
+	return detail::closestOnBox(&p[0], &box.center[0], axes, &box.halfExtents[0], &closest[0], &local[0]);
+}
+
+inline void closestPointOnSegment( const Vector3Block& p, const Vector3Block& a, const Vector3Block& b, Vector3Block& closest, float* t, float* sqrDistance ) {
+	using simd::Float;
+	Float vp[3], va[3], vb[3], result[3], parameter;
+	detail::closestLoad(p, vp);
+	detail::closestLoad(a, va);
+	detail::closestLoad(b, vb);
+	detail::closestOnSegment(vp, va, vb, result, parameter).store(sqrDistance);
+	parameter.store(t);
+	detail::closestStore(result, closest);
+}
+
+inline void closestPointOnTriangle( const Vector3Block& p, const Vector3Block& a, const Vector3Block& b, const Vector3Block& c, Vector3Block& closest, Vector3Block& barycentric, float* sqrDistance ) {
+	using simd::Float;
+	Float vp[3], va[3], vb[3], vc[3], result[3], weights[3];
+	detail::closestLoad(p, vp);
+	detail::closestLoad(a, va);
+	detail::closestLoad(b, vb);
+	detail::closestLoad(c, vc);
+	detail::closestOnTriangle(vp, va, vb, vc, result, weights).store(sqrDistance);
+	detail::closestStore(result, closest);
+	detail::closestStore(weights, barycentric);
+}
+
+inline void closestPointsOnSegments( const Vector3Block& p0, const Vector3Block& q0, const Vector3Block& p1, const Vector3Block& q1, Vector3Block& closest0, Vector3Block& closest1, float* s, float* t, float* sqrDistance ) {
+	using simd::Float;
+	Float vp0[3], vq0[3], vp1[3], vq1[3], result0[3], result1[3], s0, t0;
+	detail::closestLoad(p0, vp0);
+	detail::closestLoad(q0, vq0);
+	detail::closestLoad(p1, vp1);
+	detail::closestLoad(q1, vq1);
+	detail::closestOnSegments(vp0, vq0, vp1, vq1, result0, result1, s0, t0).store(sqrDistance);
+	s0.store(s);
+	t0.store(t);
+	detail::closestStore(result0, closest0);
+	detail::closestStore(result1, closest1);
+}
+
+inline void closestPointOnBox( const Vector3Block& p, const OrientedBoxBlock& box, Vector3Block& closest, Vector3Block& local, float* sqrDistance ) {
+	using simd::Float;
+	Float vp[3], center[3], axes[3][3], halfExtents[3], result[3], coordinates[3];
+	detail::closestLoad(p, vp);
+	detail::closestLoad(box.center, center);
+	for( int i = 0; i < 3; ++i ) {
+		detail::closestLoad(box.axes[i], axes[i]);
+	}
+	detail::closestLoad(box.halfExtents, halfExtents);
+	detail::closestOnBox(vp, center, axes, halfExtents, result, coordinates).store(sqrDistance);
+	detail::closestStore(result, closest);
+	detail::closestStore(coordinates, local);
+}
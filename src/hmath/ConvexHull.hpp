@@ -0,0 +1,71 @@
+#ifndef __hmath_ConvexHull__
+#define __hmath_ConvexHull__
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include "Tracing.hpp"
+#include "Vector3.hpp"
+
+namespace hm {
+
+/**
+ * Convex hull of a set of Vector3 points, by Quickhull, as an indexed triangle mesh.
+ *
+ * Building runs in three steps:
+ *  - One SIMD pass over all points finds the extreme points along 13 directions (the axes and the face and body
+ *    diagonals of a cube).  Their hull is a polytope inside the final hull, and every point below all of its faces is
+ *    discarded; for points spread through a volume, that leaves a small fraction of them.
+ *  - The remaining points are split into ranges of a fixed size, and each range is reduced to the vertices of its own
+ *    hull on a separate thread.  The hull of the union of these vertices is the hull of all points.
+ *  - The hull of the remaining vertices is built by Quickhull.
+ *
+ * Facets, their neighbors and the lists of points above them live in flat arrays indexed by integers, and freed
+ * facets are reused, so building allocates no per-facet heap objects.  Points within tolerance() of the hull are
+ * treated as on or inside it, so nearly coplanar points do not produce slivers, and faces are always triangles.
+ */
+class ConvexHull {
+public:
+	ConvexHull();
+
+	/**
+	 * Builds the hull, replacing any previous contents.
+	 *
+	 * @param points     Input points.
+	 * @param count      Number of points.
+	 * @param numThreads Number of threads; 0 uses all threads of the task executor.
+	 * @return False, leaving the hull empty, if the points do not span three dimensions.
+	 */
+	bool build( const Vector3* points, int count, int numThreads=0 );
+
+	void clear();
+
+	// hull vertices
+	std::vector<Vector3> const& vertices() const;
+	// index in the input array of each vertex
+	std::vector<int> const& sourceIndices() const;
+	// three indices into vertices() per triangle, counter-clockwise seen from outside
+	std::vector<int> const& indices() const;
+	int numTriangles() const;
+
+	// distance below which a point counts as lying on the hull, scaled with the magnitude of the input coordinates
+	float tolerance() const;
+
+private:
+	// number of points per task of the culling pass and the range hulls
+	static const int ChunkSize = 1 << 16;
+
+	std::vector<Vector3> vertices_;
+	std::vector<int> sourceIndices_;
+	std::vector<int> indices_;
+	float tolerance_;
+};
+
+#include "ConvexHull.inl"
+
+}
+
+#endif
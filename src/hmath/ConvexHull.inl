@@ -0,0 +1,635 @@
+namespace detail {
+
+// directions of the extreme point pass: the axes, the face diagonals and the body diagonals of a cube
+static const float HullDirections[13][3] = {
+	{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+	{1.0f, 1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 1.0f},
+	{1.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 1.0f}, {0.0f, 1.0f, -1.0f},
+	{1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}, {1.0f, -1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}
+};
+
+// the points of largest projection onto each direction (even slots) and its opposite (odd slots)
+struct HullExtremes {
+	float value[26];
+	int index[26];
+
+	HullExtremes() {
+		std::fill(value, value + 26, -std::numeric_limits<float>::infinity());
+		std::fill(index, index + 26, -1);
+	}
+
+	void offer( int slot, float projection, int point ) {
+		// ties go to the lowest index so that the result does not depend on how the points were split
+		if( projection > value[slot] || (projection == value[slot] && point < index[slot]) ) {
+			value[slot] = projection;
+			index[slot] = point;
+		}
+	}
+};
+
+inline HullExtremes hullExtremes( const Vector3* points, int first, int last ) {
+	using simd::Float;
+	const int W = SimdWidth;
+
+	// each lane keeps its best projections and the block they came from
+	Float best[26];
+	Float bestBlock[26];
+	for( int s = 0; s < 26; ++s ) {
+		best[s] = Float(-std::numeric_limits<float>::infinity());
+		bestBlock[s] = Float(0.0f);
+	}
+	float soa[3 * W];
+	const int numBlocks = (last - first) / W;
+	for( int b = 0; b < numBlocks; ++b ) {
+		simd::loadTransposed(&points[first + b * W][0], 3, W, soa);
+		const Float x = Float::load(soa);
+		const Float y = Float::load(soa + W);
+		const Float z = Float::load(soa + 2 * W);
+		const Float block(static_cast<float>(b));
+		for( int d = 0; d < 13; ++d ) {
+			const float* dir = HullDirections[d];
+			const Float projection = Float(dir[0]) * x + Float(dir[1]) * y + Float(dir[2]) * z;
+			const simd::Mask above = projection > best[2 * d];
+			best[2 * d] = simd::select(above, projection, best[2 * d]);
+			bestBlock[2 * d] = simd::select(above, block, bestBlock[2 * d]);
+			const simd::Mask below = -projection > best[2 * d + 1];
+			best[2 * d + 1] = simd::select(below, -projection, best[2 * d + 1]);
+			bestBlock[2 * d + 1] = simd::select(below, block, bestBlock[2 * d + 1]);
+		}
+	}
+
+	HullExtremes result;
+	if( numBlocks > 0 ) {
+		float values[W], blocks[W];
+		for( int s = 0; s < 26; ++s ) {
+			best[s].store(values);
+			bestBlock[s].store(blocks);
+			for( int l = 0; l < W; ++l ) {
+				result.offer(s, values[l], first + static_cast<int>(blocks[l]) * W + l);
+			}
+		}
+	}
+	for( int i = first + numBlocks * W; i < last; ++i ) {
+		for( int d = 0; d < 13; ++d ) {
+			const float* dir = HullDirections[d];
+			const float projection = dir[0] * points[i][0] + dir[1] * points[i][1] + dir[2] * points[i][2];
+			result.offer(2 * d, projection, i);
+			result.offer(2 * d + 1, -projection, i);
+		}
+	}
+	return result;
+}
+
+/**
+ * Incremental Quickhull over a subset of an array of points.
+ *
+ * Faces are triangles in a pool with a free list.  Each face links to its three neighbors and heads a list of the
+ * points above it, threaded through one array indexed by point, furthest point first.  The furthest point of a face
+ * becomes the next vertex: the faces it sees are removed, the horizon around them is joined to it with new faces, and
+ * the points of the removed faces are handed to the new faces they lie above, or dropped as now inside.
+ */
+class QuickHullBuilder {
+public:
+	// builds the hull of points[ids[0..count)]; returns false if they do not span three dimensions
+	bool build( const Vector3* points, const int* ids, int count, float tolerance );
+
+	// appends the indices, in the input array, of the hull vertices in order of first use by a face
+	void vertices( std::vector<int>& result ) const;
+	// appends the three local vertex indices of each face, counter-clockwise seen from outside
+	void triangles( std::vector<int>& result ) const;
+	// appends the plane of each face, as unit outward normal and offset
+	void planes( std::vector<Vector3>& normals, std::vector<float>& offsets ) const;
+
+private:
+	struct Face {
+		int vertex[3];
+		// neighbor across the edge from vertex[i] to vertex[(i + 1) % 3]
+		int neighbor[3];
+		Vector3 normal;
+		float offset;
+		// head of the list of points above the face, -1 if none, and the distance of that furthest point
+		int conflicts;
+		float furthest;
+		// stamp of the last horizon search that tested the face, and the outcome of the test
+		int visited;
+		bool visible;
+		bool alive;
+	};
+
+	struct HorizonEdge {
+		int from, to;
+		int outside;
+	};
+
+	float distance( int face, int point ) const;
+	int newFace( int a, int b, int c );
+	void addConflict( int face, int point, float distance );
+	// assigns the point to the face of faces it lies furthest above, if any
+	void assign( int point, const int* faces, int numFaces );
+	bool initialSimplex();
+	void addVertex( int face );
+
+	std::vector<Vector3> points_;
+	std::vector<int> ids_;
+	float tolerance_;
+
+	std::vector<Face> faces_;
+	std::vector<int> freeFaces_;
+	std::vector<int> pending_;
+	std::vector<int> nextConflict_;
+	// per point: stamp and position of the horizon edge starting at it, then the new face starting at it
+	std::vector<int> vertexStamp_;
+	std::vector<int> horizonAt_;
+	int stamp_;
+
+	std::vector<int> stack_;
+	std::vector<int> visible_;
+	std::vector<HorizonEdge> horizon_;
+	std::vector<int> orphans_;
+	std::vector<int> newFaces_;
+};
+
+inline bool QuickHullBuilder::build( const Vector3* points, const int* ids, int count, float tolerance ) {
+	faces_.clear();
+	if( count < 4 ) {
+		return false;
+	}
+	points_.resize(count);
+	ids_.assign(ids, ids + count);
+	for( int i = 0; i < count; ++i ) {
+		points_[i] = points[ids[i]];
+	}
+	tolerance_ = tolerance;
+	freeFaces_.clear();
+	pending_.clear();
+	nextConflict_.assign(count, -1);
+	vertexStamp_.assign(count, 0);
+	horizonAt_.assign(count, -1);
+	stamp_ = 0;
+
+	if( !initialSimplex() ) {
+		faces_.clear();
+		return false;
+	}
+	while( !pending_.empty() ) {
+		const int face = pending_.back();
+		pending_.pop_back();
+		// faces can be pending twice after their slot was freed and reused
+		if( faces_[face].alive && faces_[face].conflicts >= 0 ) {
+			addVertex(face);
+		}
+	}
+	return true;
+}
+
+inline void QuickHullBuilder::vertices( std::vector<int>& result ) const {
+	std::vector<bool> seen(points_.size(), false);
+	for( const Face& face : faces_ ) {
+		if( !face.alive ) {
+			continue;
+		}
+		for( int v : face.vertex ) {
+			if( !seen[v] ) {
+				seen[v] = true;
+				result.push_back(ids_[v]);
+			}
+		}
+	}
+}
+
+inline void QuickHullBuilder::triangles( std::vector<int>& result ) const {
+	for( const Face& face : faces_ ) {
+		if( face.alive ) {
+			result.insert(result.end(), face.vertex, face.vertex + 3);
+		}
+	}
+}
+
+inline void QuickHullBuilder::planes( std::vector<Vector3>& normals, std::vector<float>& offsets ) const {
+	for( const Face& face : faces_ ) {
+		if( face.alive ) {
+			normals.push_back(face.normal);
+			offsets.push_back(face.offset);
+		}
+	}
+}
+
+inline float QuickHullBuilder::distance( int face, int point ) const {
+	// measured from a vertex rather than with the offset, which cancels badly for points far from the origin
+	return dot(faces_[face].normal, points_[point] - points_[faces_[face].vertex[0]]);
+}
+
+inline int QuickHullBuilder::newFace( int a, int b, int c ) {
+	int index;
+	if( freeFaces_.empty() ) {
+		index = static_cast<int>(faces_.size());
+		faces_.emplace_back();
+	} else {
+		index = freeFaces_.back();
+		freeFaces_.pop_back();
+	}
+	Face& face = faces_[index];
+	face.vertex[0] = a;
+	face.vertex[1] = b;
+	face.vertex[2] = c;
+	face.neighbor[0] = face.neighbor[1] = face.neighbor[2] = -1;
+	// New faces are often slivers whose float cross product can come out pointing inwards, so the plane is computed in
+	// double and rounded once.  The centroid is the least sensitive point to take the offset at.
+	const Vector3& pa = points_[a];
+	const Vector3& pb = points_[b];
+	const Vector3& pc = points_[c];
+	double u[3], v[3], centroid[3];
+	for( int i = 0; i < 3; ++i ) {
+		u[i] = static_cast<double>(pb[i]) - static_cast<double>(pa[i]);
+		v[i] = static_cast<double>(pc[i]) - static_cast<double>(pa[i]);
+		centroid[i] = (static_cast<double>(pa[i]) + static_cast<double>(pb[i]) + static_cast<double>(pc[i])) / 3.0;
+	}
+	const double n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+	const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	const double scale = (length > 0.0) ? 1.0 / length : 0.0;
+	face.normal = Vector3({static_cast<float>(n[0] * scale), static_cast<float>(n[1] * scale), static_cast<float>(n[2] * scale)});
+	face.offset = static_cast<float>((n[0] * centroid[0] + n[1] * centroid[1] + n[2] * centroid[2]) * scale);
+	face.conflicts = -1;
+	face.furthest = 0.0f;
+	face.visited = 0;
+	face.visible = false;
+	face.alive = true;
+	return index;
+}
+
+inline void QuickHullBuilder::addConflict( int face, int point, float distance ) {
+	Face& f = faces_[face];
+	if( f.conflicts < 0 || distance > f.furthest ) {
+		nextConflict_[point] = f.conflicts;
+		f.conflicts = point;
+		f.furthest = distance;
+	} else {
+		nextConflict_[point] = nextConflict_[f.conflicts];
+		nextConflict_[f.conflicts] = point;
+	}
+}
+
+inline void QuickHullBuilder::assign( int point, const int* faces, int numFaces ) {
+	int best = -1;
+	float bestDistance = tolerance_;
+	for( int i = 0; i < numFaces; ++i ) {
+		const float d = distance(faces[i], point);
+		if( d > bestDistance ) {
+			best = faces[i];
+			bestDistance = d;
+		}
+	}
+	if( best >= 0 ) {
+		addConflict(best, point, bestDistance);
+	}
+}
+
+inline bool QuickHullBuilder::initialSimplex() {
+	const int count = static_cast<int>(points_.size());
+
+	// the two furthest apart of the extreme points along the axes
+	int extremes[6] = {0, 0, 0, 0, 0, 0};
+	for( int i = 1; i < count; ++i ) {
+		for( int axis = 0; axis < 3; ++axis ) {
+			if( points_[i][axis] < points_[extremes[2 * axis]][axis] ) {
+				extremes[2 * axis] = i;
+			}
+			if( points_[i][axis] > points_[extremes[2 * axis + 1]][axis] ) {
+				extremes[2 * axis + 1] = i;
+			}
+		}
+	}
+	int a = 0, b = 0;
+	float largest = 0.0f;
+	for( int i = 0; i < 6; ++i ) {
+		for( int j = i + 1; j < 6; ++j ) {
+			const float d = sqrDistance(points_[extremes[i]], points_[extremes[j]]);
+			if( d > largest ) {
+				largest = d;
+				a = extremes[i];
+				b = extremes[j];
+			}
+		}
+	}
+	if( std::sqrt(largest) <= tolerance_ ) {
+		return false;
+	}
+
+	// the point furthest from their line, then the point furthest from the plane of the three
+	const Vector3 axis = (points_[b] - points_[a]) / std::sqrt(largest);
+	int c = -1;
+	largest = tolerance_ * tolerance_;
+	for( int i = 0; i < count; ++i ) {
+		const float d = sqrLength(cross(points_[i] - points_[a], axis));
+		if( d > largest ) {
+			largest = d;
+			c = i;
+		}
+	}
+	if( c < 0 ) {
+		return false;
+	}
+	Vector3 normal = cross(points_[b] - points_[a], points_[c] - points_[a]);
+	normalize(normal);
+	int d = -1;
+	largest = tolerance_;
+	for( int i = 0; i < count; ++i ) {
+		const float h = std::fabs(dot(normal, points_[i] - points_[a]));
+		if( h > largest ) {
+			largest = h;
+			d = i;
+		}
+	}
+	if( d < 0 ) {
+		return false;
+	}
+
+	// orient the base away from d; each edge of the tetrahedron then runs opposite ways in its two faces
+	if( dot(normal, points_[d] - points_[a]) > 0.0f ) {
+		std::swap(b, c);
+	}
+	const int faces[4] = {newFace(a, b, c), newFace(b, a, d), newFace(c, b, d), newFace(a, c, d)};
+	for( int f : faces ) {
+		for( int e = 0; e < 3; ++e ) {
+			const int from = faces_[f].vertex[e];
+			const int to = faces_[f].vertex[(e + 1) % 3];
+			for( int g : faces ) {
+				for( int k = 0; k < 3; ++k ) {
+					if( faces_[g].vertex[k] == to && faces_[g].vertex[(k + 1) % 3] == from ) {
+						faces_[f].neighbor[e] = g;
+					}
+				}
+			}
+		}
+	}
+
+	for( int i = 0; i < count; ++i ) {
+		if( i != a && i != b && i != c && i != d ) {
+			assign(i, faces, 4);
+		}
+	}
+	pending_.assign(faces, faces + 4);
+	return true;
+}
+
+inline void QuickHullBuilder::addVertex( int face ) {
+	const int eye = faces_[face].conflicts;
+	faces_[face].conflicts = nextConflict_[eye];
+	const int stamp = ++stamp_;
+
+	// Flood the faces the eye sees; each edge from a visible to a hidden face is on the horizon.  Only the first face
+	// needs the eye beyond tolerance: a neighbor the eye is above at all is replaced as well, as joining the eye to its
+	// edge would fold the new face over it.
+	visible_.clear();
+	horizon_.clear();
+	stack_.assign(1, face);
+	faces_[face].visited = stamp;
+	faces_[face].visible = true;
+	while( !stack_.empty() ) {
+		const int f = stack_.back();
+		stack_.pop_back();
+		visible_.push_back(f);
+		for( int e = 0; e < 3; ++e ) {
+			const int n = faces_[f].neighbor[e];
+			Face& neighbor = faces_[n];
+			if( neighbor.visited != stamp ) {
+				neighbor.visited = stamp;
+				neighbor.visible = distance(n, eye) > 0.0f;
+				if( neighbor.visible ) {
+					stack_.push_back(n);
+				}
+			}
+			if( !neighbor.visible ) {
+				horizon_.push_back(HorizonEdge{faces_[f].vertex[e], faces_[f].vertex[(e + 1) % 3], n});
+			}
+		}
+	}
+
+	// Rounding can make the visible faces something other than a disk, whose boundary is not a single loop.  The eye
+	// is then within rounding of the hull, and is dropped rather than joined to a broken horizon.
+	const int numEdges = static_cast<int>(horizon_.size());
+	bool simple = numEdges >= 3;
+	for( int i = 0; i < numEdges && simple; ++i ) {
+		simple = vertexStamp_[horizon_[i].from] != stamp;
+		vertexStamp_[horizon_[i].from] = stamp;
+		horizonAt_[horizon_[i].from] = i;
+	}
+	if( simple ) {
+		int steps = 0;
+		int i = 0;
+		do {
+			const int to = horizon_[i].to;
+			if( vertexStamp_[to] != stamp ) {
+				simple = false;
+				break;
+			}
+			i = horizonAt_[to];
+		} while( ++steps < numEdges && i != 0 );
+		simple = simple && i == 0 && steps == numEdges;
+	}
+	if( !simple ) {
+		if( faces_[face].conflicts >= 0 ) {
+			pending_.push_back(face);
+		}
+		return;
+	}
+
+	// collect the points of the visible faces and free them, so that the new faces reuse their slots
+	orphans_.clear();
+	for( int f : visible_ ) {
+		for( int p = faces_[f].conflicts; p >= 0; p = nextConflict_[p] ) {
+			orphans_.push_back(p);
+		}
+		faces_[f].alive = false;
+		freeFaces_.push_back(f);
+	}
+
+	newFaces_.clear();
+	for( const HorizonEdge& edge : horizon_ ) {
+		const int f = newFace(edge.from, edge.to, eye);
+		faces_[f].neighbor[0] = edge.outside;
+		Face& outside = faces_[edge.outside];
+		for( int k = 0; k < 3; ++k ) {
+			if( outside.vertex[k] == edge.to && outside.vertex[(k + 1) % 3] == edge.from ) {
+				outside.neighbor[k] = f;
+			}
+		}
+		horizonAt_[edge.from] = f;
+		newFaces_.push_back(f);
+	}
+	// the new face from a to b meets the one from b at the edge from b to the eye
+	for( int f : newFaces_ ) {
+		const int next = horizonAt_[faces_[f].vertex[1]];
+		faces_[f].neighbor[1] = next;
+		faces_[next].neighbor[2] = f;
+	}
+
+	for( int p : orphans_ ) {
+		assign(p, newFaces_.data(), static_cast<int>(newFaces_.size()));
+	}
+	for( int f : newFaces_ ) {
+		if( faces_[f].conflicts >= 0 ) {
+			pending_.push_back(f);
+		}
+	}
+}
+
+}
+
+inline ConvexHull::ConvexHull()
+	: tolerance_(0.0f) {
+}
+
+inline bool ConvexHull::build( const Vector3* points, int count, int numThreads ) {
+	HMATH_TRACE_BATCH(ConvexHullBuild, 0, count);
+	clear();
+	count = std::max(count, 0);
+	if( count < 4 ) {
+		return false;
+	}
+
+	// extreme points, in ranges of a fixed size combined in order
+	const int chunkSize = ChunkSize;
+	const detail::HullExtremes extremes = parallelReduce(0, count, chunkSize, detail::HullExtremes(), [=]( int first, int last ) {
+		return detail::hullExtremes(points, first, last);
+	}, []( detail::HullExtremes merged, const detail::HullExtremes& part ) {
+		for( int s = 0; s < 26; ++s ) {
+			merged.offer(s, part.value[s], part.index[s]);
+		}
+		return merged;
+	}, numThreads);
+
+	// rounding of plane distances grows with the coordinates, as in qhull
+	float magnitude = 0.0f;
+	for( int axis = 0; axis < 3; ++axis ) {
+		magnitude += std::max(extremes.value[2 * axis], extremes.value[2 * axis + 1]);
+	}
+	// no extremes at all when every point is NaN
+	if( !std::isfinite(magnitude) ) {
+		return false;
+	}
+	for( int s = 0; s < 26; ++s ) {
+		if( extremes.index[s] < 0 ) {
+			return false;
+		}
+	}
+	tolerance_ = 3.0f * magnitude * std::numeric_limits<float>::epsilon();
+
+	// the hull of the extreme points, whose faces cull the points inside it
+	std::vector<int> seeds(extremes.index, extremes.index + 26);
+	std::sort(seeds.begin(), seeds.end());
+	seeds.erase(std::unique(seeds.begin(), seeds.end()), seeds.end());
+	std::vector<Vector3> normals;
+	std::vector<float> offsets;
+	{
+		detail::QuickHullBuilder seedHull;
+		if( seedHull.build(points, seeds.data(), static_cast<int>(seeds.size()), tolerance_) ) {
+			seedHull.planes(normals, offsets);
+		}
+	}
+	const int numPlanes = static_cast<int>(normals.size());
+
+	// cull each range, then reduce what is left of it to the vertices of its own hull
+	const int numChunks = (count + ChunkSize - 1) / ChunkSize;
+	std::vector<std::vector<int>> candidates(numChunks);
+	const float tolerance = tolerance_;
+	parallelFor(0, numChunks, 1, [&]( int firstChunk, int lastChunk ) {
+		using simd::Float;
+		const int W = SimdWidth;
+		float soa[3 * W];
+		std::vector<int> kept;
+		detail::QuickHullBuilder builder;
+		for( int chunk = firstChunk; chunk < lastChunk; ++chunk ) {
+			const int first = chunk * ChunkSize;
+			const int last = std::min(first + ChunkSize, count);
+			kept.clear();
+			for( int i = first; i < last; i += W ) {
+				const int n = std::min(W, last - i);
+				if( numPlanes == 0 ) {
+					for( int l = 0; l < n; ++l ) {
+						kept.push_back(i + l);
+					}
+					continue;
+				}
+				simd::loadTransposed(&points[i][0], 3, n, soa);
+				const Float x = Float::load(soa);
+				const Float y = Float::load(soa + W);
+				const Float z = Float::load(soa + 2 * W);
+				Float outside(-std::numeric_limits<float>::infinity());
+				for( int p = 0; p < numPlanes; ++p ) {
+					const Vector3& normal = normals[p];
+					const Float d = Float(normal[0]) * x + Float(normal[1]) * y + Float(normal[2]) * z - Float(offsets[p]);
+					outside = simd::maximum(outside, d);
+				}
+				const simd::Mask keep = outside > Float(tolerance);
+				for( int l = 0; l < n; ++l ) {
+					if( keep[l] ) {
+						kept.push_back(i + l);
+					}
+				}
+			}
+
+			std::vector<int>& result = candidates[chunk];
+			if( numChunks > 1 && builder.build(points, kept.data(), static_cast<int>(kept.size()), tolerance) ) {
+				builder.vertices(result);
+			} else {
+				result = kept;
+			}
+		}
+	}, numThreads);
+
+	// the seed points lie on the culling planes and were culled with the points inside
+	std::vector<int> remaining = seeds;
+	for( const std::vector<int>& chunk : candidates ) {
+		remaining.insert(remaining.end(), chunk.begin(), chunk.end());
+	}
+	std::sort(remaining.begin(), remaining.end());
+	remaining.erase(std::unique(remaining.begin(), remaining.end()), remaining.end());
+
+	detail::QuickHullBuilder hull;
+	if( !hull.build(points, remaining.data(), static_cast<int>(remaining.size()), tolerance_) ) {
+		return false;
+	}
+
+	// compact the vertices in order of first use
+	std::vector<int> triangles;
+	hull.triangles(triangles);
+	std::vector<int> compact(remaining.size(), -1);
+	indices_.reserve(triangles.size());
+	for( int local : triangles ) {
+		if( compact[local] < 0 ) {
+			compact[local] = static_cast<int>(vertices_.size());
+			vertices_.push_back(points[remaining[local]]);
+			sourceIndices_.push_back(remaining[local]);
+		}
+		indices_.push_back(compact[local]);
+	}
+	return true;
+}
+
+inline void ConvexHull::clear() {
+	vertices_.clear();
+	sourceIndices_.clear();
+	indices_.clear();
+	tolerance_ = 0.0f;
+}
+
+inline std::vector<Vector3> const& ConvexHull::vertices() const {
+	return vertices_;
+}
+
+inline std::vector<int> const& ConvexHull::sourceIndices() const {
+	return sourceIndices_;
+}
+
+inline std::vector<int> const& ConvexHull::indices() const {
+	return indices_;
+}
+
+inline int ConvexHull::numTriangles() const {
+	return static_cast<int>(indices_.size() / 3);
+}
+
+inline float ConvexHull::tolerance() const {
+	return tolerance_;
+}
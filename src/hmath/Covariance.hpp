@@ -0,0 +1,124 @@
+#ifndef __hmath_Covariance__
+#define __hmath_Covariance__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "Matrix.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include "SymmetricEigen.hpp"
+#include "Tracing.hpp"
+#include "Unroll.hpp"
+#include "Vector.hpp"
+#include "Vector3.hpp"
+
+namespace hm {
+
+/**
+ * Single-pass mean and covariance of a stream of Vector<N> points, by Welford's update.
+ *
+ * Only the count, the mean and the scatter matrix (the sum of outer products of deviations from the mean) are kept,
+ * so points can be added as they are read and need not fit in memory.  Updating around the running mean avoids the
+ * cancellation of the textbook sum(x x^T) - n mean mean^T, which loses all precision in float once the points are far
+ * from the origin.  Accumulators over different points merge exactly (Chan's formula), so chunks and threads can be
+ * accumulated separately and combined.
+ */
+template<int N>
+class CovarianceAccumulator {
+public:
+	CovarianceAccumulator();
+
+	// discards all points
+	void reset();
+
+	/**
+	 * Adds a point.
+	 *
+	 * @param point Point to add.
+	 */
+	void add( const Vector<N>& point );
+
+	/**
+	 * Adds an array of points.
+	 *
+	 * Up to 8 dimensions, the points are added in blocks of SimdWidth, one running update per SIMD lane, and the lanes
+	 * are merged after at most 1024 blocks.  Larger points are added one at a time.
+	 *
+	 * @param points Points to add.
+	 * @param count  Number of points.
+	 */
+	void add( const Vector<N>* points, int count );
+
+	/**
+	 * Adds all points of another accumulator, as if they had been added to this one.
+	 *
+	 * @param other Accumulator to merge.
+	 */
+	void merge( const CovarianceAccumulator& other );
+
+	std::int64_t count() const;
+	// mean of the points, zero if there are none
+	Vector<N> const& mean() const;
+	// sum of (x - mean)(x - mean)^T over the points
+	Matrix<N, N> const& scatter() const;
+	// scatter() / count(), zero if there are no points
+	Matrix<N, N> covariance() const;
+	// scatter() / (count() - 1), the unbiased estimate of the covariance of the population; zero below two points
+	Matrix<N, N> sampleCovariance() const;
+
+private:
+	// merges the moments of count points
+	void merge( std::int64_t count, const Vector<N>& mean, const Matrix<N, N>& scatter );
+	// adds the leading whole blocks of points across the lanes, up to 8 dimensions; returns the number of points added
+	int addLanes( const Vector<N>* points, int count, std::true_type );
+	int addLanes( const Vector<N>* points, int count, std::false_type );
+	// adds numBlocks*SimdWidth points, one per lane
+	void addBlocks( const Vector<N>* points, int numBlocks );
+
+	std::int64_t count_;
+	Vector<N> mean_;
+	Matrix<N, N> scatter_;
+};
+
+/**
+ * Accumulates the mean and covariance of an array of points on several threads.
+ *
+ * The points are split into ranges of a fixed size whose accumulators are merged in order, so the result does not
+ * depend on the number of threads.
+ *
+ * @param points     Points to accumulate.
+ * @param count      Number of points.
+ * @param numThreads Number of threads; 0 uses all threads of the task executor.
+ */
+template<int N>
+inline CovarianceAccumulator<N> computeCovariance( const Vector<N>* points, int count, int numThreads=0 );
+
+/**
+ * Computes the principal axes of accumulated points, the eigenvectors of their covariance.
+ *
+ * @param accumulator Accumulated points.
+ * @param axes        Receives the unit axes as columns, the direction of largest spread first.
+ * @param variances   Receives the variance of the points along each axis.
+ * @return False if there are no points or the eigen solver did not converge.
+ */
+template<int N>
+inline bool principalAxes( const CovarianceAccumulator<N>& accumulator, Matrix<N, N>& axes, Vector<N>& variances );
+
+/**
+ * Fits a plane to accumulated points, minimizing the sum of squared distances to it.  The plane passes through the
+ * mean and is normal to the axis of least spread.
+ *
+ * @param accumulator Accumulated points.
+ * @param point       Receives a point on the plane.
+ * @param normal      Receives the unit normal of the plane; its sign is arbitrary.
+ * @return False if there are fewer than three points or they lie on a line, leaving no unique plane.
+ */
+inline bool fitPlane( const CovarianceAccumulator<3>& accumulator, Vector3& point, Vector3& normal );
+
+#include "Covariance.inl"
+
+}
+
+#endif
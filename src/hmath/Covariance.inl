@@ -0,0 +1,222 @@
+namespace detail {
+
+// blocks of SimdWidth points that CovarianceAccumulator::add runs in lanes before merging them; short runs keep the
+// 1/n steps of the running means well above rounding
+static const int CovarianceLaneBlocks = 1024;
+
+// points per task of computeCovariance; fixed so that results do not depend on the number of threads
+static const int CovariancePointsPerTask = 1 << 14;
+
+}
+
+template<int N>
+CovarianceAccumulator<N>::CovarianceAccumulator() {
+	reset();
+}
+
+template<int N>
+void CovarianceAccumulator<N>::reset() {
+	count_ = 0;
+	mean_.makeZero();
+	scatter_.makeZero();
+}
+
+template<int N>
+void CovarianceAccumulator<N>::add( const Vector<N>& point ) {
+	++count_;
+	const Vector<N> delta = point - mean_;
+	mean_ += delta / static_cast<float>(count_);
+	const Vector<N> after = point - mean_;
+	// delta after^T is symmetric up to rounding; the lower triangle is mirrored so that the result is exactly so
+	for( int r = 0; r < N; ++r ) {
+		for( int c = 0; c <= r; ++c ) {
+			scatter_(r, c) += delta[r] * after[c];
+			scatter_(c, r) = scatter_(r, c);
+		}
+	}
+}
+
+template<int N>
+void CovarianceAccumulator<N>::add( const Vector<N>* points, int count ) {
+	HMATH_TRACE_BATCH(CovarianceBatch, N, count);
+	for( int i = addLanes(points, count, std::integral_constant<bool, (N <= 8)>()); i < count; ++i ) {
+		add(points[i]);
+	}
+}
+
+template<int N>
+int CovarianceAccumulator<N>::addLanes( const Vector<N>* points, int count, std::true_type ) {
+	const int W = SimdWidth;
+	int i = 0;
+	while( count - i >= W ) {
+		const int numBlocks = std::min((count - i) / W, detail::CovarianceLaneBlocks);
+		addBlocks(points + i, numBlocks);
+		i += numBlocks * W;
+	}
+	return i;
+}
+
+template<int N>
+int CovarianceAccumulator<N>::addLanes( const Vector<N>*, int, std::false_type ) {
+	// too many registers per lane to pay off
+	return 0;
+}
+
+template<int N>
+void CovarianceAccumulator<N>::merge( const CovarianceAccumulator& other ) {
+	merge(other.count_, other.mean_, other.scatter_);
+}
+
+template<int N>
+std::int64_t CovarianceAccumulator<N>::count() const {
+	return count_;
+}
+
+template<int N>
+Vector<N> const& CovarianceAccumulator<N>::mean() const {
+	return mean_;
+}
+
+template<int N>
+Matrix<N, N> const& CovarianceAccumulator<N>::scatter() const {
+	return scatter_;
+}
+
+template<int N>
+Matrix<N, N> CovarianceAccumulator<N>::covariance() const {
+	Matrix<N, N> result = scatter_;
+	const float scale = (count_ > 0) ? 1.0f / static_cast<float>(count_) : 0.0f;
+	for( int i = 0; i < N * N; ++i ) {
+		result[i] *= scale;
+	}
+	return result;
+}
+
+template<int N>
+Matrix<N, N> CovarianceAccumulator<N>::sampleCovariance() const {
+	Matrix<N, N> result = scatter_;
+	const float scale = (count_ > 1) ? 1.0f / static_cast<float>(count_ - 1) : 0.0f;
+	for( int i = 0; i < N * N; ++i ) {
+		result[i] *= scale;
+	}
+	return result;
+}
+
+template<int N>
+void CovarianceAccumulator<N>::merge( std::int64_t count, const Vector<N>& mean, const Matrix<N, N>& scatter ) {
+	if( count == 0 ) {
+		return;
+	}
+	if( count_ == 0 ) {
+		count_ = count;
+		mean_ = mean;
+		scatter_ = scatter;
+		return;
+	}
+
+	// the scatter of the union adds that of the two means about the merged one
+	const double total = static_cast<double>(count_) + static_cast<double>(count);
+	const float weight = static_cast<float>(static_cast<double>(count) / total);
+	const float cross = static_cast<float>(static_cast<double>(count_) * static_cast<double>(count) / total);
+	const Vector<N> delta = mean - mean_;
+	mean_ += delta * weight;
+	for( int r = 0; r < N; ++r ) {
+		for( int c = 0; c < N; ++c ) {
+			scatter_(r, c) += scatter(r, c) + delta[r] * delta[c] * cross;
+		}
+	}
+	count_ += count;
+}
+
+template<int N>
+void CovarianceAccumulator<N>::addBlocks( const Vector<N>* points, int numBlocks ) {
+	using simd::Float;
+	const int W = SimdWidth;
+
+	// the lower triangle of each lane's scatter, row by row
+	Float mean[N];
+	Float scatter[N * (N + 1) / 2];
+	detail::unroll<N>([&]( auto i ) {
+		mean[i] = Float(0.0f);
+	});
+	detail::unroll<N * (N + 1) / 2>([&]( auto i ) {
+		scatter[i] = Float(0.0f);
+	});
+
+	float soa[N * W];
+	for( int b = 0; b < numBlocks; ++b ) {
+		simd::loadTransposed(&points[b * W][0], N, W, soa);
+		const Float inverseCount(1.0f / static_cast<float>(b + 1));
+		Float delta[N];
+		Float after[N];
+		detail::unroll<N>([&]( auto i ) {
+			const Float x = Float::load(soa + i * W);
+			delta[i] = x - mean[i];
+			mean[i] += delta[i] * inverseCount;
+			after[i] = x - mean[i];
+		});
+		detail::unroll<N>([&]( auto r ) {
+			detail::unroll<decltype(r)::value + 1>([&]( auto c ) {
+				scatter[r * (r + 1) / 2 + c] += delta[r] * after[c];
+			});
+		});
+	}
+
+	float lanes[(N + N * (N + 1) / 2) * W];
+	for( int i = 0; i < N; ++i ) {
+		mean[i].store(lanes + i * W);
+	}
+	for( int i = 0; i < N * (N + 1) / 2; ++i ) {
+		scatter[i].store(lanes + (N + i) * W);
+	}
+
+	// lanes hold equal counts and similar means, so they are merged with each other before with the running state
+	CovarianceAccumulator merged;
+	for( int l = 0; l < W; ++l ) {
+		Vector<N> laneMean;
+		Matrix<N, N> laneScatter;
+		for( int r = 0; r < N; ++r ) {
+			laneMean[r] = lanes[r * W + l];
+			for( int c = 0; c <= r; ++c ) {
+				laneScatter(r, c) = laneScatter(c, r) = lanes[(N + r * (r + 1) / 2 + c) * W + l];
+			}
+		}
+		merged.merge(numBlocks, laneMean, laneScatter);
+	}
+	merge(merged);
+}
+
+template<int N>
+CovarianceAccumulator<N> computeCovariance( const Vector<N>* points, int count, int numThreads ) {
+	const int pointsPerTask = detail::CovariancePointsPerTask;
+	return parallelReduce(0, std::max(count, 0), pointsPerTask, CovarianceAccumulator<N>(), [=]( int first, int last ) {
+		CovarianceAccumulator<N> part;
+		part.add(points + first, last - first);
+		return part;
+	}, []( CovarianceAccumulator<N> merged, const CovarianceAccumulator<N>& part ) {
+		merged.merge(part);
+		return merged;
+	}, numThreads);
+}
+
+template<int N>
+bool principalAxes( const CovarianceAccumulator<N>& accumulator, Matrix<N, N>& axes, Vector<N>& variances ) {
+	if( accumulator.count() == 0 ) {
+		axes.makeIdentity();
+		variances.makeZero();
+		return false;
+	}
+	return symmetricEigen(accumulator.covariance(), variances, axes);
+}
+
+inline bool fitPlane( const CovarianceAccumulator<3>& accumulator, Vector3& point, Vector3& normal ) {
+	point = accumulator.mean();
+	Matrix<3, 3> axes;
+	Vector3 variances;
+	const bool solved = principalAxes(accumulator, axes, variances);
+	normal = Vector3({axes(0, 2), axes(1, 2), axes(2, 2)});
+
+	// points on a line spread along a single axis and leave the normal free to turn about it
+	const float tolerance = variances[0] * 16.0f * std::numeric_limits<float>::epsilon();
+	return solved && accumulator.count() >= 3 && variances[1] > tolerance;
+}
@@ -3,8 +3,11 @@
 #ifndef __hmath_GaussianElimination__
 #define __hmath_GaussianElimination__
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
+#include "Instrumentation.hpp"
+#include "Tracing.hpp"
 
 namespace hm {
 
@@ -16,7 +19,7 @@ public:
 		const float* C, int numCols, float* Y ) const;
 
 private:
-	void set( int numElements, const float* source, float* target ) const;
+	inline void set( int numElements, const float* source, float* target ) const;
 	inline float& valueAt( int numCols, int r, int c, float* matrix ) const;
 };
 
@@ -26,6 +29,10 @@ bool GaussianElimination::operator()( int numRows, const float* M, float* invers
 		return false;
 	}
 
+	HMATH_TRACE_SCOPE(GaussianElimination, numRows);
+	HMATH_COUNT(GaussianEliminationCalls);
+	HMATH_COUNT_MATRIX_SIZE(numRows);
+
 	int numElements = numRows * numRows;
 	bool wantInverse = (inverseM != nullptr);
 	std::vector<float> localInverseM;
@@ -74,6 +81,7 @@ bool GaussianElimination::operator()( int numRows, const float* M, float* invers
 
 		if( maxValue == zero ) {
 			// The matrix is not invertible.
+			HMATH_COUNT(GaussianEliminationSingular);
 			if( wantInverse ) {
 				set(numElements, nullptr, inverseM);
 			}
@@ -172,6 +180,14 @@ bool GaussianElimination::operator()( int numRows, const float* M, float* invers
 	return true;
 }
 
+void GaussianElimination::set( int numElements, const float* source, float* target ) const {
+	if( source ) {
+		std::copy(source, source + numElements, target);
+	} else {
+		std::fill(target, target + numElements, 0.0f);
+	}
+}
+
 float& GaussianElimination::valueAt( int numCols, int r, int c, float* matrix ) const {
 	return matrix[c + numCols*r];
 }
@@ -0,0 +1,137 @@
+#ifndef __hmath_Half__
+#define __hmath_Half__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "Matrix4x4.hpp"
+#include "Simd.hpp"
+#include "Vector.hpp"
+
+/**
+ * F16C converts eight floats to or from half precision per instruction.  It is used when the compiler targets it
+ * (GCC and Clang with -mf16c or -march, MSVC with /arch:AVX2).
+ */
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+	#define HMATH_HALF_F16C
+	#include <immintrin.h>
+#endif
+
+namespace hm {
+
+/**
+ * IEEE 754 binary16 storage: 1 sign bit, 5 exponent bits and 10 mantissa bits, for about 3 decimal digits over
+ * +-65504.  Conversions from float round to nearest even; overflow becomes infinity and NaN stays NaN.  Half is a
+ * storage type only: convert to float to compute, or use the batch operations below, which widen on the fly.
+ */
+class Half {
+public:
+	Half();
+	explicit Half( float value );
+
+	float toFloat() const;
+
+	static Half fromBits( std::uint16_t bits );
+	std::uint16_t bits() const;
+
+private:
+	std::uint16_t bits_;
+};
+
+/**
+ * Vector<N> stored in half precision.
+ */
+template<int N>
+class HalfVector {
+public:
+	HalfVector();
+	explicit HalfVector( const Vector<N>& vec );
+
+	Vector<N> toVector() const;
+
+	inline Half const& operator[]( int index ) const;
+	inline Half& operator[]( int index );
+
+private:
+	Half components_[N];
+};
+
+/**
+ * Matrix<Rows, Cols> stored in half precision, in the same row-major order.
+ */
+template<int Rows, int Cols>
+class HalfMatrix {
+public:
+	HalfMatrix();
+	explicit HalfMatrix( const Matrix<Rows, Cols>& M );
+
+	Matrix<Rows, Cols> toMatrix() const;
+
+	inline Half const& operator()( int r, int c ) const;
+	inline Half& operator()( int r, int c );
+
+private:
+	Half data_[Rows * Cols];
+};
+
+/**
+ * Converts an array of floats to half precision.
+ */
+inline void packHalf( const float* values, Half* halves, int count );
+
+/**
+ * Converts an array of half precision values to floats.
+ */
+inline void unpackHalf( const Half* halves, float* values, int count );
+
+// array conversions of vectors and matrices
+template<int N>
+inline void packHalf( const Vector<N>* vectors, HalfVector<N>* halves, int count );
+
+template<int N>
+inline void unpackHalf( const HalfVector<N>* halves, Vector<N>* vectors, int count );
+
+template<int Rows, int Cols>
+inline void packHalf( const Matrix<Rows, Cols>* matrices, HalfMatrix<Rows, Cols>* halves, int count );
+
+template<int Rows, int Cols>
+inline void unpackHalf( const HalfMatrix<Rows, Cols>* halves, Matrix<Rows, Cols>* matrices, int count );
+
+/**
+ * Dot product of every packed vector with one direction.
+ *
+ * @param vectors   Packed vectors.
+ * @param count     Number of vectors.
+ * @param direction Vector to dot with.
+ * @param results   Receives count dot products.
+ */
+template<int N>
+inline void dot( const HalfVector<N>* vectors, int count, const Vector<N>& direction, float* results );
+
+/**
+ * Pairwise dot products of two packed arrays.
+ */
+template<int N>
+inline void dot( const HalfVector<N>* a, const HalfVector<N>* b, int count, float* results );
+
+/**
+ * Transforms packed points as the row vectors (x, y, z, 1) times M, without a perspective divide.
+ *
+ * @param points  Packed points.
+ * @param count   Number of points.
+ * @param M       Affine transform, with the translation in row 3.
+ * @param results Receives count transformed points in full precision.
+ */
+inline void transformPoints( const HalfVector<3>* points, int count, const Matrix4x4& M, Vector3* results );
+
+/**
+ * Computes the axis-aligned bounds of packed points.  Returns false, leaving the bounds unchanged, if count is 0.
+ */
+template<int N>
+inline bool bounds( const HalfVector<N>* points, int count, Vector<N>& boxMin, Vector<N>& boxMax );
+
+#include "Half.inl"
+
+}
+
+#endif
@@ -0,0 +1,296 @@
+namespace detail {
+
+inline std::uint32_t floatBits( float value ) {
+	std::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+inline float bitsFloat( std::uint32_t bits ) {
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// round to nearest even; results below the normal range are rounded by a float addition that aligns the mantissa
+inline std::uint16_t floatToHalfBits( float value ) {
+	const std::uint32_t infinity = 255u << 23;
+	const std::uint32_t halfOverflow = (127u + 16u) << 23;
+	const std::uint32_t denormalMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+	std::uint32_t x = floatBits(value);
+	const std::uint32_t sign = x & 0x80000000u;
+	x ^= sign;
+
+	std::uint32_t result;
+	if( x >= halfOverflow ) {
+		// infinity stays infinity, NaN becomes a quiet NaN, and the rest overflows
+		result = (x > infinity) ? 0x7e00u : 0x7c00u;
+	} else if( x < (113u << 23) ) {
+		result = floatBits(bitsFloat(x) + bitsFloat(denormalMagic)) - denormalMagic;
+	} else {
+		const std::uint32_t mantissaOdd = (x >> 13) & 1u;
+		x += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfffu;
+		x += mantissaOdd;
+		result = x >> 13;
+	}
+	return static_cast<std::uint16_t>(result | (sign >> 16));
+}
+
+inline float halfBitsToFloat( std::uint16_t half ) {
+	const std::uint32_t shiftedExponent = 0x7c00u << 13;
+	std::uint32_t x = (half & 0x7fffu) << 13;
+	const std::uint32_t exponent = x & shiftedExponent;
+	x += (127u - 15u) << 23;
+	if( exponent == shiftedExponent ) {
+		// infinity or NaN
+		x += (128u - 16u) << 23;
+	} else if( exponent == 0 ) {
+		// zero or subnormal, renormalized by a float subtraction
+		x += 1u << 23;
+		x = floatBits(bitsFloat(x) - bitsFloat(113u << 23));
+	}
+	return bitsFloat(x | (static_cast<std::uint32_t>(half & 0x8000u) << 16));
+}
+
+// widens up to SimdWidth packed vectors into soa rows; lanes past count repeat the first vector
+template<int N>
+inline void unpackHalfBlock( const HalfVector<N>* vectors, int count, float* soa ) {
+	float aos[N * SimdWidth];
+	unpackHalf(&vectors[0][0], aos, N * count);
+	for( int lane = count; lane < SimdWidth; ++lane ) {
+		std::copy(aos, aos + N, aos + N * lane);
+	}
+	simd::loadTransposed(aos, N, SimdWidth, soa);
+}
+
+}
+
+inline Half::Half()
+	: bits_(0) {
+}
+
+inline Half::Half( float value )
+	: bits_(detail::floatToHalfBits(value)) {
+}
+
+inline float Half::toFloat() const {
+	return detail::halfBitsToFloat(bits_);
+}
+
+inline Half Half::fromBits( std::uint16_t bits ) {
+	Half half;
+	half.bits_ = bits;
+	return half;
+}
+
+inline std::uint16_t Half::bits() const {
+	return bits_;
+}
+
+template<int N>
+HalfVector<N>::HalfVector() {
+}
+
+template<int N>
+HalfVector<N>::HalfVector( const Vector<N>& vec ) {
+	for( int i = 0; i < N; ++i ) {
+		components_[i] = Half(vec[i]);
+	}
+}
+
+template<int N>
+Vector<N> HalfVector<N>::toVector() const {
+	Vector<N> result;
+	for( int i = 0; i < N; ++i ) {
+		result[i] = components_[i].toFloat();
+	}
+	return result;
+}
+
+template<int N>
+Half const& HalfVector<N>::operator[]( int index ) const {
+	assert(index >= 0 && index < N);
+	return components_[index];
+}
+
+template<int N>
+Half& HalfVector<N>::operator[]( int index ) {
+	assert(index >= 0 && index < N);
+	return components_[index];
+}
+
+template<int Rows, int Cols>
+HalfMatrix<Rows, Cols>::HalfMatrix() {
+}
+
+template<int Rows, int Cols>
+HalfMatrix<Rows, Cols>::HalfMatrix( const Matrix<Rows, Cols>& M ) {
+	for( int i = 0; i < Rows * Cols; ++i ) {
+		data_[i] = Half(M[i]);
+	}
+}
+
+template<int Rows, int Cols>
+Matrix<Rows, Cols> HalfMatrix<Rows, Cols>::toMatrix() const {
+	Matrix<Rows, Cols> result;
+	for( int i = 0; i < Rows * Cols; ++i ) {
+		result[i] = data_[i].toFloat();
+	}
+	return result;
+}
+
+template<int Rows, int Cols>
+Half const& HalfMatrix<Rows, Cols>::operator()( int r, int c ) const {
+	assert(r >= 0 && r < Rows && c >= 0 && c < Cols);
+	return data_[r * Cols + c];
+}
+
+template<int Rows, int Cols>
+Half& HalfMatrix<Rows, Cols>::operator()( int r, int c ) {
+	assert(r >= 0 && r < Rows && c >= 0 && c < Cols);
+	return data_[r * Cols + c];
+}
+
+void packHalf( const float* values, Half* halves, int count ) {
+	int i = 0;
+#if defined(HMATH_HALF_F16C)
+	for( ; i + 8 <= count; i += 8 ) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(halves + i), _mm256_cvtps_ph(_mm256_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT));
+	}
+#endif
+	for( ; i < count; ++i ) {
+		halves[i] = Half(values[i]);
+	}
+}
+
+void unpackHalf( const Half* halves, float* values, int count ) {
+	int i = 0;
+#if defined(HMATH_HALF_F16C)
+	for( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps(values + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(halves + i))));
+	}
+#endif
+	for( ; i < count; ++i ) {
+		values[i] = halves[i].toFloat();
+	}
+}
+
+template<int N>
+void packHalf( const Vector<N>* vectors, HalfVector<N>* halves, int count ) {
+	static_assert(sizeof(Vector<N>) == N * sizeof(float) && sizeof(HalfVector<N>) == N * sizeof(Half), "vectors must be tightly packed");
+	if( count > 0 ) {
+		packHalf(&vectors[0][0], &halves[0][0], N * count);
+	}
+}
+
+template<int N>
+void unpackHalf( const HalfVector<N>* halves, Vector<N>* vectors, int count ) {
+	static_assert(sizeof(Vector<N>) == N * sizeof(float) && sizeof(HalfVector<N>) == N * sizeof(Half), "vectors must be tightly packed");
+	if( count > 0 ) {
+		unpackHalf(&halves[0][0], &vectors[0][0], N * count);
+	}
+}
+
+template<int Rows, int Cols>
+void packHalf( const Matrix<Rows, Cols>* matrices, HalfMatrix<Rows, Cols>* halves, int count ) {
+	static_assert(sizeof(Matrix<Rows, Cols>) == Rows * Cols * sizeof(float) && sizeof(HalfMatrix<Rows, Cols>) == Rows * Cols * sizeof(Half), "matrices must be tightly packed");
+	if( count > 0 ) {
+		packHalf(&matrices[0][0], &halves[0](0, 0), Rows * Cols * count);
+	}
+}
+
+template<int Rows, int Cols>
+void unpackHalf( const HalfMatrix<Rows, Cols>* halves, Matrix<Rows, Cols>* matrices, int count ) {
+	static_assert(sizeof(Matrix<Rows, Cols>) == Rows * Cols * sizeof(float) && sizeof(HalfMatrix<Rows, Cols>) == Rows * Cols * sizeof(Half), "matrices must be tightly packed");
+	if( count > 0 ) {
+		unpackHalf(&halves[0](0, 0), &matrices[0][0], Rows * Cols * count);
+	}
+}
+
+template<int N>
+void dot( const HalfVector<N>* vectors, int count, const Vector<N>& direction, float* results ) {
+	using simd::Float;
+	const int W = SimdWidth;
+	for( int i = 0; i < count; i += W ) {
+		const int n = std::min(count - i, W);
+		float soa[N * W];
+		detail::unpackHalfBlock(vectors + i, n, soa);
+		Float sum = Float::load(soa) * Float(direction[0]);
+		for( int k = 1; k < N; ++k ) {
+			sum += Float::load(soa + k*W) * Float(direction[k]);
+		}
+		float lanes[W];
+		sum.store(lanes);
+		std::copy(lanes, lanes + n, results + i);
+	}
+}
+
+template<int N>
+void dot( const HalfVector<N>* a, const HalfVector<N>* b, int count, float* results ) {
+	using simd::Float;
+	const int W = SimdWidth;
+	for( int i = 0; i < count; i += W ) {
+		const int n = std::min(count - i, W);
+		float soaA[N * W], soaB[N * W];
+		detail::unpackHalfBlock(a + i, n, soaA);
+		detail::unpackHalfBlock(b + i, n, soaB);
+		Float sum = Float::load(soaA) * Float::load(soaB);
+		for( int k = 1; k < N; ++k ) {
+			sum += Float::load(soaA + k*W) * Float::load(soaB + k*W);
+		}
+		float lanes[W];
+		sum.store(lanes);
+		std::copy(lanes, lanes + n, results + i);
+	}
+}
+
+void transformPoints( const HalfVector<3>* points, int count, const Matrix4x4& M, Vector3* results ) {
+	using simd::Float;
+	const int W = SimdWidth;
+	for( int i = 0; i < count; i += W ) {
+		const int n = std::min(count - i, W);
+		float soa[3 * W];
+		detail::unpackHalfBlock(points + i, n, soa);
+		const Float x = Float::load(soa), y = Float::load(soa + W), z = Float::load(soa + 2*W);
+		float transformed[3 * W];
+		for( int c = 0; c < 3; ++c ) {
+			const Float value = x * Float(M(0, c)) + y * Float(M(1, c)) + z * Float(M(2, c)) + Float(M(3, c));
+			value.store(transformed + c*W);
+		}
+		simd::storeTransposed(transformed, 3, n, &results[i][0]);
+	}
+}
+
+template<int N>
+bool bounds( const HalfVector<N>* points, int count, Vector<N>& boxMin, Vector<N>& boxMax ) {
+	using simd::Float;
+	const int W = SimdWidth;
+	if( count <= 0 ) {
+		return false;
+	}
+
+	float soa[N * W];
+	detail::unpackHalfBlock(points, std::min(count, W), soa);
+	Float lo[N], hi[N];
+	for( int k = 0; k < N; ++k ) {
+		lo[k] = hi[k] = Float::load(soa + k*W);
+	}
+	for( int i = W; i < count; i += W ) {
+		detail::unpackHalfBlock(points + i, std::min(count - i, W), soa);
+		for( int k = 0; k < N; ++k ) {
+			const Float value = Float::load(soa + k*W);
+			lo[k] = simd::minimum(lo[k], value);
+			hi[k] = simd::maximum(hi[k], value);
+		}
+	}
+
+	for( int k = 0; k < N; ++k ) {
+		float loLanes[W], hiLanes[W];
+		lo[k].store(loLanes);
+		hi[k].store(hiLanes);
+		boxMin[k] = *std::min_element(loLanes, loLanes + W);
+		boxMax[k] = *std::max_element(hiLanes, hiLanes + W);
+	}
+	return true;
+}
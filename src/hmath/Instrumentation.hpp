@@ -0,0 +1,158 @@
+#ifndef __hmath_Instrumentation__
+#define __hmath_Instrumentation__
+
+#include <cstdint>
+#include "Aligned.hpp"
+
+#if defined(HMATH_INSTRUMENTATION)
+#include "ThreadRegistry.hpp"
+#endif
+
+/**
+ * Optional event counters for hmath's hot paths.
+ *
+ * Define HMATH_INSTRUMENTATION (identically in every translation unit) to enable them.  Each thread increments its own
+ * cache-line-padded block of counters without synchronization; instrumentationSnapshot aggregates all threads for
+ * export.  When the option is not defined the counting macros expand to nothing, and snapshots are always zero.
+ */
+#if defined(HMATH_INSTRUMENTATION)
+	#define HMATH_COUNT(counter) ::hm::detail::countEvent(::hm::Counter::counter, 1)
+	#define HMATH_COUNT_N(counter, n) ::hm::detail::countEvent(::hm::Counter::counter, (n))
+	#define HMATH_COUNT_MATRIX_SIZE(n) ::hm::detail::countMatrixSize(n)
+#else
+	#define HMATH_COUNT(counter) ((void)0)
+	#define HMATH_COUNT_N(counter, n) ((void)0)
+	#define HMATH_COUNT_MATRIX_SIZE(n) ((void)0)
+#endif
+
+namespace hm {
+
+enum class Counter : int {
+	GaussianEliminationCalls,    // calls to the generic GaussianElimination solver
+	GaussianEliminationSingular, // of which the matrix was singular
+	InverseCalls,                // matrices inverted by any inverse overload
+	InverseNotInvertible,        // of which the matrix was not invertible
+	NormalizeCalls,              // calls to normalize and normalizeRobust
+	NormalizeZeroLength,         // of which the vector had zero length
+
+	NumCounters
+};
+
+const static int NumCounters = static_cast<int>(Counter::NumCounters);
+
+/* Matrix sizes seen by GaussianElimination are bucketed by row count; the last bucket holds all larger sizes. */
+const static int MaxCountedMatrixSize = 16;
+
+struct InstrumentationSnapshot {
+	std::uint64_t counters[NumCounters];
+	std::uint64_t matrixSizes[MaxCountedMatrixSize + 1];
+
+	InstrumentationSnapshot() {
+		for( auto& value : counters ) {
+			value = 0;
+		}
+		for( auto& value : matrixSizes ) {
+			value = 0;
+		}
+	}
+
+	std::uint64_t operator[]( Counter counter ) const {
+		return counters[static_cast<int>(counter)];
+	}
+};
+
+/**
+ * Returns a stable name for a counter, suitable as a metric key.
+ *
+ * @param counter Counter to name.
+ */
+inline const char* counterName( Counter counter ) {
+	switch( counter ) {
+		case Counter::GaussianEliminationCalls: return "gaussian_elimination.calls";
+		case Counter::GaussianEliminationSingular: return "gaussian_elimination.singular";
+		case Counter::InverseCalls: return "inverse.calls";
+		case Counter::InverseNotInvertible: return "inverse.not_invertible";
+		case Counter::NormalizeCalls: return "normalize.calls";
+		case Counter::NormalizeZeroLength: return "normalize.zero_length";
+		default: return "unknown";
+	}
+}
+
+/**
+ * Difference between two snapshots, e.g. the events of one frame.
+ */
+inline InstrumentationSnapshot operator-( const InstrumentationSnapshot& later, const InstrumentationSnapshot& earlier ) {
+	InstrumentationSnapshot result;
+	for( int i = 0; i < NumCounters; ++i ) {
+		result.counters[i] = later.counters[i] - earlier.counters[i];
+	}
+	for( int i = 0; i <= MaxCountedMatrixSize; ++i ) {
+		result.matrixSizes[i] = later.matrixSizes[i] - earlier.matrixSizes[i];
+	}
+	return result;
+}
+
+#if defined(HMATH_INSTRUMENTATION)
+namespace detail {
+
+struct alignas(CacheLineSize) CounterBlock {
+	ThreadCount counters[NumCounters];
+	ThreadCount matrixSizes[MaxCountedMatrixSize + 1];
+
+	void reset() {
+		for( auto& count : counters ) {
+			count.reset();
+		}
+		for( auto& count : matrixSizes ) {
+			count.reset();
+		}
+	}
+
+	void addTo( InstrumentationSnapshot& snapshot ) const {
+		for( int i = 0; i < NumCounters; ++i ) {
+			snapshot.counters[i] += counters[i].read();
+		}
+		for( int i = 0; i <= MaxCountedMatrixSize; ++i ) {
+			snapshot.matrixSizes[i] += matrixSizes[i].read();
+		}
+	}
+};
+
+using CounterRegistry = ThreadRegistry<CounterBlock, InstrumentationSnapshot>;
+
+inline void countEvent( Counter counter, std::uint64_t n ) {
+	CounterRegistry::local().counters[static_cast<int>(counter)].add(n);
+}
+
+inline void countMatrixSize( int numRows ) {
+	const int bucket = (numRows < MaxCountedMatrixSize) ? numRows : MaxCountedMatrixSize;
+	CounterRegistry::local().matrixSizes[bucket > 0 ? bucket : 0].add(1);
+}
+
+}
+#endif
+
+/**
+ * Returns the counters summed over all threads, including threads that have exited.
+ */
+inline InstrumentationSnapshot instrumentationSnapshot() {
+#if defined(HMATH_INSTRUMENTATION)
+	return detail::CounterRegistry::instance().snapshot();
+#else
+	return InstrumentationSnapshot();
+#endif
+}
+
+/**
+ * Resets the counters of all threads to zero.  An event racing with the reset is either counted before or after it;
+ * the counters never return to their values before the reset.
+ */
+inline void resetInstrumentation() {
+#if defined(HMATH_INSTRUMENTATION)
+	detail::CounterRegistry::instance().reset();
+#endif
+}
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef __hmath_KdTree__
+#define __hmath_KdTree__
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "Parallel.hpp"
+#include "Vector.hpp"
+
+namespace hm {
+
+/**
+ * kd-tree over an array of Vector<N> for nearest neighbor and radius queries.
+ *
+ * The tree is implicit: points are stored in tree order, and the subtree covering the range [lo, hi) has its splitting
+ * point at the middle of the range, with the left and right subtrees on either side of it.  The only per-node data is
+ * the splitting dimension, so there are no pointers and the tree is three flat arrays: the points, their original
+ * indices and the splitting dimensions.  Results always refer to indices of the array the tree was built from.
+ */
+template<int N>
+class KdTree {
+public:
+	KdTree();
+
+	/**
+	 * Builds the tree, replacing any previous contents.  Points are copied.
+	 *
+	 * @param points     Input points.
+	 * @param count      Number of points.
+	 * @param numThreads Number of threads; 0 uses all threads of the task executor.
+	 */
+	void build( const Vector<N>* points, int count, int numThreads=0 );
+
+	int size() const;
+
+	/**
+	 * Finds the k nearest points to a query point.
+	 *
+	 * With a nonzero epsilon the search is approximate: every returned distance is within a factor of (1 + epsilon) of
+	 * the true k-th nearest distance, and far fewer nodes are visited.
+	 *
+	 * @param query        Query point.
+	 * @param k            Maximum number of points to find.
+	 * @param indices      Receives the indices of the points found, nearest first.  Must hold k values.
+	 * @param sqrDistances If not null, receives the squared distances of the points found.  Must hold k values.
+	 * @param epsilon      Approximation factor; 0 for an exact search.
+	 * @return Number of points found, which is k unless the tree holds fewer points.
+	 */
+	int nearest( const Vector<N>& query, int k, int* indices, float* sqrDistances=nullptr, float epsilon=0.0f ) const;
+
+	/**
+	 * Finds the k nearest points to each of many query points, splitting the queries across threads.
+	 *
+	 * Results of query q are written at offset q*k.  Unused slots, when the tree holds fewer than k points, are set to
+	 * an index of -1 and an infinite distance.
+	 *
+	 * @param queries      Query points.
+	 * @param numQueries   Number of query points.
+	 * @param k            Number of points to find per query.
+	 * @param indices      Receives numQueries*k indices.
+	 * @param sqrDistances If not null, receives numQueries*k squared distances.
+	 * @param epsilon      Approximation factor; 0 for an exact search.
+	 * @param numThreads   Number of threads; 0 uses all threads of the task executor.
+	 */
+	void nearest( const Vector<N>* queries, int numQueries, int k, int* indices, float* sqrDistances=nullptr, float epsilon=0.0f, int numThreads=0 ) const;
+
+	/**
+	 * Finds all points within a radius of a query point, in no particular order.
+	 *
+	 * @param query        Query point.
+	 * @param radius       Search radius.
+	 * @param indices      Found indices are appended to this.
+	 * @param sqrDistances If not null, the squared distances are appended to this.
+	 * @return Number of points found.
+	 */
+	int withinRadius( const Vector<N>& query, float radius, std::vector<int>& indices, std::vector<float>* sqrDistances=nullptr ) const;
+
+private:
+	struct Entry {
+		Vector<N> point;
+		int index;
+	};
+
+	struct Range {
+		int lo, hi;
+	};
+
+	// subtrees with at most this many points are scanned linearly
+	static const int LeafSize = 8;
+	// levels of nodes with fewer points than this are not split in parallel
+	static const int MinParallelBuild = 1 << 14;
+	// number of queries per task of the batch nearest search
+	static const int QueryGrainSize = 32;
+	static const int MaxDepth = 64;
+
+	// builds the subtree of [lo, hi) on the calling thread
+	void buildRange( Entry* entries, int lo, int hi );
+	// partitions [lo, hi) around its splitting point and returns the index of that point
+	int splitRange( Entry* entries, int lo, int hi );
+
+	AlignedArray<Vector<N>> points_;
+	std::vector<int> indices_;
+	std::vector<unsigned char> splitDims_;
+};
+
+#include "KdTree.inl"
+
+}
+
+#endif
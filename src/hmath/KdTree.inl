@@ -0,0 +1,272 @@
+namespace detail {
+
+// sift helpers for the bounded max-heap of k-nearest candidates, stored as parallel distance/index arrays
+inline void kdHeapSiftUp( float* dist, int* index, int i ) {
+	while( i > 0 ) {
+		const int parent = (i - 1) / 2;
+		if( dist[parent] >= dist[i] ) {
+			break;
+		}
+		std::swap(dist[parent], dist[i]);
+		std::swap(index[parent], index[i]);
+		i = parent;
+	}
+}
+
+inline void kdHeapSiftDown( float* dist, int* index, int i, int count ) {
+	for( ;; ) {
+		const int left = 2 * i + 1;
+		const int right = left + 1;
+		int largest = i;
+		if( left < count && dist[left] > dist[largest] ) {
+			largest = left;
+		}
+		if( right < count && dist[right] > dist[largest] ) {
+			largest = right;
+		}
+		if( largest == i ) {
+			break;
+		}
+		std::swap(dist[largest], dist[i]);
+		std::swap(index[largest], index[i]);
+		i = largest;
+	}
+}
+
+}
+
+template<int N>
+KdTree<N>::KdTree() {
+}
+
+template<int N>
+void KdTree<N>::build( const Vector<N>* points, int count, int numThreads ) {
+	numThreads = detail::resolveThreadCount(numThreads);
+	count = std::max(count, 0);
+
+	AlignedArray<Entry> entries(count);
+	for( int i = 0; i < count; ++i ) {
+		entries[i].point = points[i];
+		entries[i].index = i;
+	}
+	splitDims_.assign(count, 0);
+
+	// split the top levels one level at a time, each node of a level being a separate task, until there are enough
+	// subtrees to keep all threads busy; then build each subtree as one task
+	Entry* const data = entries.data();
+	std::vector<Range> level(1, Range{0, count});
+	std::vector<Range> next;
+	while( numThreads > 1 && static_cast<int>(level.size()) < 4 * numThreads && level[0].hi - level[0].lo >= MinParallelBuild ) {
+		next.resize(2 * level.size());
+		parallelFor(0, static_cast<int>(level.size()), 1, [&]( int begin, int end ) {
+			for( int i = begin; i < end; ++i ) {
+				const int mid = splitRange(data, level[i].lo, level[i].hi);
+				next[2 * i] = Range{level[i].lo, mid};
+				next[2 * i + 1] = Range{mid + 1, level[i].hi};
+			}
+		}, numThreads);
+		level.swap(next);
+	}
+	parallelFor(0, static_cast<int>(level.size()), 1, [&]( int begin, int end ) {
+		for( int i = begin; i < end; ++i ) {
+			buildRange(data, level[i].lo, level[i].hi);
+		}
+	}, numThreads);
+
+	points_.resize(count);
+	indices_.resize(count);
+	for( int i = 0; i < count; ++i ) {
+		points_[i] = entries[i].point;
+		indices_[i] = entries[i].index;
+	}
+}
+
+template<int N>
+void KdTree<N>::buildRange( Entry* entries, int lo, int hi ) {
+	if( hi - lo <= LeafSize ) {
+		return;
+	}
+	const int mid = splitRange(entries, lo, hi);
+	buildRange(entries, lo, mid);
+	buildRange(entries, mid + 1, hi);
+}
+
+template<int N>
+int KdTree<N>::splitRange( Entry* entries, int lo, int hi ) {
+	// split along the dimension of largest extent
+	Vector<N> minPoint = entries[lo].point;
+	Vector<N> maxPoint = entries[lo].point;
+	for( int i = lo + 1; i < hi; ++i ) {
+		minPoint = minimum(minPoint, entries[i].point);
+		maxPoint = maximum(maxPoint, entries[i].point);
+	}
+	int dim = 0;
+	for( int d = 1; d < N; ++d ) {
+		if( maxPoint[d] - minPoint[d] > maxPoint[dim] - minPoint[dim] ) {
+			dim = d;
+		}
+	}
+
+	const int mid = lo + (hi - lo) / 2;
+	std::nth_element(entries + lo, entries + mid, entries + hi, [dim]( const Entry& a, const Entry& b ) {
+		return a.point[dim] < b.point[dim];
+	});
+	splitDims_[mid] = static_cast<unsigned char>(dim);
+	return mid;
+}
+
+template<int N>
+int KdTree<N>::size() const {
+	return static_cast<int>(points_.size());
+}
+
+template<int N>
+int KdTree<N>::nearest( const Vector<N>& query, int k, int* indices, float* sqrDistances, float epsilon ) const {
+	const int n = size();
+	k = std::min(k, n);
+	if( k <= 0 ) {
+		return 0;
+	}
+
+	float localDist[64];
+	std::vector<float> heapDist;
+	float* dist = sqrDistances;
+	if( !dist ) {
+		if( k <= 64 ) {
+			dist = localDist;
+		} else {
+			heapDist.resize(k);
+			dist = heapDist.data();
+		}
+	}
+
+	// a subtree is skipped once its distance bound, scaled by (1 + epsilon)^2, cannot beat the current k-th candidate
+	const float pruneScale = (1.0f + epsilon) * (1.0f + epsilon);
+	int found = 0;
+	auto offer = [&]( int i ) {
+		const float d2 = sqrDistance(query, points_[i]);
+		if( found < k ) {
+			dist[found] = d2;
+			indices[found] = i;
+			detail::kdHeapSiftUp(dist, indices, found++);
+		} else if( d2 < dist[0] ) {
+			dist[0] = d2;
+			indices[0] = i;
+			detail::kdHeapSiftDown(dist, indices, 0, found);
+		}
+	};
+
+	struct Pending {
+		int lo, hi;
+		float bound;
+	};
+	Pending stack[2 * MaxDepth];
+	int top = 0;
+	stack[top++] = Pending{0, n, 0.0f};
+	while( top > 0 ) {
+		const Pending node = stack[--top];
+		if( found == k && node.bound * pruneScale >= dist[0] ) {
+			continue;
+		}
+
+		if( node.hi - node.lo <= LeafSize ) {
+			for( int i = node.lo; i < node.hi; ++i ) {
+				offer(i);
+			}
+			continue;
+		}
+
+		const int mid = node.lo + (node.hi - node.lo) / 2;
+		const int dim = splitDims_[mid];
+		offer(mid);
+
+		// visit the side containing the query first
+		const float diff = query[dim] - points_[mid][dim];
+		const Pending left = {node.lo, mid, node.bound};
+		const Pending right = {mid + 1, node.hi, node.bound};
+		Pending nearSide = (diff < 0.0f) ? left : right;
+		Pending farSide = (diff < 0.0f) ? right : left;
+		farSide.bound = std::max(node.bound, diff * diff);
+		stack[top++] = farSide;
+		stack[top++] = nearSide;
+	}
+
+	// heap sort into ascending distance and map back to the caller's indices
+	for( int end = found - 1; end > 0; --end ) {
+		std::swap(dist[0], dist[end]);
+		std::swap(indices[0], indices[end]);
+		detail::kdHeapSiftDown(dist, indices, 0, end);
+	}
+	for( int i = 0; i < found; ++i ) {
+		indices[i] = indices_[indices[i]];
+	}
+	return found;
+}
+
+template<int N>
+void KdTree<N>::nearest( const Vector<N>* queries, int numQueries, int k, int* indices, float* sqrDistances, float epsilon, int numThreads ) const {
+	if( numQueries <= 0 || k <= 0 ) {
+		return;
+	}
+
+	// queries vary widely in cost, so they are handed out in small ranges that idle threads can steal
+	parallelFor(0, numQueries, QueryGrainSize, [=]( int begin, int end ) {
+		for( int q = begin; q < end; ++q ) {
+			int* queryIndices = indices + static_cast<size_t>(q) * k;
+			float* queryDist = sqrDistances ? sqrDistances + static_cast<size_t>(q) * k : nullptr;
+			const int found = nearest(queries[q], k, queryIndices, queryDist, epsilon);
+			for( int i = found; i < k; ++i ) {
+				queryIndices[i] = -1;
+				if( queryDist ) {
+					queryDist[i] = std::numeric_limits<float>::infinity();
+				}
+			}
+		}
+	}, numThreads);
+}
+
+template<int N>
+int KdTree<N>::withinRadius( const Vector<N>& query, float radius, std::vector<int>& indices, std::vector<float>* sqrDistances ) const {
+	const int n = size();
+	const float sqrRadius = radius * radius;
+	int found = 0;
+	auto offer = [&]( int i ) {
+		const float d2 = sqrDistance(query, points_[i]);
+		if( d2 <= sqrRadius ) {
+			indices.push_back(indices_[i]);
+			if( sqrDistances ) {
+				sqrDistances->push_back(d2);
+			}
+			++found;
+		}
+	};
+
+	struct Pending {
+		int lo, hi;
+	};
+	Pending stack[2 * MaxDepth];
+	int top = 0;
+	stack[top++] = Pending{0, n};
+	while( top > 0 ) {
+		const Pending node = stack[--top];
+		if( node.hi - node.lo <= LeafSize ) {
+			for( int i = node.lo; i < node.hi; ++i ) {
+				offer(i);
+			}
+			continue;
+		}
+
+		const int mid = node.lo + (node.hi - node.lo) / 2;
+		const int dim = splitDims_[mid];
+		offer(mid);
+
+		const float diff = query[dim] - points_[mid][dim];
+		if( diff <= radius ) {
+			stack[top++] = Pending{node.lo, mid};
+		}
+		if( diff >= -radius ) {
+			stack[top++] = Pending{mid + 1, node.hi};
+		}
+	}
+	return found;
+}
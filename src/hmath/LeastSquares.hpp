@@ -0,0 +1,121 @@
+#ifndef __hmath_LeastSquares__
+#define __hmath_LeastSquares__
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "Parallel.hpp"
+#include "Tracing.hpp"
+
+namespace hm {
+
+/**
+ * Streaming least-squares solver for overdetermined systems A x = b, by Householder QR.
+ *
+ * Rows are added one at a time or in arrays and are never stored beyond a small block.  Only the triangular factor R
+ * of the augmented matrix [A | b] is kept, so memory stays at O(numUnknowns^2) however many rows are added, and A^T A
+ * is never formed: its condition number is the square of that of A, which in float loses all accuracy well before
+ * QR does.
+ *
+ * Added rows are buffered, and each full block is stacked under R and reduced with one Householder reflector per
+ * column.  The reflectors only touch the diagonal of R and the block, and are applied to the block a row at a time,
+ * so every pass reads memory contiguously.  Two solvers fed with different rows can be merged, which reduces their
+ * stacked factors the same way: this is the tall-skinny QR (TSQR) that solveLeastSquares runs over threads.
+ *
+ * The buffered rows are reduced lazily, so the const accessors, and merging from a solver, are non-reentrant: a solver
+ * must not be read from several threads while rows are pending.  Calling factor() once after adding rows makes it safe
+ * to share.
+ */
+class LeastSquaresQR {
+public:
+	/**
+	 * @param numUnknowns Number of columns of A.
+	 * @param blockRows   Number of rows reduced at once.
+	 */
+	explicit LeastSquaresQR( int numUnknowns=0, int blockRows=64 );
+
+	// discards all rows
+	void reset();
+
+	int numUnknowns() const;
+	std::int64_t numRows() const;
+
+	/**
+	 * Adds the equation a . x = b.
+	 *
+	 * @param a numUnknowns() coefficients.
+	 * @param b Right-hand side.
+	 */
+	void addRow( const float* a, float b );
+
+	/**
+	 * Adds the equations A x = b.
+	 *
+	 * @param A     count rows of numUnknowns() coefficients each.
+	 * @param b     count right-hand sides.
+	 * @param count Number of rows.
+	 */
+	void addRows( const float* A, const float* b, int count );
+
+	/**
+	 * Adds all rows of another solver with the same number of unknowns, as if they had been added to this one.
+	 *
+	 * @param other Solver to merge.
+	 */
+	void merge( const LeastSquaresQR& other );
+
+	/**
+	 * Computes the x minimizing |A x - b|.
+	 *
+	 * @param x Receives numUnknowns() values, zero if A does not have full column rank.
+	 * @return Whether or not A has full column rank.
+	 */
+	bool solve( float* x ) const;
+
+	// |A x - b|^2 for the x returned by solve
+	float residualSumOfSquares() const;
+
+	// the upper triangular R of the augmented [A | b], as (numUnknowns() + 1)^2 row-major floats
+	const float* factor() const;
+
+private:
+	// buffers a row of the augmented matrix, reducing the block once full
+	void append( const float* a, float b );
+	// reduces the buffered rows into R
+	void reduce() const;
+
+	int numUnknowns_;
+	int numCols_;
+	int blockRows_;
+	std::int64_t numRows_;
+	// reduction is deferred until a block is full or the factor is read
+	mutable std::vector<float> r_;
+	mutable std::vector<float> block_;
+	mutable int pending_;
+};
+
+/**
+ * Solves the overdetermined system A x = b in the least-squares sense on several threads (tall-skinny QR).
+ *
+ * The rows are split into ranges of a fixed size, each reduced to its own R by a LeastSquaresQR, and the factors are
+ * merged in order, so the result does not depend on the number of threads.
+ *
+ * @param A            numRows rows of numUnknowns coefficients each.
+ * @param b            numRows right-hand sides.
+ * @param numRows      Number of rows.
+ * @param numUnknowns  Number of columns of A.
+ * @param x            Receives numUnknowns values, zero if A does not have full column rank.
+ * @param residual     If not null, receives |A x - b|^2.
+ * @param numThreads   Number of threads; 0 uses all threads of the task executor.
+ * @return Whether or not A has full column rank.
+ */
+inline bool solveLeastSquares( const float* A, const float* b, int numRows, int numUnknowns, float* x, float* residual=nullptr, int numThreads=0 );
+
+#include "LeastSquares.inl"
+
+}
+
+#endif
@@ -0,0 +1,170 @@
+namespace detail {
+
+// rows per task of solveLeastSquares; fixed so that results do not depend on the number of threads
+static const int LeastSquaresRowsPerTask = 1 << 14;
+
+}
+
+inline LeastSquaresQR::LeastSquaresQR( int numUnknowns, int blockRows )
+	: numUnknowns_(std::max(numUnknowns, 0)), numCols_(numUnknowns_ + 1), blockRows_(std::max(blockRows, 1)), numRows_(0),
+	  r_(numCols_ * numCols_, 0.0f), block_(numCols_ * blockRows_), pending_(0) {
+}
+
+inline void LeastSquaresQR::reset() {
+	std::fill(r_.begin(), r_.end(), 0.0f);
+	numRows_ = 0;
+	pending_ = 0;
+}
+
+inline int LeastSquaresQR::numUnknowns() const {
+	return numUnknowns_;
+}
+
+inline std::int64_t LeastSquaresQR::numRows() const {
+	return numRows_;
+}
+
+inline void LeastSquaresQR::addRow( const float* a, float b ) {
+	append(a, b);
+	++numRows_;
+}
+
+inline void LeastSquaresQR::addRows( const float* A, const float* b, int count ) {
+	for( int i = 0; i < count; ++i ) {
+		addRow(A + static_cast<size_t>(i) * numUnknowns_, b[i]);
+	}
+}
+
+inline void LeastSquaresQR::merge( const LeastSquaresQR& other ) {
+	assert(other.numUnknowns_ == numUnknowns_);
+	const int n = numCols_;
+	// the rows of R stand for all rows of other, whose Q is orthogonal; copied in case other is this solver
+	const std::vector<float> R(other.factor(), other.factor() + n * n);
+	for( int r = 0; r < n; ++r ) {
+		const float* row = &R[r * n];
+		if( std::any_of(row + r, row + n, []( float value ) { return value != 0.0f; }) ) {
+			append(row, row[n - 1]);
+		}
+	}
+	numRows_ += other.numRows_;
+}
+
+inline bool LeastSquaresQR::solve( float* x ) const {
+	const int k = numUnknowns_;
+	const int n = numCols_;
+	const float* R = factor();
+
+	// columns whose diagonal is negligible next to the largest are linearly dependent on the others
+	float largest = 0.0f;
+	for( int j = 0; j < k; ++j ) {
+		largest = std::max(largest, std::fabs(R[j * n + j]));
+	}
+	const float tolerance = largest * static_cast<float>(k) * std::numeric_limits<float>::epsilon();
+	for( int j = 0; j < k; ++j ) {
+		if( !(std::fabs(R[j * n + j]) > tolerance) ) {
+			std::fill(x, x + k, 0.0f);
+			return false;
+		}
+	}
+
+	// R x = Q^T b, which is the last column of the augmented R
+	for( int j = k - 1; j >= 0; --j ) {
+		const float* row = R + j * n;
+		float s = row[k];
+		for( int c = j + 1; c < k; ++c ) {
+			s -= row[c] * x[c];
+		}
+		x[j] = s / row[j];
+	}
+	return true;
+}
+
+inline float LeastSquaresQR::residualSumOfSquares() const {
+	const float* R = factor();
+	const float last = R[numCols_ * numCols_ - 1];
+	return last * last;
+}
+
+inline const float* LeastSquaresQR::factor() const {
+	reduce();
+	return r_.data();
+}
+
+inline void LeastSquaresQR::append( const float* a, float b ) {
+	// the block is stored by columns, so that the reflectors run along contiguous memory
+	float* row = &block_[pending_];
+	for( int c = 0; c < numUnknowns_; ++c ) {
+		row[c * blockRows_] = a[c];
+	}
+	row[numUnknowns_ * blockRows_] = b;
+	if( ++pending_ == blockRows_ ) {
+		reduce();
+	}
+}
+
+inline void LeastSquaresQR::reduce() const {
+	const int n = numCols_;
+	const int m = pending_;
+	if( m == 0 ) {
+		return;
+	}
+
+	// One reflector per column j zeroes column j of the block against the diagonal of R.  Its vector is 1 at row j of
+	// R and u in the block, and is zero on the other rows of R, which are left untouched.
+	float* R = r_.data();
+	for( int j = 0; j < n; ++j ) {
+		float* u = &block_[j * blockRows_];
+		float sigma = 0.0f;
+		for( int i = 0; i < m; ++i ) {
+			sigma += u[i] * u[i];
+		}
+		if( sigma == 0.0f ) {
+			continue;
+		}
+
+		const float diagonal = R[j * n + j];
+		const float norm = std::sqrt(diagonal * diagonal + sigma);
+		const float beta = (diagonal >= 0.0f) ? -norm : norm;
+		const float tau = (beta - diagonal) / beta;
+		const float scale = 1.0f / (diagonal - beta);
+		R[j * n + j] = beta;
+		for( int i = 0; i < m; ++i ) {
+			u[i] *= scale;
+		}
+
+		for( int c = j + 1; c < n; ++c ) {
+			float* column = &block_[c * blockRows_];
+			float dot = R[j * n + c];
+			for( int i = 0; i < m; ++i ) {
+				dot += u[i] * column[i];
+			}
+			dot *= tau;
+			R[j * n + c] -= dot;
+			for( int i = 0; i < m; ++i ) {
+				column[i] -= dot * u[i];
+			}
+		}
+	}
+	pending_ = 0;
+}
+
+inline bool solveLeastSquares( const float* A, const float* b, int numRows, int numUnknowns, float* x, float* residual, int numThreads ) {
+	HMATH_TRACE_BATCH(LeastSquaresBatch, numUnknowns, numRows);
+	const LeastSquaresQR empty(numUnknowns);
+	const int rowsPerTask = detail::LeastSquaresRowsPerTask;
+	const LeastSquaresQR qr = parallelReduce(0, std::max(numRows, 0), rowsPerTask, empty, [=]( int first, int last ) {
+		LeastSquaresQR part(numUnknowns);
+		part.addRows(A + static_cast<size_t>(first) * numUnknowns, b + first, last - first);
+		// reduce the last block here rather than on the thread merging the parts
+		part.factor();
+		return part;
+	}, []( LeastSquaresQR merged, const LeastSquaresQR& part ) {
+		merged.merge(part);
+		return merged;
+	}, numThreads);
+
+	if( residual ) {
+		*residual = qr.residualSumOfSquares();
+	}
+	return qr.solve(x);
+}
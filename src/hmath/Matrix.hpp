@@ -4,14 +4,20 @@
 #include <array>
 #include <initializer_list>
 #include <cassert>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include "Aligned.hpp"
 #include "GaussianElimination.hpp"
+#include "Tracing.hpp"
+#include "Unroll.hpp"
 #include "Vector.hpp"
 #include "Vector4.hpp"
 
 namespace hm {
 
 template<int Rows, int Cols>
-class Matrix {
+class alignas(MatrixAlignment<Rows, Cols>::value) Matrix {
 public:
 	Matrix();
 	Matrix( const std::array<float, Rows*Cols>& values );
@@ -43,7 +49,7 @@ template<int N>
 inline float determinant( const Matrix<N, N>& M );
 
 template<int Rows, int Cols>
-inline Matrix<Rows, Cols> transpose( const Matrix<Rows, Cols>& M );
+inline Matrix<Cols, Rows> transpose( const Matrix<Rows, Cols>& M );
 
 // matrix * vector
 template<int Rows, int Cols>
@@ -53,16 +59,44 @@ Vector<Rows> operator*( const Matrix<Rows, Cols>& M, const Vector<Cols>& V );
 template<int Rows, int Cols>
 Vector<Cols> operator*( const Vector<Rows>& V, const Matrix<Rows, Cols>& M );
 
-// M*M
+// M*M, computed as the product BA so that A * B applies B first to row vectors; square matrices only
 template<int Rows, int Cols, int Common>
 Matrix<Rows, Cols> operator*( const Matrix<Rows, Common>& A, const Matrix<Common, Cols>& B );
 
+// the product AB, for any compatible shapes
 template<int Rows, int Cols, int Common>
 Matrix<Rows, Cols> multiplyAB( const Matrix<Rows, Common>& A, const Matrix<Common, Cols>& B );
 
+// the product BA; square matrices only
 template<int Rows, int Cols, int Common>
 Matrix<Rows, Cols> multiplyBA( const Matrix<Rows, Common>& A, const Matrix<Common, Cols>& B );
 
+/**
+ * Computes the products A[i] B[i] of arrays of matrices.
+ * 
+ * Each product is the unrolled multiplyAB, which compilers vectorize along the rows of the result.  Transposing
+ * matrices into SIMD lanes costs more than products this small save, so to spread independent products over
+ * SimdWidth lanes, keep the matrices in MatrixBlock form (see MatrixBlock.hpp).
+ * 
+ * @param A      Left-hand Matrices.
+ * @param B      Right-hand Matrices.
+ * @param result Output Matrices.  May be the same array as A or B if the shapes match.
+ * @param count  Number of products.
+ */
+template<int Rows, int Cols, int Common>
+inline void multiplyAB( const Matrix<Rows, Common>* A, const Matrix<Common, Cols>* B, Matrix<Rows, Cols>* result, int count );
+
+/**
+ * Computes the products A[i] * B[i] (that is, B[i] A[i]) of arrays of square matrices.  See the batch multiplyAB.
+ * 
+ * @param A      Left-hand Matrices.
+ * @param B      Right-hand Matrices.
+ * @param result Output Matrices.  May be the same array as A or B.
+ * @param count  Number of products.
+ */
+template<int N>
+inline void multiplyBA( const Matrix<N, N>* A, const Matrix<N, N>* B, Matrix<N, N>* result, int count );
+
 // insert N-by-N matrix into (N+1)-by-(N+1) with new entries at 0 except for the last row/col, which is 1
 template<int N>
 inline Matrix<N+1, N+1> lift( const Matrix<N, N>& M );
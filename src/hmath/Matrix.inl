@@ -125,11 +125,105 @@ Matrix<Rows, Cols> Matrix<Rows, Cols>::identity() {
 }
 
 
+namespace detail {
+
+/**
+ * Gauss-Jordan elimination with partial pivoting on a fixed-size matrix held on the stack.  All loops over columns are
+ * unrolled, so only the pivot search and row swaps depend on the data.  Returns false, with a zero inverse and
+ * determinant, if a pivot is exactly zero.
+ */
+template<int N>
+inline bool invertFixed( const Matrix<N, N>& M, Matrix<N, N>* inverse, float& determinant ) {
+	float a[N][N], b[N][N];
+	unroll<N>([&]( auto r ) {
+		unroll<N>([&]( auto c ) {
+			a[r][c] = M(r, c);
+			b[r][c] = (r == c) ? 1.0f : 0.0f;
+		});
+	});
+
+	determinant = 1.0f;
+	for( int k = 0; k < N; ++k ) {
+		int pivot = k;
+		float maxValue = std::fabs(a[k][k]);
+		for( int r = k + 1; r < N; ++r ) {
+			const float value = std::fabs(a[r][k]);
+			if( value > maxValue ) {
+				maxValue = value;
+				pivot = r;
+			}
+		}
+		if( maxValue == 0.0f ) {
+			determinant = 0.0f;
+			if( inverse ) {
+				inverse->makeZero();
+			}
+			return false;
+		}
+		if( pivot != k ) {
+			determinant = -determinant;
+			unroll<N>([&]( auto c ) {
+				std::swap(a[pivot][c], a[k][c]);
+				std::swap(b[pivot][c], b[k][c]);
+			});
+		}
+
+		const float diagonal = a[k][k];
+		determinant *= diagonal;
+		const float inv = 1.0f / diagonal;
+		unroll<N>([&]( auto c ) {
+			a[k][c] *= inv;
+			b[k][c] *= inv;
+		});
+		for( int r = 0; r < N; ++r ) {
+			if( r != k ) {
+				const float factor = a[r][k];
+				unroll<N>([&]( auto c ) {
+					a[r][c] -= factor * a[k][c];
+					b[r][c] -= factor * b[k][c];
+				});
+			}
+		}
+	}
+
+	if( inverse ) {
+		unroll<N>([&]( auto r ) {
+			unroll<N>([&]( auto c ) {
+				(*inverse)(r, c) = b[r][c];
+			});
+		});
+	}
+	return true;
+}
+
+template<int N>
+inline bool invert( const Matrix<N, N>& M, Matrix<N, N>* inverse, float& determinant, std::true_type ) {
+	return invertFixed(M, inverse, determinant);
+}
+
+template<int N>
+inline bool invert( const Matrix<N, N>& M, Matrix<N, N>* inverse, float& determinant, std::false_type ) {
+	return GaussianElimination()(N, &M[0], inverse ? &(*inverse)[0] : nullptr, determinant, nullptr, nullptr, nullptr, 0, nullptr);
+}
+
+// sizes up to 8x8 use the unrolled elimination, larger ones the general solver
+template<int N>
+inline bool invert( const Matrix<N, N>& M, Matrix<N, N>* inverse, float& determinant ) {
+	return invert(M, inverse, determinant, std::integral_constant<bool, (N <= 8)>());
+}
+
+}
+
 template<int N> 
 Matrix<N, N> inverse( const Matrix<N, N>& M, bool* canInverse ) {
+	HMATH_TRACE_SCOPE(Inverse, N);
+	HMATH_COUNT(InverseCalls);
 	Matrix<N, N> invM;
 	float determinant;
-	bool invertible = GaussianElimination()(N, &M[0], &invM[0], determinant, nullptr, nullptr, nullptr, 0, nullptr);
+	bool invertible = detail::invert(M, &invM, determinant);
+	if( !invertible ) {
+		HMATH_COUNT(InverseNotInvertible);
+	}
 	if( canInverse ) {
 		*canInverse = invertible;
 	}
@@ -139,42 +233,40 @@ Matrix<N, N> inverse( const Matrix<N, N>& M, bool* canInverse ) {
 template<int N>
 float determinant( const Matrix<N, N>& M ) {
 	float determinant;
-	GaussianElimination()(N, &M[0], nullptr, determinant, nullptr, nullptr, nullptr, 0, nullptr);
+	detail::invert(M, static_cast<Matrix<N, N>*>(nullptr), determinant);
 	return determinant;
 }
 
 template<int Rows, int Cols>
-Matrix<Rows, Cols> transpose( const Matrix<Rows, Cols>& M ) {
+Matrix<Cols, Rows> transpose( const Matrix<Rows, Cols>& M ) {
 	Matrix<Cols, Rows> result;
-	for( int r = 0; r < Rows; ++r ) {
-		for( int c = 0; c < Cols; ++c ) {
-			result(c, r) = M(r, c);
-		}
-	}
+	detail::unroll<Rows * Cols>([&]( auto e ) {
+		const int r = e / Cols;
+		const int c = e % Cols;
+		result(c, r) = M(r, c);
+	});
 	return result;
 }
 
 template<int Rows, int Cols>
 Vector<Rows> operator*( const Matrix<Rows, Cols>& M, const Vector<Cols>& V ) {
 	Vector<Rows> result;
-	for( int r = 0; r < Rows; ++r ) {
-		result[r] = 0.0f;
-		for( int c = 0; c < Cols; ++c ) {
-			result[r] += M(r, c) * V[c];
-		}
-	}
+	detail::unroll<Rows>([&]( auto r ) {
+		result[r] = detail::unrolledSum<Cols>([&]( auto c ) {
+			return M(r, c) * V[c];
+		});
+	});
 	return result;
 }
 
 template<int Rows, int Cols>
 Vector<Cols> operator*( const Vector<Rows>& V, const Matrix<Rows, Cols>& M ) {
 	Vector<Cols> result;
-	for( int c = 0; c < Cols; ++c ) {
-		result[c] = 0.0f;
-		for( int r = 0; r < Rows; ++r ) {
-			result[c] += V[r] * M(r, c);
-		}
-	}
+	detail::unroll<Cols>([&]( auto c ) {
+		result[c] = detail::unrolledSum<Rows>([&]( auto r ) {
+			return V[r] * M(r, c);
+		});
+	});
 	return result;
 }
 
@@ -186,29 +278,33 @@ Matrix<Rows, Cols> operator*( const Matrix<Rows, Common>& A, const Matrix<Common
 template<int Rows, int Cols, int Common>
 Matrix<Rows, Cols> multiplyAB( const Matrix<Rows, Common>& A, const Matrix<Common, Cols>& B ) {
 	Matrix<Rows, Cols> result;
-	for( int r = 0; r < Rows; ++r ) {
-		for( int c = 0; c < Cols; ++c ) {
-			result(r, c) = 0.0f;
-			for( int i = 0; i < Common; ++i ) {
-				result(r, c) += A(r, i) * B(i, c);
-			}
-		}
-	}
+	detail::unroll<Rows * Cols>([&]( auto e ) {
+		const int r = e / Cols;
+		const int c = e % Cols;
+		result(r, c) = detail::unrolledSum<Common>([&]( auto i ) {
+			return A(r, i) * B(i, c);
+		});
+	});
 	return result;
 }
 
 template<int Rows, int Cols, int Common>
 Matrix<Rows, Cols> multiplyBA( const Matrix<Rows, Common>& A, const Matrix<Common, Cols>& B ) {
-	Matrix<Rows, Cols> result;
-	for( int r = 0; r < Rows; ++r ) {
-		for( int c = 0; c < Cols; ++c ) {
-			result(r, c) = 0.0f;
-			for( int i = 0; i < Common; ++i ) {
-				result(r, c) += B(r, i) * A(i, c);
-			}
-		}
+	static_assert(Rows == Cols && Cols == Common, "multiplyBA and Matrix operator* need square matrices; use multiplyAB for other shapes.");
+	return multiplyAB(B, A);
+}
+
+template<int Rows, int Cols, int Common>
+void multiplyAB( const Matrix<Rows, Common>* A, const Matrix<Common, Cols>* B, Matrix<Rows, Cols>* result, int count ) {
+	HMATH_TRACE_BATCH(MultiplyBatch, Common, count);
+	for( int i = 0; i < count; ++i ) {
+		result[i] = multiplyAB(A[i], B[i]);
 	}
-	return result;
+}
+
+template<int N>
+void multiplyBA( const Matrix<N, N>* A, const Matrix<N, N>* B, Matrix<N, N>* result, int count ) {
+	multiplyAB(B, A, result, count);
 }
 
 template<int N>
@@ -12,6 +12,8 @@ float getRotationAngle( const Matrix2x2& rotation ) {
 }
 
 Matrix2x2 inverse( const Matrix2x2& M, bool* isInvertible ) {
+	HMATH_TRACE_SCOPE(Inverse, 2);
+	HMATH_COUNT(InverseCalls);
 	Matrix2x2 inv;
 	bool invertible;
 	const float det = M(0, 0)*M(1, 1) - M(0, 1)*M(1, 0);
@@ -23,6 +25,7 @@ Matrix2x2 inverse( const Matrix2x2& M, bool* isInvertible ) {
 		};
 		invertible = true;
 	} else {
+		HMATH_COUNT(InverseNotInvertible);
 		inv.makeZero();
 		invertible = false;
 	}
@@ -1,4 +1,6 @@
 Matrix3x3 inverse( const Matrix3x3& M, bool* isInvertible ) {
+	HMATH_TRACE_SCOPE(Inverse, 3);
+	HMATH_COUNT(InverseCalls);
 	Matrix3x3 inv;
 	bool invertible;
 	const float c00 = M(1, 1)*M(2, 2) - M(1, 2)*M(2, 1);
@@ -20,6 +22,7 @@ Matrix3x3 inverse( const Matrix3x3& M, bool* isInvertible ) {
 		};
 		invertible = true;
 	} else {
+		HMATH_COUNT(InverseNotInvertible);
 		inv.makeZero();
 		invertible = false;
 	}
@@ -2,6 +2,8 @@
 #define __hmath_Matrix4x4__
 
 #include "Matrix.hpp"
+#include "Matrix3x3.hpp"
+#include "Simd.hpp"
 #include "Vector3.hpp"
 
 namespace hm {
@@ -16,6 +18,19 @@ using Matrix4x4 = Matrix<4, 4>;
  */
 inline Matrix4x4 inverse( const Matrix4x4& M, bool* isInvertible=nullptr );
 
+/**
+ * Calculates the inverses of an array of Matrices.
+ * 
+ * Matrices are processed in blocks of SimdWidth, transposed into per-element lanes so that the cofactor expansion
+ * runs on all Matrices of a block at once.  Uses the same expansion as inverse, so results match it to within rounding.
+ * 
+ * @param M            Input Matrices.
+ * @param inv          Output Matrices.  May be the same array as M.
+ * @param isInvertible If not null, returns whether or not each input Matrix is invertible.
+ * @param count        Number of Matrices.
+ */
+inline void inverse( const Matrix4x4* M, Matrix4x4* inv, bool* isInvertible, int count );
+
 /**
  * Computes the determinant of the given Matrix.
  * 
@@ -23,6 +38,52 @@ inline Matrix4x4 inverse( const Matrix4x4& M, bool* isInvertible=nullptr );
  */
 inline float determinant( const Matrix4x4& M );
 
+/**
+ * Computes the Matrix that transforms normals by M, i.e. the inverse transpose of its upper 3x3 block.
+ * 
+ * The cofactor matrix of the 3x3 block is computed directly.  Normals are usually renormalized after transforming,
+ * in which case the division by the determinant can be skipped; the result is then only scaled by the sign of the
+ * determinant so that mirroring transforms still keep normals facing outward.
+ * 
+ * @param M                   Input Matrix.
+ * @param divideByDeterminant If true, the result is the exact inverse transpose (zero if the block is not invertible).
+ */
+inline Matrix3x3 normalMatrix( const Matrix4x4& M, bool divideByDeterminant=true );
+
+/**
+ * Computes the normal Matrices of an array of Matrices.  See normalMatrix.
+ * 
+ * @param M                   Input Matrices.
+ * @param normal              Output normal Matrices.
+ * @param count               Number of Matrices.
+ * @param divideByDeterminant If true, the results are the exact inverse transposes.
+ */
+inline void normalMatrix( const Matrix4x4* M, Matrix3x3* normal, int count, bool divideByDeterminant=true );
+
+/**
+ * Composes two affine transforms stored as 4x3 matrices: a 3x3 linear part over a translation row, which is a
+ * Matrix4x4 without its constant last column of (0, 0, 0, 1).  The result is the same as A * B on the full 4x4
+ * matrices, so B is applied first.
+ * 
+ * @param A Transform applied second.
+ * @param B Transform applied first.
+ */
+inline Matrix<4, 3> multiplyAffine( const Matrix<4, 3>& A, const Matrix<4, 3>& B );
+
+/**
+ * Composes arrays of affine transforms.  See multiplyAffine, and MatrixBlock.hpp for the SIMD lane form.
+ * 
+ * Each product is the scalar multiplyAffine.  Unlike the general products, with 8 or 16 lanes packing both arrays
+ * into MatrixBlocks and unpacking the result is faster than this loop even for a single pass, so callers on those
+ * targets should prefer the block form.
+ * 
+ * @param A      Transforms applied second.
+ * @param B      Transforms applied first.
+ * @param result Output transforms.  May be the same array as A or B.
+ * @param count  Number of products.
+ */
+inline void multiplyAffine( const Matrix<4, 3>* A, const Matrix<4, 3>* B, Matrix<4, 3>* result, int count );
+
 /**
  * Creates a translation Matrix4x4.
  * 
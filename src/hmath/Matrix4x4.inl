@@ -1,4 +1,6 @@
 Matrix4x4 inverse( const Matrix4x4& M, bool* isInvertible ) {
+	HMATH_TRACE_SCOPE(Inverse, 4);
+	HMATH_COUNT(InverseCalls);
 	Matrix4x4 inv;
 	bool invertible;
 	const float a0 = M(0, 0) * M(1, 1) - M(0, 1) * M(1, 0);
@@ -36,6 +38,7 @@ Matrix4x4 inverse( const Matrix4x4& M, bool* isInvertible ) {
 		};
 		invertible = true;
 	} else {
+		HMATH_COUNT(InverseNotInvertible);
 		inv.makeZero();
 		invertible = false;
 	}
@@ -46,6 +49,76 @@ Matrix4x4 inverse( const Matrix4x4& M, bool* isInvertible ) {
 	return inv;
 }
 
+namespace detail {
+
+inline void inverseBlock( const Matrix4x4* M, Matrix4x4* inv, bool* isInvertible, int count ) {
+	using simd::Float;
+	const int W = SimdWidth;
+
+	// transpose into structure-of-arrays; unused lanes are zero and come out as non-invertible
+	float m[16 * W];
+	simd::loadTransposed(&M[0][0], 16, count, m);
+
+	const Float m00 = Float::load(m + 0*W),  m01 = Float::load(m + 1*W),  m02 = Float::load(m + 2*W),  m03 = Float::load(m + 3*W);
+	const Float m10 = Float::load(m + 4*W),  m11 = Float::load(m + 5*W),  m12 = Float::load(m + 6*W),  m13 = Float::load(m + 7*W);
+	const Float m20 = Float::load(m + 8*W),  m21 = Float::load(m + 9*W),  m22 = Float::load(m + 10*W), m23 = Float::load(m + 11*W);
+	const Float m30 = Float::load(m + 12*W), m31 = Float::load(m + 13*W), m32 = Float::load(m + 14*W), m33 = Float::load(m + 15*W);
+
+	const Float a0 = m00 * m11 - m01 * m10;
+	const Float a1 = m00 * m12 - m02 * m10;
+	const Float a2 = m00 * m13 - m03 * m10;
+	const Float a3 = m01 * m12 - m02 * m11;
+	const Float a4 = m01 * m13 - m03 * m11;
+	const Float a5 = m02 * m13 - m03 * m12;
+	const Float b0 = m20 * m31 - m21 * m30;
+	const Float b1 = m20 * m32 - m22 * m30;
+	const Float b2 = m20 * m33 - m23 * m30;
+	const Float b3 = m21 * m32 - m22 * m31;
+	const Float b4 = m21 * m33 - m23 * m31;
+	const Float b5 = m22 * m33 - m23 * m32;
+	const Float det = a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0;
+	const simd::Mask invertible = (det != Float(0.0f));
+	// a zero inverse determinant yields the zero matrix, as in the scalar version
+	const Float invDet = simd::select(invertible, Float(1.0f) / det, Float(0.0f));
+
+	float r[16 * W];
+	((+m11 * b5 - m12 * b4 + m13 * b3) * invDet).store(r + 0*W);
+	((-m01 * b5 + m02 * b4 - m03 * b3) * invDet).store(r + 1*W);
+	((+m31 * a5 - m32 * a4 + m33 * a3) * invDet).store(r + 2*W);
+	((-m21 * a5 + m22 * a4 - m23 * a3) * invDet).store(r + 3*W);
+	((-m10 * b5 + m12 * b2 - m13 * b1) * invDet).store(r + 4*W);
+	((+m00 * b5 - m02 * b2 + m03 * b1) * invDet).store(r + 5*W);
+	((-m30 * a5 + m32 * a2 - m33 * a1) * invDet).store(r + 6*W);
+	((+m20 * a5 - m22 * a2 + m23 * a1) * invDet).store(r + 7*W);
+	((+m10 * b4 - m11 * b2 + m13 * b0) * invDet).store(r + 8*W);
+	((-m00 * b4 + m01 * b2 - m03 * b0) * invDet).store(r + 9*W);
+	((+m30 * a4 - m31 * a2 + m33 * a0) * invDet).store(r + 10*W);
+	((-m20 * a4 + m21 * a2 - m23 * a0) * invDet).store(r + 11*W);
+	((-m10 * b3 + m11 * b1 - m12 * b0) * invDet).store(r + 12*W);
+	((+m00 * b3 - m01 * b1 + m02 * b0) * invDet).store(r + 13*W);
+	((-m30 * a3 + m31 * a1 - m32 * a0) * invDet).store(r + 14*W);
+	((+m20 * a3 - m21 * a1 + m22 * a0) * invDet).store(r + 15*W);
+
+	simd::storeTransposed(r, 16, count, &inv[0][0]);
+	for( int l = 0; l < count && l < W; ++l ) {
+		if( !invertible[l] ) {
+			HMATH_COUNT(InverseNotInvertible);
+		}
+		if( isInvertible ) {
+			isInvertible[l] = invertible[l];
+		}
+	}
+}
+
+}
+
+void inverse( const Matrix4x4* M, Matrix4x4* inv, bool* isInvertible, int count ) {
+	HMATH_TRACE_BATCH(InverseBatch, 4, count);
+	HMATH_COUNT_N(InverseCalls, count > 0 ? count : 0);
+	for( int i = 0; i < count; i += SimdWidth ) {
+		detail::inverseBlock(M + i, inv + i, isInvertible ? isInvertible + i : nullptr, count - i);
+	}
+}
 
 float determinant( const Matrix4x4& M ) {
 	const float a0 = M(0, 0) * M(1, 1) - M(0, 1) * M(1, 0);
@@ -64,6 +137,99 @@ float determinant( const Matrix4x4& M ) {
 	return det;
 }
 
+Matrix3x3 normalMatrix( const Matrix4x4& M, bool divideByDeterminant ) {
+	const float c00 = M(1, 1)*M(2, 2) - M(1, 2)*M(2, 1);
+	const float c01 = M(1, 2)*M(2, 0) - M(1, 0)*M(2, 2);
+	const float c02 = M(1, 0)*M(2, 1) - M(1, 1)*M(2, 0);
+	const float det = M(0, 0)*c00 + M(0, 1)*c01 + M(0, 2)*c02;
+
+	float scale;
+	if( divideByDeterminant ) {
+		scale = (det != 0.0f) ? 1.0f / det : 0.0f;
+	} else {
+		scale = (det < 0.0f) ? -1.0f : 1.0f;
+	}
+
+	Matrix3x3 result;
+	result(0, 0) = c00 * scale;
+	result(0, 1) = c01 * scale;
+	result(0, 2) = c02 * scale;
+	result(1, 0) = (M(0, 2)*M(2, 1) - M(0, 1)*M(2, 2)) * scale;
+	result(1, 1) = (M(0, 0)*M(2, 2) - M(0, 2)*M(2, 0)) * scale;
+	result(1, 2) = (M(0, 1)*M(2, 0) - M(0, 0)*M(2, 1)) * scale;
+	result(2, 0) = (M(0, 1)*M(1, 2) - M(0, 2)*M(1, 1)) * scale;
+	result(2, 1) = (M(0, 2)*M(1, 0) - M(0, 0)*M(1, 2)) * scale;
+	result(2, 2) = (M(0, 0)*M(1, 1) - M(0, 1)*M(1, 0)) * scale;
+	return result;
+}
+
+namespace detail {
+
+inline void normalMatrixBlock( const Matrix4x4* M, Matrix3x3* normal, int count, bool divideByDeterminant ) {
+	using simd::Float;
+	const int W = SimdWidth;
+
+	float m[16 * W];
+	simd::loadTransposed(&M[0][0], 16, count, m);
+
+	const Float m00 = Float::load(m + 0*W), m01 = Float::load(m + 1*W), m02 = Float::load(m + 2*W);
+	const Float m10 = Float::load(m + 4*W), m11 = Float::load(m + 5*W), m12 = Float::load(m + 6*W);
+	const Float m20 = Float::load(m + 8*W), m21 = Float::load(m + 9*W), m22 = Float::load(m + 10*W);
+
+	const Float c00 = m11 * m22 - m12 * m21;
+	const Float c01 = m12 * m20 - m10 * m22;
+	const Float c02 = m10 * m21 - m11 * m20;
+	const Float det = m00 * c00 + m01 * c01 + m02 * c02;
+
+	Float scale;
+	if( divideByDeterminant ) {
+		scale = simd::select(det != Float(0.0f), Float(1.0f) / det, Float(0.0f));
+	} else {
+		scale = simd::select(det < Float(0.0f), Float(-1.0f), Float(1.0f));
+	}
+
+	float r[9 * W];
+	(c00 * scale).store(r + 0*W);
+	(c01 * scale).store(r + 1*W);
+	(c02 * scale).store(r + 2*W);
+	((m02 * m21 - m01 * m22) * scale).store(r + 3*W);
+	((m00 * m22 - m02 * m20) * scale).store(r + 4*W);
+	((m01 * m20 - m00 * m21) * scale).store(r + 5*W);
+	((m01 * m12 - m02 * m11) * scale).store(r + 6*W);
+	((m02 * m10 - m00 * m12) * scale).store(r + 7*W);
+	((m00 * m11 - m01 * m10) * scale).store(r + 8*W);
+
+	simd::storeTransposed(r, 9, count, &normal[0][0]);
+}
+
+}
+
+void normalMatrix( const Matrix4x4* M, Matrix3x3* normal, int count, bool divideByDeterminant ) {
+	HMATH_TRACE_BATCH(NormalMatrixBatch, 3, count);
+	for( int i = 0; i < count; i += SimdWidth ) {
+		detail::normalMatrixBlock(M + i, normal + i, count - i, divideByDeterminant);
+	}
+}
+
+Matrix<4, 3> multiplyAffine( const Matrix<4, 3>& A, const Matrix<4, 3>& B ) {
+	Matrix<4, 3> result;
+	detail::unroll<12>([&]( auto e ) {
+		const int r = e / 3;
+		const int c = e % 3;
+		const float sum = B(r, 0) * A(0, c) + B(r, 1) * A(1, c) + B(r, 2) * A(2, c);
+		// the translation row picks up A's translation through the implied 1
+		result(r, c) = (r == 3) ? sum + A(3, c) : sum;
+	});
+	return result;
+}
+
+void multiplyAffine( const Matrix<4, 3>* A, const Matrix<4, 3>* B, Matrix<4, 3>* result, int count ) {
+	HMATH_TRACE_BATCH(MultiplyBatch, 3, count);
+	for( int i = 0; i < count; ++i ) {
+		result[i] = multiplyAffine(A[i], B[i]);
+	}
+}
+
 Matrix4x4 makeTranslation( float x, float y, float z ) {
 	Matrix4x4 result;
 	result.makeIdentity();
@@ -0,0 +1,124 @@
+#ifndef __hmath_MatrixBlock__
+#define __hmath_MatrixBlock__
+
+#include <algorithm>
+#include "Matrix.hpp"
+#include "Simd.hpp"
+#include "Tracing.hpp"
+#include "Unroll.hpp"
+#include "Vector.hpp"
+
+namespace hm {
+
+/**
+ * SimdWidth matrices of the same shape interleaved element by element: the SimdWidth values of element (r, c) are
+ * contiguous, so a single simd::Float holds that element of every matrix in the block.
+ *
+ * Products of small matrices are too cheap to pay for transposing them into lanes on every call; the batch operations
+ * on plain Matrix arrays therefore run one product at a time.  Keeping long-lived data such as per-instance or per-bone
+ * transforms in blocks instead lets every multiply-add work on SimdWidth independent products with no transposition.
+ */
+template<int Rows, int Cols>
+class alignas(sizeof(float) * SimdWidth) MatrixBlock {
+public:
+	MatrixBlock();
+
+	/**
+	 * Stores a Matrix in one lane of the block.
+	 */
+	void set( int lane, const Matrix<Rows, Cols>& M );
+
+	/**
+	 * Returns the Matrix in one lane of the block.
+	 */
+	Matrix<Rows, Cols> get( int lane ) const;
+
+	// the SimdWidth values of element (r, c)
+	inline float const* lanes( int r, int c ) const;
+	inline float* lanes( int r, int c );
+
+private:
+	float data_[Rows * Cols * SimdWidth];
+};
+
+/**
+ * Packs an array of matrices into (count + SimdWidth - 1) / SimdWidth blocks.  Lanes past the end are zero.
+ *
+ * @param matrices Input Matrices.
+ * @param count    Number of Matrices.
+ * @param blocks   Output blocks.
+ */
+template<int Rows, int Cols>
+inline void packBlocks( const Matrix<Rows, Cols>* matrices, int count, MatrixBlock<Rows, Cols>* blocks );
+
+/**
+ * Unpacks the first count matrices of an array of blocks.
+ *
+ * @param blocks   Input blocks.
+ * @param count    Number of Matrices.
+ * @param matrices Output Matrices.
+ */
+template<int Rows, int Cols>
+inline void unpackBlocks( const MatrixBlock<Rows, Cols>* blocks, int count, Matrix<Rows, Cols>* matrices );
+
+/**
+ * Packs an array of vectors into blocks of row matrices, so that lanes(0, c) holds component c of SimdWidth vectors.
+ * Lanes past the end are zero.
+ *
+ * @param vectors Input Vectors.
+ * @param count   Number of Vectors.
+ * @param blocks  Output blocks.
+ */
+template<int N>
+inline void packBlocks( const Vector<N>* vectors, int count, MatrixBlock<1, N>* blocks );
+
+/**
+ * Unpacks the first count vectors of an array of blocks.
+ *
+ * @param blocks  Input blocks.
+ * @param count   Number of Vectors.
+ * @param vectors Output Vectors.
+ */
+template<int N>
+inline void unpackBlocks( const MatrixBlock<1, N>* blocks, int count, Vector<N>* vectors );
+
+// SimdWidth Vector3s in SoA form
+using Vector3Block = MatrixBlock<1, 3>;
+
+/**
+ * Computes the products AB lane by lane for arrays of blocks.  Each lane matches multiplyAB to within rounding.
+ *
+ * @param A         Left-hand blocks.
+ * @param B         Right-hand blocks.
+ * @param result    Output blocks.  May be the same array as A or B if the shapes match.
+ * @param numBlocks Number of blocks.
+ */
+template<int Rows, int Cols, int Common>
+inline void multiplyAB( const MatrixBlock<Rows, Common>* A, const MatrixBlock<Common, Cols>* B, MatrixBlock<Rows, Cols>* result, int numBlocks );
+
+/**
+ * Computes the products A * B (that is, BA) lane by lane for arrays of blocks of square matrices.
+ *
+ * @param A         Left-hand blocks.
+ * @param B         Right-hand blocks.
+ * @param result    Output blocks.  May be the same array as A or B.
+ * @param numBlocks Number of blocks.
+ */
+template<int N>
+inline void multiplyBA( const MatrixBlock<N, N>* A, const MatrixBlock<N, N>* B, MatrixBlock<N, N>* result, int numBlocks );
+
+/**
+ * Composes affine transforms lane by lane for arrays of blocks.  See multiplyAffine in Matrix4x4.hpp.
+ *
+ * @param A         Blocks of transforms applied second.
+ * @param B         Blocks of transforms applied first.
+ * @param result    Output blocks.  May be the same array as A or B.
+ * @param numBlocks Number of blocks.
+ */
+inline void multiplyAffine( const MatrixBlock<4, 3>* A, const MatrixBlock<4, 3>* B, MatrixBlock<4, 3>* result, int numBlocks );
+
+#include "MatrixBlock.inl"
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+template<int Rows, int Cols>
+MatrixBlock<Rows, Cols>::MatrixBlock() {
+	// uninitialized
+}
+
+template<int Rows, int Cols>
+void MatrixBlock<Rows, Cols>::set( int lane, const Matrix<Rows, Cols>& M ) {
+	assert((lane >= 0 && lane < SimdWidth) && "Lane out of bounds in MatrixBlock::set.");
+	for( int e = 0; e < Rows * Cols; ++e ) {
+		data_[e * SimdWidth + lane] = M[e];
+	}
+}
+
+template<int Rows, int Cols>
+Matrix<Rows, Cols> MatrixBlock<Rows, Cols>::get( int lane ) const {
+	assert((lane >= 0 && lane < SimdWidth) && "Lane out of bounds in MatrixBlock::get.");
+	Matrix<Rows, Cols> result;
+	for( int e = 0; e < Rows * Cols; ++e ) {
+		result[e] = data_[e * SimdWidth + lane];
+	}
+	return result;
+}
+
+template<int Rows, int Cols>
+float const* MatrixBlock<Rows, Cols>::lanes( int r, int c ) const {
+	assert((r >= 0 && r < Rows) && "Row out of bounds in MatrixBlock::lanes.");
+	assert((c >= 0 && c < Cols) && "Col out of bounds in MatrixBlock::lanes.");
+	return data_ + (r * Cols + c) * SimdWidth;
+}
+
+template<int Rows, int Cols>
+float* MatrixBlock<Rows, Cols>::lanes( int r, int c ) {
+	assert((r >= 0 && r < Rows) && "Row out of bounds in MatrixBlock::lanes.");
+	assert((c >= 0 && c < Cols) && "Col out of bounds in MatrixBlock::lanes.");
+	return data_ + (r * Cols + c) * SimdWidth;
+}
+
+template<int Rows, int Cols>
+void packBlocks( const Matrix<Rows, Cols>* matrices, int count, MatrixBlock<Rows, Cols>* blocks ) {
+	for( int i = 0, b = 0; i < count; i += SimdWidth, ++b ) {
+		simd::loadTransposed(&matrices[i][0], Rows * Cols, count - i, blocks[b].lanes(0, 0));
+	}
+}
+
+template<int Rows, int Cols>
+void unpackBlocks( const MatrixBlock<Rows, Cols>* blocks, int count, Matrix<Rows, Cols>* matrices ) {
+	for( int i = 0, b = 0; i < count; i += SimdWidth, ++b ) {
+		simd::storeTransposed(blocks[b].lanes(0, 0), Rows * Cols, count - i, &matrices[i][0]);
+	}
+}
+
+template<int N>
+void packBlocks( const Vector<N>* vectors, int count, MatrixBlock<1, N>* blocks ) {
+	for( int i = 0, b = 0; i < count; i += SimdWidth, ++b ) {
+		simd::loadTransposed(&vectors[i][0], N, count - i, blocks[b].lanes(0, 0));
+	}
+}
+
+template<int N>
+void unpackBlocks( const MatrixBlock<1, N>* blocks, int count, Vector<N>* vectors ) {
+	for( int i = 0, b = 0; i < count; i += SimdWidth, ++b ) {
+		simd::storeTransposed(blocks[b].lanes(0, 0), N, count - i, &vectors[i][0]);
+	}
+}
+
+template<int Rows, int Cols, int Common>
+void multiplyAB( const MatrixBlock<Rows, Common>* A, const MatrixBlock<Common, Cols>* B, MatrixBlock<Rows, Cols>* result, int numBlocks ) {
+	HMATH_TRACE_BATCH(MultiplyBatch, Common, numBlocks * SimdWidth);
+	using simd::Float;
+	for( int b = 0; b < numBlocks; ++b ) {
+		// the whole product is formed before it is stored, so that result may alias an input
+		MatrixBlock<Rows, Cols> product;
+		detail::unroll<Rows * Cols>([&]( auto e ) {
+			const int r = e / Cols;
+			const int c = e % Cols;
+			Float sum = Float::load(A[b].lanes(r, 0)) * Float::load(B[b].lanes(0, c));
+			detail::unroll<Common - 1>([&]( auto k ) {
+				const int i = k + 1;
+				sum += Float::load(A[b].lanes(r, i)) * Float::load(B[b].lanes(i, c));
+			});
+			sum.store(product.lanes(r, c));
+		});
+		result[b] = product;
+	}
+}
+
+template<int N>
+void multiplyBA( const MatrixBlock<N, N>* A, const MatrixBlock<N, N>* B, MatrixBlock<N, N>* result, int numBlocks ) {
+	multiplyAB(B, A, result, numBlocks);
+}
+
+void multiplyAffine( const MatrixBlock<4, 3>* A, const MatrixBlock<4, 3>* B, MatrixBlock<4, 3>* result, int numBlocks ) {
+	HMATH_TRACE_BATCH(MultiplyBatch, 3, numBlocks * SimdWidth);
+	using simd::Float;
+	for( int b = 0; b < numBlocks; ++b ) {
+		MatrixBlock<4, 3> product;
+		detail::unroll<12>([&]( auto e ) {
+			const int r = e / 3;
+			const int c = e % 3;
+			Float sum = Float::load(B[b].lanes(r, 0)) * Float::load(A[b].lanes(0, c))
+			          + Float::load(B[b].lanes(r, 1)) * Float::load(A[b].lanes(1, c))
+			          + Float::load(B[b].lanes(r, 2)) * Float::load(A[b].lanes(2, c));
+			if( r == 3 ) {
+				sum += Float::load(A[b].lanes(3, c));
+			}
+			sum.store(product.lanes(r, c));
+		});
+		result[b] = product;
+	}
+}
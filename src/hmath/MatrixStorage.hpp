@@ -0,0 +1,82 @@
+#ifndef __hmath_MatrixStorage__
+#define __hmath_MatrixStorage__
+
+#include <cstring>
+#include "Aligned.hpp"
+#include "Matrix.hpp"
+#include "Simd.hpp"
+
+namespace hm {
+
+/**
+ * Memory order of the elements of a matrix.
+ *
+ * Matrix is always row-major, and is used with row vectors (v * M, translation in row 3).  Transposing both the
+ * convention and the order gives back the same bytes: a Matrix laid out row-major is exactly the column-major storage
+ * of the column-vector matrix M^T.  This means:
+ *
+ *  - APIs using column vectors with column-major storage (OpenGL, Vulkan and GLSL, glm) take RowMajor unchanged.
+ *  - APIs using row vectors with row-major storage (DirectXMath, HLSL with row_major) take RowMajor unchanged.
+ *  - APIs using row vectors with column-major storage (HLSL's default packing with mul(v, M)) need ColumnMajor.
+ */
+enum class StorageOrder {
+	RowMajor,
+	ColumnMajor
+};
+
+/**
+ * Matrix<Rows, Cols> laid out in a fixed storage order, as a flat array of floats with no padding.  StoredMatrix is
+ * trivially copyable, so it can be copied with memcpy into a constant buffer or an interop structure, or placed directly
+ * in mapped memory.  The math stays on Matrix; convert with the constructor and toMatrix().
+ */
+template<int Rows, int Cols, StorageOrder Order>
+class StoredMatrix {
+public:
+	StoredMatrix();
+	explicit StoredMatrix( const Matrix<Rows, Cols>& M );
+
+	Matrix<Rows, Cols> toMatrix() const;
+
+	inline float const& operator()( int r, int c ) const;
+	inline float& operator()( int r, int c );
+
+	inline const float* data() const;
+	inline float* data();
+
+	static inline int index( int r, int c );
+
+private:
+	float data_[Rows * Cols];
+};
+
+using ColumnMajorMatrix4x4 = StoredMatrix<4, 4, StorageOrder::ColumnMajor>;
+using RowMajorMatrix4x4 = StoredMatrix<4, 4, StorageOrder::RowMajor>;
+
+/**
+ * Writes a matrix to memory in the given storage order.
+ *
+ * @param M      Matrix to store.
+ * @param target Receives Rows * Cols floats.
+ */
+template<StorageOrder Order, int Rows, int Cols>
+inline void storeMatrix( const Matrix<Rows, Cols>& M, float* target );
+
+/**
+ * Writes an array of matrices back to back in the given storage order, for uploading into a mapped GPU buffer.
+ *
+ * When the target is 16-byte aligned, 4x4 matrices are written with non-temporal (streaming) stores.  These bypass the
+ * cache, which is what write-combined memory wants: the stores are merged into full lines and never read back.  The
+ * function ends with a store fence, so the data is visible to the device once it returns.
+ *
+ * @param matrices Matrices to store.
+ * @param count    Number of matrices.
+ * @param target   Receives count * Rows * Cols floats.
+ */
+template<StorageOrder Order, int Rows, int Cols>
+inline void storeMatrices( const Matrix<Rows, Cols>* matrices, int count, float* target );
+
+#include "MatrixStorage.inl"
+
+}
+
+#endif
@@ -0,0 +1,113 @@
+template<int Rows, int Cols, StorageOrder Order>
+StoredMatrix<Rows, Cols, Order>::StoredMatrix() {
+	// uninitialized
+}
+
+template<int Rows, int Cols, StorageOrder Order>
+StoredMatrix<Rows, Cols, Order>::StoredMatrix( const Matrix<Rows, Cols>& M ) {
+	storeMatrix<Order>(M, data_);
+}
+
+template<int Rows, int Cols, StorageOrder Order>
+Matrix<Rows, Cols> StoredMatrix<Rows, Cols, Order>::toMatrix() const {
+	Matrix<Rows, Cols> result;
+	for( int r = 0; r < Rows; ++r ) {
+		for( int c = 0; c < Cols; ++c ) {
+			result(r, c) = data_[index(r, c)];
+		}
+	}
+	return result;
+}
+
+template<int Rows, int Cols, StorageOrder Order>
+float const& StoredMatrix<Rows, Cols, Order>::operator()( int r, int c ) const {
+	assert((r >= 0 && r < Rows) && "Row out of bounds in StoredMatrix() operator.");
+	assert((c >= 0 && c < Cols) && "Col out of bounds in StoredMatrix() operator.");
+	return data_[index(r, c)];
+}
+
+template<int Rows, int Cols, StorageOrder Order>
+float& StoredMatrix<Rows, Cols, Order>::operator()( int r, int c ) {
+	assert((r >= 0 && r < Rows) && "Row out of bounds in StoredMatrix() operator.");
+	assert((c >= 0 && c < Cols) && "Col out of bounds in StoredMatrix() operator.");
+	return data_[index(r, c)];
+}
+
+template<int Rows, int Cols, StorageOrder Order>
+const float* StoredMatrix<Rows, Cols, Order>::data() const {
+	return data_;
+}
+
+template<int Rows, int Cols, StorageOrder Order>
+float* StoredMatrix<Rows, Cols, Order>::data() {
+	return data_;
+}
+
+template<int Rows, int Cols, StorageOrder Order>
+int StoredMatrix<Rows, Cols, Order>::index( int r, int c ) {
+	return (Order == StorageOrder::RowMajor) ? (r * Cols + c) : (c * Rows + r);
+}
+
+template<StorageOrder Order, int Rows, int Cols>
+void storeMatrix( const Matrix<Rows, Cols>& M, float* target ) {
+	static_assert(sizeof(Matrix<Rows, Cols>) % sizeof(float) == 0, "Matrix must store plain floats.");
+	if( Order == StorageOrder::RowMajor ) {
+		std::memcpy(target, &M[0], Rows * Cols * sizeof(float));
+		return;
+	}
+	for( int c = 0; c < Cols; ++c ) {
+		for( int r = 0; r < Rows; ++r ) {
+			target[c * Rows + r] = M(r, c);
+		}
+	}
+}
+
+namespace detail {
+
+template<StorageOrder Order, int Rows, int Cols>
+inline bool streamMatrix( const Matrix<Rows, Cols>&, float* ) {
+	return false;
+}
+
+#if defined(HMATH_SIMD_HAS_SSE2)
+// streams one 4x4 matrix to a 16-byte aligned target, transposing in registers for column-major order
+template<StorageOrder Order>
+inline bool streamMatrix( const Matrix<4, 4>& M, float* target ) {
+	__m128 r0 = _mm_loadu_ps(&M[0]);
+	__m128 r1 = _mm_loadu_ps(&M[4]);
+	__m128 r2 = _mm_loadu_ps(&M[8]);
+	__m128 r3 = _mm_loadu_ps(&M[12]);
+	if( Order == StorageOrder::ColumnMajor ) {
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	}
+	_mm_stream_ps(target + 0, r0);
+	_mm_stream_ps(target + 4, r1);
+	_mm_stream_ps(target + 8, r2);
+	_mm_stream_ps(target + 12, r3);
+	return true;
+}
+#endif
+
+}
+
+template<StorageOrder Order, int Rows, int Cols>
+void storeMatrices( const Matrix<Rows, Cols>* matrices, int count, float* target ) {
+	// consecutive 4x4 matrices are 64 bytes apart, so an aligned target stays aligned
+	const bool stream = isAligned(target, 16);
+	bool streamed = false;
+	for( int i = 0; i < count; ++i ) {
+		float* out = target + i * Rows * Cols;
+		if( stream && detail::streamMatrix<Order>(matrices[i], out) ) {
+			streamed = true;
+		} else {
+			storeMatrix<Order>(matrices[i], out);
+		}
+	}
+#if defined(HMATH_SIMD_HAS_SSE2)
+	if( streamed ) {
+		_mm_sfence();
+	}
+#else
+	(void)streamed;
+#endif
+}
@@ -0,0 +1,87 @@
+#ifndef __hmath_Morton__
+#define __hmath_Morton__
+
+#include <cstdint>
+#include "Parallel.hpp"
+#include "Vector3.hpp"
+
+/**
+ * BMI2's pdep/pext interleave bits in a single instruction.  They are used when the compiler targets BMI2, unless
+ * HMATH_NO_PDEP is defined (pdep is microcoded and slow on AMD processors before Zen 3).
+ */
+#if !defined(HMATH_NO_PDEP) && (defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define HMATH_MORTON_PDEP
+	#include <immintrin.h>
+#endif
+
+namespace hm {
+
+/**
+ * Interleaves the low 10 bits of x, y and z into a 30-bit Morton (Z-order) code, with x in the lowest bit.
+ */
+inline std::uint32_t mortonEncode30( std::uint32_t x, std::uint32_t y, std::uint32_t z );
+
+/**
+ * Interleaves the low 21 bits of x, y and z into a 63-bit Morton (Z-order) code, with x in the lowest bit.
+ */
+inline std::uint64_t mortonEncode63( std::uint64_t x, std::uint64_t y, std::uint64_t z );
+
+/**
+ * Extracts x, y and z from a 30-bit Morton code.
+ */
+inline void mortonDecode30( std::uint32_t code, std::uint32_t& x, std::uint32_t& y, std::uint32_t& z );
+
+/**
+ * Extracts x, y and z from a 63-bit Morton code.
+ */
+inline void mortonDecode63( std::uint64_t code, std::uint64_t& x, std::uint64_t& y, std::uint64_t& z );
+
+/**
+ * Computes the 30-bit Morton code of a point quantized to a 1024^3 grid spanning an axis-aligned box.
+ * Points outside of the box are clamped to it.
+ *
+ * @param point    Point to encode.
+ * @param boxMin   Minimum corner of the box.
+ * @param boxMax   Maximum corner of the box.
+ */
+inline std::uint32_t mortonCode30( const Vector3& point, const Vector3& boxMin, const Vector3& boxMax );
+
+/**
+ * Computes the 63-bit Morton code of a point quantized to a 2097152^3 grid spanning an axis-aligned box.
+ * Points outside of the box are clamped to it.
+ *
+ * @param point    Point to encode.
+ * @param boxMin   Minimum corner of the box.
+ * @param boxMax   Maximum corner of the box.
+ */
+inline std::uint64_t mortonCode63( const Vector3& point, const Vector3& boxMin, const Vector3& boxMax );
+
+/**
+ * Computes the 30-bit Morton codes of an array of points.  See mortonCode30.
+ *
+ * @param points     Points to encode.
+ * @param count      Number of points.
+ * @param boxMin     Minimum corner of the box.
+ * @param boxMax     Maximum corner of the box.
+ * @param codes      Receives count codes.
+ * @param numThreads Number of threads; 0 uses all threads of the task executor.
+ */
+inline void mortonCodes30( const Vector3* points, int count, const Vector3& boxMin, const Vector3& boxMax, std::uint32_t* codes, int numThreads=0 );
+
+/**
+ * Computes the 63-bit Morton codes of an array of points.  See mortonCode63.
+ *
+ * @param points     Points to encode.
+ * @param count      Number of points.
+ * @param boxMin     Minimum corner of the box.
+ * @param boxMax     Maximum corner of the box.
+ * @param codes      Receives count codes.
+ * @param numThreads Number of threads; 0 uses all threads of the task executor.
+ */
+inline void mortonCodes63( const Vector3* points, int count, const Vector3& boxMin, const Vector3& boxMax, std::uint64_t* codes, int numThreads=0 );
+
+#include "Morton.inl"
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+namespace detail {
+
+inline std::uint32_t mortonSpread10( std::uint32_t x ) {
+	x &= 0x3ff;
+	x = (x | (x << 16)) & 0x030000ff;
+	x = (x | (x << 8)) & 0x0300f00f;
+	x = (x | (x << 4)) & 0x030c30c3;
+	x = (x | (x << 2)) & 0x09249249;
+	return x;
+}
+
+inline std::uint32_t mortonCompact10( std::uint32_t x ) {
+	x &= 0x09249249;
+	x = (x | (x >> 2)) & 0x030c30c3;
+	x = (x | (x >> 4)) & 0x0300f00f;
+	x = (x | (x >> 8)) & 0x030000ff;
+	x = (x | (x >> 16)) & 0x000003ff;
+	return x;
+}
+
+inline std::uint64_t mortonSpread21( std::uint64_t x ) {
+	x &= 0x1fffff;
+	x = (x | (x << 32)) & 0x001f00000000ffffull;
+	x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+	x = (x | (x << 8)) & 0x100f00f00f00f00full;
+	x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+	x = (x | (x << 2)) & 0x1249249249249249ull;
+	return x;
+}
+
+inline std::uint64_t mortonCompact21( std::uint64_t x ) {
+	x &= 0x1249249249249249ull;
+	x = (x | (x >> 2)) & 0x10c30c30c30c30c3ull;
+	x = (x | (x >> 4)) & 0x100f00f00f00f00full;
+	x = (x | (x >> 8)) & 0x001f0000ff0000ffull;
+	x = (x | (x >> 16)) & 0x001f00000000ffffull;
+	x = (x | (x >> 32)) & 0x00000000001fffffull;
+	return x;
+}
+
+// maps a coordinate of the box onto [0, maxCell]
+inline float mortonQuantize( float value, float boxMin, float scale, float maxCell ) {
+	return clamp((value - boxMin) * scale, 0.0f, maxCell);
+}
+
+inline float mortonScale( float boxMin, float boxMax, float maxCell ) {
+	const float extent = boxMax - boxMin;
+	return (extent > 0.0f) ? maxCell / extent : 0.0f;
+}
+
+}
+
+std::uint32_t mortonEncode30( std::uint32_t x, std::uint32_t y, std::uint32_t z ) {
+#if defined(HMATH_MORTON_PDEP)
+	return _pdep_u32(x, 0x09249249) | _pdep_u32(y, 0x12492492) | _pdep_u32(z, 0x24924924);
+#else
+	return detail::mortonSpread10(x) | (detail::mortonSpread10(y) << 1) | (detail::mortonSpread10(z) << 2);
+#endif
+}
+
+std::uint64_t mortonEncode63( std::uint64_t x, std::uint64_t y, std::uint64_t z ) {
+#if defined(HMATH_MORTON_PDEP) && (defined(__x86_64__) || defined(_M_X64))
+	return _pdep_u64(x, 0x1249249249249249ull) | _pdep_u64(y, 0x2492492492492492ull) | _pdep_u64(z, 0x4924924924924924ull);
+#else
+	return detail::mortonSpread21(x) | (detail::mortonSpread21(y) << 1) | (detail::mortonSpread21(z) << 2);
+#endif
+}
+
+void mortonDecode30( std::uint32_t code, std::uint32_t& x, std::uint32_t& y, std::uint32_t& z ) {
+#if defined(HMATH_MORTON_PDEP)
+	x = _pext_u32(code, 0x09249249);
+	y = _pext_u32(code, 0x12492492);
+	z = _pext_u32(code, 0x24924924);
+#else
+	x = detail::mortonCompact10(code);
+	y = detail::mortonCompact10(code >> 1);
+	z = detail::mortonCompact10(code >> 2);
+#endif
+}
+
+void mortonDecode63( std::uint64_t code, std::uint64_t& x, std::uint64_t& y, std::uint64_t& z ) {
+#if defined(HMATH_MORTON_PDEP) && (defined(__x86_64__) || defined(_M_X64))
+	x = _pext_u64(code, 0x1249249249249249ull);
+	y = _pext_u64(code, 0x2492492492492492ull);
+	z = _pext_u64(code, 0x4924924924924924ull);
+#else
+	x = detail::mortonCompact21(code);
+	y = detail::mortonCompact21(code >> 1);
+	z = detail::mortonCompact21(code >> 2);
+#endif
+}
+
+std::uint32_t mortonCode30( const Vector3& point, const Vector3& boxMin, const Vector3& boxMax ) {
+	const float maxCell = 1023.0f;
+	const auto x = static_cast<std::uint32_t>(detail::mortonQuantize(point[0], boxMin[0], detail::mortonScale(boxMin[0], boxMax[0], maxCell), maxCell));
+	const auto y = static_cast<std::uint32_t>(detail::mortonQuantize(point[1], boxMin[1], detail::mortonScale(boxMin[1], boxMax[1], maxCell), maxCell));
+	const auto z = static_cast<std::uint32_t>(detail::mortonQuantize(point[2], boxMin[2], detail::mortonScale(boxMin[2], boxMax[2], maxCell), maxCell));
+	return mortonEncode30(x, y, z);
+}
+
+std::uint64_t mortonCode63( const Vector3& point, const Vector3& boxMin, const Vector3& boxMax ) {
+	const float maxCell = 2097151.0f;
+	const auto x = static_cast<std::uint64_t>(detail::mortonQuantize(point[0], boxMin[0], detail::mortonScale(boxMin[0], boxMax[0], maxCell), maxCell));
+	const auto y = static_cast<std::uint64_t>(detail::mortonQuantize(point[1], boxMin[1], detail::mortonScale(boxMin[1], boxMax[1], maxCell), maxCell));
+	const auto z = static_cast<std::uint64_t>(detail::mortonQuantize(point[2], boxMin[2], detail::mortonScale(boxMin[2], boxMax[2], maxCell), maxCell));
+	return mortonEncode63(x, y, z);
+}
+
+void mortonCodes30( const Vector3* points, int count, const Vector3& boxMin, const Vector3& boxMax, std::uint32_t* codes, int numThreads ) {
+	const float maxCell = 1023.0f;
+	const float sx = detail::mortonScale(boxMin[0], boxMax[0], maxCell);
+	const float sy = detail::mortonScale(boxMin[1], boxMax[1], maxCell);
+	const float sz = detail::mortonScale(boxMin[2], boxMax[2], maxCell);
+	parallelFor(0, count, 0, [&]( int begin, int end ) {
+		for( int i = begin; i < end; ++i ) {
+			const auto x = static_cast<std::uint32_t>(detail::mortonQuantize(points[i][0], boxMin[0], sx, maxCell));
+			const auto y = static_cast<std::uint32_t>(detail::mortonQuantize(points[i][1], boxMin[1], sy, maxCell));
+			const auto z = static_cast<std::uint32_t>(detail::mortonQuantize(points[i][2], boxMin[2], sz, maxCell));
+			codes[i] = mortonEncode30(x, y, z);
+		}
+	}, numThreads);
+}
+
+void mortonCodes63( const Vector3* points, int count, const Vector3& boxMin, const Vector3& boxMax, std::uint64_t* codes, int numThreads ) {
+	const float maxCell = 2097151.0f;
+	const float sx = detail::mortonScale(boxMin[0], boxMax[0], maxCell);
+	const float sy = detail::mortonScale(boxMin[1], boxMax[1], maxCell);
+	const float sz = detail::mortonScale(boxMin[2], boxMax[2], maxCell);
+	parallelFor(0, count, 0, [&]( int begin, int end ) {
+		for( int i = begin; i < end; ++i ) {
+			const auto x = static_cast<std::uint64_t>(detail::mortonQuantize(points[i][0], boxMin[0], sx, maxCell));
+			const auto y = static_cast<std::uint64_t>(detail::mortonQuantize(points[i][1], boxMin[1], sy, maxCell));
+			const auto z = static_cast<std::uint64_t>(detail::mortonQuantize(points[i][2], boxMin[2], sz, maxCell));
+			codes[i] = mortonEncode63(x, y, z);
+		}
+	}, numThreads);
+}
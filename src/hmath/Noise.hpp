@@ -0,0 +1,79 @@
+#ifndef __hmath_Noise__
+#define __hmath_Noise__
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include "Simd.hpp"
+#include "Tracing.hpp"
+#include "Vector.hpp"
+
+namespace hm {
+
+/**
+ * Gradient noise over Vector2, Vector3 and Vector4 inputs, with analytic gradients.
+ *
+ * Lattice points are hashed with the permutation polynomial (34x^2 + x) mod 289 evaluated in floats, so there are no
+ * lookup tables and no seeds; every operation of the hash is exact integer arithmetic, which makes the noise
+ * deterministic across runs, threads and platforms.  Each kernel is written once for float and simd::Float, so the
+ * scalar and batch forms agree up to floating point contraction.
+ *
+ * Simplex noise sums radially symmetric kernels over the corners of a simplex (3, 4 or 5 corners) and is the cheaper
+ * of the two in 3D and 4D.  Perlin noise interpolates corner gradients over a hypercube (4, 8 or 16 corners) with a
+ * quintic fade, and repeats every 289 units along each axis.  Both are scaled to about [-1, 1].
+ */
+
+/**
+ * Evaluates simplex noise.
+ *
+ * @param point    Point to evaluate at.
+ * @param gradient If not null, receives the gradient of the noise at the point.
+ */
+template<int N>
+inline float simplexNoise( const Vector<N>& point, Vector<N>* gradient=nullptr );
+
+/**
+ * Evaluates Perlin noise.
+ *
+ * @param point    Point to evaluate at.
+ * @param gradient If not null, receives the gradient of the noise at the point.
+ */
+template<int N>
+inline float perlinNoise( const Vector<N>& point, Vector<N>* gradient=nullptr );
+
+/**
+ * Evaluates fractal Brownian motion: the sum of octaves of simplex noise, each at lacunarity times the frequency and
+ * gain times the amplitude of the previous one.  The sum is not normalized; its range is about
+ * +-(1 - gain^octaves) / (1 - gain).
+ *
+ * @param point      Point to evaluate at.
+ * @param octaves    Number of octaves.
+ * @param lacunarity Frequency ratio between octaves.
+ * @param gain       Amplitude ratio between octaves.
+ * @param gradient   If not null, receives the gradient of the sum at the point.
+ */
+template<int N>
+inline float fbm( const Vector<N>& point, int octaves, float lacunarity=2.0f, float gain=0.5f, Vector<N>* gradient=nullptr );
+
+/**
+ * Batch forms, evaluating SimdWidth points at once.
+ *
+ * @param points    Points to evaluate at.
+ * @param count     Number of points.
+ * @param values    Receives count noise values.
+ * @param gradients If not null, receives count gradients.
+ */
+template<int N>
+inline void simplexNoise( const Vector<N>* points, int count, float* values, Vector<N>* gradients=nullptr );
+
+template<int N>
+inline void perlinNoise( const Vector<N>* points, int count, float* values, Vector<N>* gradients=nullptr );
+
+template<int N>
+inline void fbm( const Vector<N>* points, int count, int octaves, float lacunarity, float gain, float* values, Vector<N>* gradients=nullptr );
+
+#include "Noise.inl"
+
+}
+
+#endif
@@ -0,0 +1,382 @@
+namespace detail {
+
+// lane helpers, so that each kernel is written once for float and for simd::Float
+inline float noiseFloor( float x ) {
+	return std::floor(x);
+}
+
+inline simd::Float noiseFloor( const simd::Float& x ) {
+	return simd::floor(x);
+}
+
+inline float noiseAbs( float x ) {
+	return std::fabs(x);
+}
+
+inline simd::Float noiseAbs( const simd::Float& x ) {
+	return simd::abs(x);
+}
+
+inline float noiseSelect( bool mask, float a, float b ) {
+	return mask ? a : b;
+}
+
+inline simd::Float noiseSelect( const simd::Mask& mask, const simd::Float& a, const simd::Float& b ) {
+	return simd::select(mask, a, b);
+}
+
+template<typename T>
+inline T noiseMod289( const T& x ) {
+	return x - noiseFloor(x * T(1.0f / 289.0f)) * T(289.0f);
+}
+
+// (34x^2 + x) mod 289; exact in floats for the integer inputs used here
+template<typename T>
+inline T noisePermute( const T& x ) {
+	return noiseMod289((x * T(34.0f) + T(1.0f)) * x);
+}
+
+// first order approximation of 1/sqrt(r) around r = 0.7, the typical squared length of the raw gradients
+template<typename T>
+inline T noiseInvLength( const T& r ) {
+	return T(1.79284291400159f) - T(0.85373472095314f) * r;
+}
+
+// gradients from a hash in [0, 289]: 41 points on a diamond in 2D, 49 on an octahedron in 3D, 343 on a 4D cross-polytope
+template<typename T>
+inline void noiseGradient( const T& hash, T (&g)[2] ) {
+	const T x = T(2.0f) * (hash * T(1.0f / 41.0f) - noiseFloor(hash * T(1.0f / 41.0f))) - T(1.0f);
+	g[1] = noiseAbs(x) - T(0.5f);
+	g[0] = x - noiseFloor(x + T(0.5f));
+	const T scale = noiseInvLength(g[0] * g[0] + g[1] * g[1]);
+	g[0] *= scale;
+	g[1] *= scale;
+}
+
+template<typename T>
+inline void noiseGradient( const T& hash, T (&g)[3] ) {
+	const T j = hash - T(49.0f) * noiseFloor(hash * T(1.0f / 49.0f));
+	const T row = noiseFloor(j * T(1.0f / 7.0f));
+	const T column = noiseFloor(j - T(7.0f) * row);
+	g[0] = row * T(2.0f / 7.0f) - T(13.0f / 14.0f);
+	g[1] = column * T(2.0f / 7.0f) - T(13.0f / 14.0f);
+	g[2] = T(1.0f) - noiseAbs(g[0]) - noiseAbs(g[1]);
+	// fold the lower half of the octahedron
+	const T fold = noiseSelect(g[2] <= T(0.0f), T(1.0f), T(0.0f));
+	g[0] -= fold * noiseSelect(g[0] < T(0.0f), T(-1.0f), T(1.0f));
+	g[1] -= fold * noiseSelect(g[1] < T(0.0f), T(-1.0f), T(1.0f));
+	const T scale = noiseInvLength(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+	for( int k = 0; k < 3; ++k ) {
+		g[k] *= scale;
+	}
+}
+
+template<typename T>
+inline void noiseGradient( const T& hash, T (&g)[4] ) {
+	const float steps[3] = {1.0f / 294.0f, 1.0f / 49.0f, 1.0f / 7.0f};
+	T sum(0.0f);
+	for( int k = 0; k < 3; ++k ) {
+		const T scaled = hash * T(steps[k]);
+		g[k] = noiseFloor((scaled - noiseFloor(scaled)) * T(7.0f)) * T(1.0f / 7.0f) - T(1.0f);
+		sum += noiseAbs(g[k]);
+	}
+	g[3] = T(1.5f) - sum;
+	const T fold = noiseSelect(g[3] < T(0.0f), T(1.0f), T(0.0f));
+	for( int k = 0; k < 3; ++k ) {
+		g[k] += fold * noiseSelect(g[k] < T(0.0f), T(1.0f), T(-1.0f));
+	}
+	const T scale = noiseInvLength(g[0] * g[0] + g[1] * g[1] + g[2] * g[2] + g[3] * g[3]);
+	for( int k = 0; k < 4; ++k ) {
+		g[k] *= scale;
+	}
+}
+
+// hash of the lattice point cell + offset, with cell already reduced mod 289
+template<typename T, int D>
+inline T noiseHash( const T (&cell)[D], const float (&offset)[D] ) {
+	T hash = noisePermute(cell[D - 1] + T(offset[D - 1]));
+	for( int k = D - 2; k >= 0; --k ) {
+		hash = noisePermute(hash + cell[k] + T(offset[k]));
+	}
+	return hash;
+}
+
+// adds the kernel (r^2 - |x|^2)^4 (g . x) of one simplex corner, and its gradient
+template<typename T, int D>
+inline void simplexCorner( const T (&x)[D], const T& hash, float radius2, T& value, T* gradient ) {
+	T g[D];
+	noiseGradient(hash, g);
+	T r2(0.0f), projection(0.0f);
+	for( int k = 0; k < D; ++k ) {
+		r2 += x[k] * x[k];
+		projection += g[k] * x[k];
+	}
+	const T a = maximum(T(radius2) - r2, T(0.0f));
+	const T a2 = a * a;
+	const T a4 = a2 * a2;
+	value += a4 * projection;
+	if( gradient ) {
+		const T falloff = T(-8.0f) * a2 * a * projection;
+		for( int k = 0; k < D; ++k ) {
+			gradient[k] += a4 * g[k] + falloff * x[k];
+		}
+	}
+}
+
+// simplex noise in D dimensions; the corners of the simplex containing the point follow from the ranks of its
+// coordinates within the unskewed cell
+template<typename T, int D>
+inline T simplexKernel( const T* v, T* gradient ) {
+	static_assert(D >= 2 && D <= 4, "simplex noise is defined for 2 to 4 dimensions");
+	// skew and unskew factors (sqrt(D+1) - 1) / D and (1 - 1/sqrt(D+1)) / D; a squared kernel radius of 0.5 keeps
+	// every kernel within the simplices around its corner, so the noise and its gradient are continuous
+	const float skew = (D == 2) ? 0.366025403784439f : (D == 3) ? (1.0f / 3.0f) : 0.309016994374947f;
+	const float unskew = (D == 2) ? 0.211324865405187f : (D == 3) ? (1.0f / 6.0f) : 0.138196601125011f;
+	const float radius2 = 0.5f;
+	const float scale = (D == 2) ? 130.0f : 105.0f;
+
+	T sum(0.0f);
+	for( int k = 0; k < D; ++k ) {
+		sum += v[k];
+	}
+	const T s = sum * T(skew);
+	T cell[D], x0[D];
+	T cellSum(0.0f);
+	for( int k = 0; k < D; ++k ) {
+		cell[k] = noiseFloor(v[k] + s);
+		cellSum += cell[k];
+	}
+	const T t = cellSum * T(unskew);
+	for( int k = 0; k < D; ++k ) {
+		x0[k] = v[k] - cell[k] + t;
+		cell[k] = noiseMod289(cell[k]);
+	}
+
+	// rank[k] counts the coordinates that x0[k] beats; ties go to the lower axis
+	T rank[D];
+	for( int k = 0; k < D; ++k ) {
+		rank[k] = T(0.0f);
+	}
+	for( int a = 0; a < D; ++a ) {
+		for( int b = a + 1; b < D; ++b ) {
+			const T aWins = noiseSelect(x0[a] >= x0[b], T(1.0f), T(0.0f));
+			rank[a] += aWins;
+			rank[b] += T(1.0f) - aWins;
+		}
+	}
+
+	T value(0.0f);
+	if( gradient ) {
+		for( int k = 0; k < D; ++k ) {
+			gradient[k] = T(0.0f);
+		}
+	}
+	// corner c steps along the axes of the c highest ranks; its offset from the point is x0 - step + c * unskew
+	for( int c = 0; c <= D; ++c ) {
+		T x[D], cornerCell[D];
+		const float zero[D] = {};
+		for( int k = 0; k < D; ++k ) {
+			const T step = noiseSelect(rank[k] >= T(static_cast<float>(D - c)), T(1.0f), T(0.0f));
+			x[k] = x0[k] - step + T(static_cast<float>(c) * unskew);
+			cornerCell[k] = cell[k] + step;
+		}
+		simplexCorner(x, noiseHash(cornerCell, zero), radius2, value, gradient);
+	}
+
+	if( gradient ) {
+		for( int k = 0; k < D; ++k ) {
+			gradient[k] *= T(scale);
+		}
+	}
+	return value * T(scale);
+}
+
+// Perlin noise in D dimensions, multilinear interpolation of the corner gradients with the quintic fade
+template<typename T, int D>
+inline T perlinKernel( const T* v, T* gradient ) {
+	static_assert(D >= 2 && D <= 4, "Perlin noise is defined for 2 to 4 dimensions");
+	const float scale = (D == 2) ? 2.3f : (D == 3) ? 1.55f : 1.8f;
+
+	T cell[D], f[D], u[D], du[D];
+	for( int k = 0; k < D; ++k ) {
+		const T floored = noiseFloor(v[k]);
+		f[k] = v[k] - floored;
+		u[k] = f[k] * f[k] * f[k] * (f[k] * (f[k] * T(6.0f) - T(15.0f)) + T(10.0f));
+		du[k] = T(30.0f) * f[k] * f[k] * (f[k] * (f[k] - T(2.0f)) + T(1.0f));
+		cell[k] = noiseMod289(floored);
+	}
+
+	T value(0.0f);
+	if( gradient ) {
+		for( int k = 0; k < D; ++k ) {
+			gradient[k] = T(0.0f);
+		}
+	}
+	for( int corner = 0; corner < (1 << D); ++corner ) {
+		float offset[D];
+		for( int k = 0; k < D; ++k ) {
+			offset[k] = static_cast<float>((corner >> k) & 1);
+		}
+		T g[D];
+		noiseGradient(noiseHash(cell, offset), g);
+
+		T projection(0.0f), w[D];
+		for( int k = 0; k < D; ++k ) {
+			projection += g[k] * (f[k] - T(offset[k]));
+			w[k] = (offset[k] != 0.0f) ? u[k] : T(1.0f) - u[k];
+		}
+		T weight = w[0];
+		for( int k = 1; k < D; ++k ) {
+			weight *= w[k];
+		}
+		value += projection * weight;
+
+		if( gradient ) {
+			for( int k = 0; k < D; ++k ) {
+				T others(1.0f);
+				for( int j = 0; j < D; ++j ) {
+					if( j != k ) {
+						others *= w[j];
+					}
+				}
+				const T dw = (offset[k] != 0.0f) ? du[k] : -du[k];
+				gradient[k] += g[k] * weight + projection * dw * others;
+			}
+		}
+	}
+
+	if( gradient ) {
+		for( int k = 0; k < D; ++k ) {
+			gradient[k] *= T(scale);
+		}
+	}
+	return value * T(scale);
+}
+
+template<typename T, int D>
+inline T fbmKernel( const T* v, T* gradient, int octaves, float lacunarity, float gain ) {
+	T value(0.0f), p[D], octaveGradient[D];
+	if( gradient ) {
+		for( int k = 0; k < D; ++k ) {
+			gradient[k] = T(0.0f);
+		}
+	}
+	float frequency = 1.0f;
+	float amplitude = 1.0f;
+	for( int octave = 0; octave < octaves; ++octave ) {
+		for( int k = 0; k < D; ++k ) {
+			p[k] = v[k] * T(frequency);
+		}
+		value += T(amplitude) * simplexKernel<T, D>(p, gradient ? octaveGradient : nullptr);
+		if( gradient ) {
+			for( int k = 0; k < D; ++k ) {
+				gradient[k] += T(amplitude * frequency) * octaveGradient[k];
+			}
+		}
+		frequency *= lacunarity;
+		amplitude *= gain;
+	}
+	return value;
+}
+
+template<int N>
+struct SimplexNoiseKernel {
+	template<typename T>
+	T operator()( const T* v, T* gradient ) const {
+		return simplexKernel<T, N>(v, gradient);
+	}
+};
+
+template<int N>
+struct PerlinNoiseKernel {
+	template<typename T>
+	T operator()( const T* v, T* gradient ) const {
+		return perlinKernel<T, N>(v, gradient);
+	}
+};
+
+template<int N>
+struct FbmNoiseKernel {
+	int octaves;
+	float lacunarity;
+	float gain;
+
+	template<typename T>
+	T operator()( const T* v, T* gradient ) const {
+		return fbmKernel<T, N>(v, gradient, octaves, lacunarity, gain);
+	}
+};
+
+template<int N, typename Kernel>
+inline float evaluateNoise( const Kernel& kernel, const Vector<N>& point, Vector<N>* gradient ) {
+	float p[N], g[N];
+	for( int k = 0; k < N; ++k ) {
+		p[k] = point[k];
+	}
+	const float value = kernel(p, gradient ? g : nullptr);
+	if( gradient ) {
+		for( int k = 0; k < N; ++k ) {
+			(*gradient)[k] = g[k];
+		}
+	}
+	return value;
+}
+
+template<int N, typename Kernel>
+inline void evaluateNoise( const Kernel& kernel, const Vector<N>* points, int count, float* values, Vector<N>* gradients ) {
+	HMATH_TRACE_BATCH(NoiseBatch, N, count);
+	using simd::Float;
+	const int W = SimdWidth;
+	for( int i = 0; i < count; i += W ) {
+		const int n = std::min(count - i, W);
+		float soa[N * W];
+		simd::loadTransposed(&points[i][0], N, n, soa);
+		Float p[N], g[N];
+		for( int k = 0; k < N; ++k ) {
+			p[k] = Float::load(soa + k*W);
+		}
+
+		const Float value = kernel(p, gradients ? g : nullptr);
+		float lanes[W];
+		value.store(lanes);
+		std::copy(lanes, lanes + n, values + i);
+		if( gradients ) {
+			for( int k = 0; k < N; ++k ) {
+				g[k].store(soa + k*W);
+			}
+			simd::storeTransposed(soa, N, n, &gradients[i][0]);
+		}
+	}
+}
+
+}
+
+template<int N>
+float simplexNoise( const Vector<N>& point, Vector<N>* gradient ) {
+	return detail::evaluateNoise(detail::SimplexNoiseKernel<N>(), point, gradient);
+}
+
+template<int N>
+float perlinNoise( const Vector<N>& point, Vector<N>* gradient ) {
+	return detail::evaluateNoise(detail::PerlinNoiseKernel<N>(), point, gradient);
+}
+
+template<int N>
+float fbm( const Vector<N>& point, int octaves, float lacunarity, float gain, Vector<N>* gradient ) {
+	return detail::evaluateNoise(detail::FbmNoiseKernel<N>{octaves, lacunarity, gain}, point, gradient);
+}
+
+template<int N>
+void simplexNoise( const Vector<N>* points, int count, float* values, Vector<N>* gradients ) {
+	detail::evaluateNoise(detail::SimplexNoiseKernel<N>(), points, count, values, gradients);
+}
+
+template<int N>
+void perlinNoise( const Vector<N>* points, int count, float* values, Vector<N>* gradients ) {
+	detail::evaluateNoise(detail::PerlinNoiseKernel<N>(), points, count, values, gradients);
+}
+
+template<int N>
+void fbm( const Vector<N>* points, int count, int octaves, float lacunarity, float gain, float* values, Vector<N>* gradients ) {
+	detail::evaluateNoise(detail::FbmNoiseKernel<N>{octaves, lacunarity, gain}, points, count, values, gradients);
+}
@@ -0,0 +1,90 @@
+#ifndef __hmath_Octahedral__
+#define __hmath_Octahedral__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "Simd.hpp"
+#include "Vector3.hpp"
+
+namespace hm {
+
+/**
+ * Octahedral encoding of unit vectors (Cigolle et al., "A Survey of Efficient Representations for Independent Unit
+ * Vectors", 2014).  The sphere is projected onto the octahedron |x| + |y| + |z| = 1, whose lower half is folded over the
+ * upper half into the square [-1, 1]^2, and both square coordinates are stored as signed normalized integers.  Zero
+ * maps exactly to zero, so the axes and the planes between them are represented without error.
+ *
+ * Encoding picks the best of the four grid points around the projection rather than rounding each coordinate, which
+ * reduces the worst-case error by about a third.  Decoded vectors are normalized to within float rounding, so they can be
+ * passed straight to dot, reflect and the like.  Measured worst-case angles between a unit vector and its decoding:
+ *
+ *   32 bits (2 x 16): 0.00247 degrees
+ *   16 bits (2 x 8):  0.637 degrees
+ *
+ * The input need not be normalized, but must not be zero; a zero vector decodes to +z.
+ */
+
+/**
+ * Encodes a direction into 32 bits, as two 16-bit signed components with the first in the low half.
+ */
+inline std::uint32_t encodeOctahedral32( const Vector3& direction );
+
+/**
+ * Decodes a unit vector encoded by encodeOctahedral32.
+ */
+inline Vector3 decodeOctahedral32( std::uint32_t code );
+
+/**
+ * Encodes a direction into 16 bits, as two 8-bit signed components with the first in the low byte.
+ */
+inline std::uint16_t encodeOctahedral16( const Vector3& direction );
+
+/**
+ * Decodes a unit vector encoded by encodeOctahedral16.
+ */
+inline Vector3 decodeOctahedral16( std::uint16_t code );
+
+/**
+ * Batch form of encodeOctahedral32, SimdWidth directions at a time.
+ *
+ * @param directions Directions to encode.
+ * @param count      Number of directions.
+ * @param codes      Receives count codes.
+ */
+inline void encodeOctahedral32( const Vector3* directions, int count, std::uint32_t* codes );
+
+/**
+ * Batch form of decodeOctahedral32, SimdWidth codes at a time.
+ *
+ * @param codes      Codes to decode.
+ * @param count      Number of codes.
+ * @param directions Receives count unit vectors.
+ */
+inline void decodeOctahedral32( const std::uint32_t* codes, int count, Vector3* directions );
+
+/**
+ * Batch form of encodeOctahedral16, SimdWidth directions at a time.
+ *
+ * @param directions Directions to encode.
+ * @param count      Number of directions.
+ * @param codes      Receives count codes.
+ */
+inline void encodeOctahedral16( const Vector3* directions, int count, std::uint16_t* codes );
+
+/**
+ * Batch form of decodeOctahedral16, SimdWidth codes at a time.
+ *
+ * @param codes      Codes to decode.
+ * @param count      Number of codes.
+ * @param directions Receives count unit vectors.
+ */
+inline void decodeOctahedral16( const std::uint16_t* codes, int count, Vector3* directions );
+
+#include "Octahedral.inl"
+
+}
+
+#endif
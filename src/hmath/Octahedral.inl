@@ -0,0 +1,199 @@
+namespace detail {
+
+inline float octAbs( float x ) {
+	return std::abs(x);
+}
+
+inline simd::Float octAbs( const simd::Float& x ) {
+	return simd::abs(x);
+}
+
+inline float octSqrt( float x ) {
+	return std::sqrt(x);
+}
+
+inline simd::Float octSqrt( const simd::Float& x ) {
+	return simd::sqrt(x);
+}
+
+inline float octSelect( bool mask, float a, float b ) {
+	return mask ? a : b;
+}
+
+inline simd::Float octSelect( const simd::Mask& mask, const simd::Float& a, const simd::Float& b ) {
+	return simd::select(mask, a, b);
+}
+
+// maps square coordinates back onto the octahedron, unnormalized
+template<typename T>
+inline void octUnfold( const T& u, const T& v, T& x, T& y, T& z ) {
+	z = T(1.0f) - octAbs(u) - octAbs(v);
+	const T t = maximum(-z, T(0.0f));
+	x = u + octSelect(u >= T(0.0f), -t, t);
+	y = v + octSelect(v >= T(0.0f), -t, t);
+}
+
+// projects a direction into the square; no product is added to, so this rounds the same with or without fused
+// multiply-adds
+template<typename T>
+inline void octProject( const T& x, const T& y, const T& z, T& u, T& v ) {
+	const T invSum = T(1.0f) / maximum(octAbs(x) + octAbs(y) + octAbs(z), T(1e-30f));
+	u = x * invSum;
+	v = y * invSum;
+	const T foldedU = (T(1.0f) - octAbs(v)) * octSelect(u >= T(0.0f), T(1.0f), T(-1.0f));
+	const T foldedV = (T(1.0f) - octAbs(u)) * octSelect(v >= T(0.0f), T(1.0f), T(-1.0f));
+	u = octSelect(z < T(0.0f), foldedU, u);
+	v = octSelect(z < T(0.0f), foldedV, v);
+}
+
+// Returns the grid point of [-levels, levels]^2 around the projection (u, v) that decodes closest to the direction.
+// Both the scalar and the batch encoder pick through here, so they choose the same code: the metric only multiplies
+// floats in double, which is exact, and so rounds the same whether or not the compiler contracts it into FMAs.
+inline void octNearest( float x, float y, float z, float u, float v, float levels, float& qu, float& qv ) {
+	const float baseU = std::floor(u * levels);
+	const float baseV = std::floor(v * levels);
+	double bestError = std::numeric_limits<double>::max();
+	qu = baseU;
+	qv = baseV;
+	for( int corner = 0; corner < 4; ++corner ) {
+		const float cu = std::min(baseU + static_cast<float>(corner & 1), levels);
+		const float cv = std::min(baseV + static_cast<float>(corner >> 1), levels);
+		float dx, dy, dz;
+		octUnfold(cu / levels, cv / levels, dx, dy, dz);
+		// squared sine of the angle to the input, up to the input's length; the cosine is too close to 1 to resolve at
+		// 16 bits per component.  The cross product is rounded to float so that its squares are exact again.
+		const float cx = static_cast<float>(static_cast<double>(y) * dz - static_cast<double>(z) * dy);
+		const float cy = static_cast<float>(static_cast<double>(z) * dx - static_cast<double>(x) * dz);
+		const float cz = static_cast<float>(static_cast<double>(x) * dy - static_cast<double>(y) * dx);
+		const double sine = static_cast<double>(cx) * cx + static_cast<double>(cy) * cy + static_cast<double>(cz) * cz;
+		const double length = static_cast<double>(dx) * dx + static_cast<double>(dy) * dy + static_cast<double>(dz) * dz;
+		const double error = sine / length;
+		if( error < bestError ) {
+			bestError = error;
+			qu = cu;
+			qv = cv;
+		}
+	}
+}
+
+template<typename T>
+inline void octDecode( const T& qu, const T& qv, float levels, T& x, T& y, T& z ) {
+	const T invLevels = T(1.0f / levels);
+	octUnfold(maximum(qu * invLevels, T(-1.0f)), maximum(qv * invLevels, T(-1.0f)), x, y, z);
+	const T invLength = T(1.0f) / octSqrt(x * x + y * y + z * z);
+	x *= invLength;
+	y *= invLength;
+	z *= invLength;
+}
+
+template<typename Code, typename Component>
+inline Code octPack( float qu, float qv ) {
+	const int shift = 8 * sizeof(Component);
+	const auto lo = static_cast<typename std::make_unsigned<Component>::type>(static_cast<Component>(qu));
+	const auto hi = static_cast<typename std::make_unsigned<Component>::type>(static_cast<Component>(qv));
+	return static_cast<Code>(lo | (static_cast<Code>(hi) << shift));
+}
+
+template<typename Code, typename Component>
+inline void octUnpack( Code code, float& qu, float& qv ) {
+	const int shift = 8 * sizeof(Component);
+	qu = static_cast<float>(static_cast<Component>(code));
+	qv = static_cast<float>(static_cast<Component>(code >> shift));
+}
+
+template<typename Code, typename Component>
+inline Code encodeOctahedral( const Vector3& direction ) {
+	const float levels = static_cast<float>(std::numeric_limits<Component>::max());
+	float u, v, qu, qv;
+	octProject(direction[0], direction[1], direction[2], u, v);
+	octNearest(direction[0], direction[1], direction[2], u, v, levels, qu, qv);
+	return octPack<Code, Component>(qu, qv);
+}
+
+template<typename Code, typename Component>
+inline Vector3 decodeOctahedral( Code code ) {
+	const float levels = static_cast<float>(std::numeric_limits<Component>::max());
+	float qu, qv;
+	octUnpack<Code, Component>(code, qu, qv);
+	Vector3 result;
+	octDecode(qu, qv, levels, result[0], result[1], result[2]);
+	return result;
+}
+
+template<typename Code, typename Component>
+inline void encodeOctahedral( const Vector3* directions, int count, Code* codes ) {
+	using simd::Float;
+	const int W = SimdWidth;
+	const float levels = static_cast<float>(std::numeric_limits<Component>::max());
+	for( int i = 0; i < count; i += W ) {
+		const int n = std::min(count - i, W);
+		float soa[3 * W];
+		simd::loadTransposed(&directions[i][0], 3, n, soa);
+		// the projection runs on all lanes; the choice among the grid points around it is per lane
+		Float u, v;
+		octProject(Float::load(soa), Float::load(soa + W), Float::load(soa + 2*W), u, v);
+		float us[W], vs[W];
+		u.store(us);
+		v.store(vs);
+		for( int l = 0; l < n; ++l ) {
+			float qu, qv;
+			octNearest(soa[l], soa[W + l], soa[2*W + l], us[l], vs[l], levels, qu, qv);
+			codes[i + l] = octPack<Code, Component>(qu, qv);
+		}
+	}
+}
+
+template<typename Code, typename Component>
+inline void decodeOctahedral( const Code* codes, int count, Vector3* directions ) {
+	using simd::Float;
+	const int W = SimdWidth;
+	const float levels = static_cast<float>(std::numeric_limits<Component>::max());
+	for( int i = 0; i < count; i += W ) {
+		const int n = std::min(count - i, W);
+		float us[W] = {}, vs[W] = {};
+		for( int l = 0; l < n; ++l ) {
+			octUnpack<Code, Component>(codes[i + l], us[l], vs[l]);
+		}
+		Float x, y, z;
+		octDecode(Float::load(us), Float::load(vs), levels, x, y, z);
+		float soa[3 * W];
+		x.store(soa);
+		y.store(soa + W);
+		z.store(soa + 2*W);
+		simd::storeTransposed(soa, 3, n, &directions[i][0]);
+	}
+}
+
+}
+
+std::uint32_t encodeOctahedral32( const Vector3& direction ) {
+	return detail::encodeOctahedral<std::uint32_t, std::int16_t>(direction);
+}
+
+Vector3 decodeOctahedral32( std::uint32_t code ) {
+	return detail::decodeOctahedral<std::uint32_t, std::int16_t>(code);
+}
+
+std::uint16_t encodeOctahedral16( const Vector3& direction ) {
+	return detail::encodeOctahedral<std::uint16_t, std::int8_t>(direction);
+}
+
+Vector3 decodeOctahedral16( std::uint16_t code ) {
+	return detail::decodeOctahedral<std::uint16_t, std::int8_t>(code);
+}
+
+void encodeOctahedral32( const Vector3* directions, int count, std::uint32_t* codes ) {
+	detail::encodeOctahedral<std::uint32_t, std::int16_t>(directions, count, codes);
+}
+
+void decodeOctahedral32( const std::uint32_t* codes, int count, Vector3* directions ) {
+	detail::decodeOctahedral<std::uint32_t, std::int16_t>(codes, count, directions);
+}
+
+void encodeOctahedral16( const Vector3* directions, int count, std::uint16_t* codes ) {
+	detail::encodeOctahedral<std::uint16_t, std::int8_t>(directions, count, codes);
+}
+
+void decodeOctahedral16( const std::uint16_t* codes, int count, Vector3* directions ) {
+	detail::decodeOctahedral<std::uint16_t, std::int8_t>(codes, count, directions);
+}
@@ -0,0 +1,139 @@
+#ifndef __hmath_Parallel__
+#define __hmath_Parallel__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Aligned.hpp"
+
+namespace hm {
+
+/**
+ * Runs the workers of hmath's parallel loops.
+ *
+ * parallelFor and parallelReduce do their own load balancing: they split a loop into blocks of grain-sized ranges,
+ * give each worker a contiguous share of the blocks, and let workers that run out steal half of the remaining blocks
+ * of another.  An executor only has to provide the threads.  Implement this interface to run hmath's loops on an
+ * existing thread pool, and install it with setTaskExecutor.
+ */
+class TaskExecutor {
+public:
+	using TaskFunction = void (*)( void* context, int worker );
+
+	virtual ~TaskExecutor() {
+	}
+
+	/**
+	 * Returns the number of workers that can usefully run at once, counting the calling thread.
+	 */
+	virtual int concurrency() const = 0;
+
+	/**
+	 * Calls task(context, worker) once for every worker in [0, count), possibly concurrently and in any order, and
+	 * returns once all calls have returned.  Running some or all calls on the calling thread is allowed; any call may
+	 * finish the work of the others, so running them one after another is correct, only slower.
+	 *
+	 * @param count   Number of workers.
+	 * @param task    Function to call.
+	 * @param context Passed to every call.
+	 */
+	virtual void run( int count, TaskFunction task, void* context ) = 0;
+};
+
+/**
+ * Built-in TaskExecutor: a fixed set of threads that sleep until a loop is run.  The calling thread always works as
+ * one of the workers, so a pool of N threads starts N - 1 of its own.  Loops from different threads are run one at a
+ * time.
+ */
+class ThreadPool : public TaskExecutor {
+public:
+	/**
+	 * @param numThreads Number of threads, counting the caller; 0 uses the hardware concurrency.
+	 */
+	explicit ThreadPool( int numThreads=0 );
+	~ThreadPool();
+
+	ThreadPool( const ThreadPool& ) = delete;
+	ThreadPool& operator=( const ThreadPool& ) = delete;
+
+	int concurrency() const override;
+	void run( int count, TaskFunction task, void* context ) override;
+
+private:
+	void workerLoop();
+	void runClaimed( TaskFunction task, void* context, int count );
+
+	std::vector<std::thread> threads_;
+	std::mutex runMutex_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable idle_;
+	TaskFunction task_;
+	void* context_;
+	int count_;
+	int active_;
+	std::uint64_t generation_;
+	bool stop_;
+	std::atomic<int> next_;
+};
+
+/**
+ * Installs the executor that runs all parallel loops, or restores the built-in ThreadPool when null.  The executor
+ * must outlive all loops that may still be running when it is replaced.
+ *
+ * @param executor Executor to install.
+ */
+inline void setTaskExecutor( TaskExecutor* executor );
+
+/**
+ * Returns the installed executor, creating the built-in ThreadPool with one thread per hardware thread on first use
+ * if none was installed.
+ */
+inline TaskExecutor& taskExecutor();
+
+/**
+ * Calls fn(first, last) over disjoint ranges that together cover [begin, end), on the workers of the installed
+ * executor.  Each range holds grainSize indices, except for the last one.
+ *
+ * Batch functions taking an array and a count can be spread over several threads by calling them on each range, for
+ * example parallelFor(0, count, 256, [&]( int first, int last ) { inverse(M + first, inv + first, ok + first, last -
+ * first); }).  Parallel loops started from within fn run serially on the calling thread.  fn must not throw.
+ *
+ * @param begin      First index.
+ * @param end        One past the last index.
+ * @param grainSize  Number of indices per range; 0 picks about eight ranges per thread.
+ * @param fn         Called with each range.
+ * @param numThreads Maximum number of threads; 0 uses all threads of the executor.
+ */
+template<typename Fn>
+inline void parallelFor( int begin, int end, int grainSize, Fn&& fn, int numThreads=0 );
+
+/**
+ * Reduces [begin, end) in parallel: fn(first, last) returns the value of each range, as in parallelFor, and the
+ * values are folded into identity with combine(accumulated, value).
+ *
+ * The values are combined in the order of their ranges whatever the number of threads and the order in which the
+ * ranges ran, so that for a given grain size the result is reproducible even for floating-point sums.  The grain size
+ * chosen for 0 depends on the number of threads; pass a fixed one for results that do not.
+ *
+ * @param begin      First index.
+ * @param end        One past the last index.
+ * @param grainSize  Number of indices per range; 0 picks about eight ranges per thread.
+ * @param identity   Initial value, also the result of an empty range.
+ * @param fn         Called with each range, returns its value.
+ * @param combine    Combines two values.
+ * @param numThreads Maximum number of threads; 0 uses all threads of the executor.
+ */
+template<typename T, typename Fn, typename Combine>
+inline T parallelReduce( int begin, int end, int grainSize, const T& identity, Fn&& fn, Combine&& combine, int numThreads=0 );
+
+#include "Parallel.inl"
+
+}
+
+#endif
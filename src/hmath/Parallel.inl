@@ -0,0 +1,274 @@
+inline ThreadPool::ThreadPool( int numThreads )
+	: task_(nullptr), context_(nullptr), count_(0), active_(0), generation_(0), stop_(false), next_(0) {
+	if( numThreads <= 0 ) {
+		numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	for( int t = 1; t < numThreads; ++t ) {
+		threads_.emplace_back([this]() {
+			workerLoop();
+		});
+	}
+}
+
+inline ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	wake_.notify_all();
+	for( auto& thread : threads_ ) {
+		thread.join();
+	}
+}
+
+inline int ThreadPool::concurrency() const {
+	return static_cast<int>(threads_.size()) + 1;
+}
+
+inline void ThreadPool::run( int count, TaskFunction task, void* context ) {
+	if( threads_.empty() || count <= 1 ) {
+		for( int i = 0; i < count; ++i ) {
+			task(context, i);
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> job(runMutex_);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		task_ = task;
+		context_ = context;
+		count_ = count;
+		next_.store(0, std::memory_order_relaxed);
+		++generation_;
+	}
+	wake_.notify_all();
+	runClaimed(task, context, count);
+
+	// every call has been claimed once runClaimed returns; wait for the threads still running theirs
+	std::unique_lock<std::mutex> lock(mutex_);
+	idle_.wait(lock, [this]() {
+		return active_ == 0;
+	});
+	task_ = nullptr;
+	context_ = nullptr;
+}
+
+inline void ThreadPool::workerLoop() {
+	std::uint64_t seen = 0;
+	std::unique_lock<std::mutex> lock(mutex_);
+	for( ;; ) {
+		wake_.wait(lock, [this, &seen]() {
+			return stop_ || generation_ != seen;
+		});
+		if( stop_ ) {
+			return;
+		}
+		// a thread waking after its job ended sees no task, or the next job, and never the task of a finished one
+		seen = generation_;
+		const TaskFunction task = task_;
+		void* const context = context_;
+		const int count = count_;
+		++active_;
+		lock.unlock();
+		if( task ) {
+			runClaimed(task, context, count);
+		}
+		lock.lock();
+		if( --active_ == 0 ) {
+			idle_.notify_one();
+		}
+	}
+}
+
+inline void ThreadPool::runClaimed( TaskFunction task, void* context, int count ) {
+	for( int i = next_.fetch_add(1, std::memory_order_relaxed); i < count; i = next_.fetch_add(1, std::memory_order_relaxed) ) {
+		task(context, i);
+	}
+}
+
+namespace detail {
+
+inline std::atomic<TaskExecutor*>& installedExecutor() {
+	static std::atomic<TaskExecutor*> executor(nullptr);
+	return executor;
+}
+
+inline ThreadPool& defaultThreadPool() {
+	// intentionally leaked so that its threads are never joined during static destruction
+	static ThreadPool* pool = new ThreadPool();
+	return *pool;
+}
+
+}
+
+void setTaskExecutor( TaskExecutor* executor ) {
+	detail::installedExecutor().store(executor, std::memory_order_release);
+}
+
+TaskExecutor& taskExecutor() {
+	if( TaskExecutor* executor = detail::installedExecutor().load(std::memory_order_acquire) ) {
+		return *executor;
+	}
+	return detail::defaultThreadPool();
+}
+
+namespace detail {
+
+// Returns the requested thread count, or the concurrency of the installed executor for 0 or less.
+inline int resolveThreadCount( int numThreads ) {
+	if( numThreads > 0 ) {
+		return numThreads;
+	}
+	return std::max(1, taskExecutor().concurrency());
+}
+
+inline int resolveGrainSize( int count, int grainSize, int numThreads ) {
+	if( grainSize > 0 ) {
+		return grainSize;
+	}
+	const int threads = std::min(resolveThreadCount(numThreads), taskExecutor().concurrency());
+	return (threads <= 1) ? count : std::max(1, count / (8 * threads));
+}
+
+// true on threads running a worker of a parallel loop, whose nested loops then run serially
+inline bool& inParallelLoop() {
+	thread_local bool inside = false;
+	return inside;
+}
+
+// The blocks [begin, end) not yet taken from a worker, packed into one word so that the owner taking blocks from the
+// front and thieves taking the back half can both claim theirs with a single compare-and-swap.
+struct alignas(CacheLineSize) StealRange {
+	std::atomic<std::uint64_t> blocks;
+};
+
+inline std::uint64_t packStealRange( int begin, int end ) {
+	return static_cast<std::uint32_t>(begin) | (static_cast<std::uint64_t>(static_cast<std::uint32_t>(end)) << 32);
+}
+
+inline int stealBegin( std::uint64_t range ) {
+	return static_cast<int>(static_cast<std::uint32_t>(range));
+}
+
+inline int stealEnd( std::uint64_t range ) {
+	return static_cast<int>(static_cast<std::uint32_t>(range >> 32));
+}
+
+template<typename BlockFn>
+struct StealingLoop {
+	BlockFn* blockFn;
+	StealRange* ranges;
+	int numWorkers;
+
+	static void runWorker( void* context, int worker ) {
+		StealingLoop& loop = *static_cast<StealingLoop*>(context);
+		const bool wasInside = inParallelLoop();
+		inParallelLoop() = true;
+		std::atomic<std::uint64_t>& own = loop.ranges[worker].blocks;
+		do {
+			std::uint64_t range = own.load(std::memory_order_acquire);
+			while( stealBegin(range) < stealEnd(range) ) {
+				const int block = stealBegin(range);
+				if( own.compare_exchange_weak(range, packStealRange(block + 1, stealEnd(range)), std::memory_order_acq_rel) ) {
+					(*loop.blockFn)(block);
+					range = own.load(std::memory_order_acquire);
+				}
+			}
+		} while( loop.steal(worker) );
+		inParallelLoop() = wasInside;
+	}
+
+	// moves the back half of the first nonempty range of another worker into the thief's own range
+	bool steal( int thief ) {
+		for( int i = 1; i < numWorkers; ++i ) {
+			std::atomic<std::uint64_t>& victim = ranges[(thief + i) % numWorkers].blocks;
+			std::uint64_t range = victim.load(std::memory_order_acquire);
+			while( stealBegin(range) < stealEnd(range) ) {
+				const int begin = stealBegin(range);
+				const int end = stealEnd(range);
+				const int mid = begin + (end - begin) / 2;
+				if( victim.compare_exchange_weak(range, packStealRange(begin, mid), std::memory_order_acq_rel) ) {
+					ranges[thief].blocks.store(packStealRange(mid, end), std::memory_order_release);
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+};
+
+// Calls blockFn(block) for every block in [0, numBlocks) on up to numThreads workers of the installed executor.
+template<typename BlockFn>
+inline void runBlocks( int numBlocks, int numThreads, BlockFn&& blockFn ) {
+	if( numBlocks <= 0 ) {
+		return;
+	}
+	TaskExecutor& executor = taskExecutor();
+	const int numWorkers = std::min(numBlocks, std::min(resolveThreadCount(numThreads), executor.concurrency()));
+	if( numWorkers <= 1 || inParallelLoop() ) {
+		for( int block = 0; block < numBlocks; ++block ) {
+			blockFn(block);
+		}
+		return;
+	}
+
+	AlignedArray<StealRange> ranges(numWorkers);
+	for( int w = 0; w < numWorkers; ++w ) {
+		const int begin = static_cast<int>(static_cast<std::int64_t>(numBlocks) * w / numWorkers);
+		const int end = static_cast<int>(static_cast<std::int64_t>(numBlocks) * (w + 1) / numWorkers);
+		ranges[w].blocks.store(packStealRange(begin, end), std::memory_order_relaxed);
+	}
+	using Loop = StealingLoop<typename std::remove_reference<BlockFn>::type>;
+	Loop loop = {&blockFn, ranges.data(), numWorkers};
+	executor.run(numWorkers, &Loop::runWorker, &loop);
+}
+
+/**
+ * Splits [0, count) into numChunks contiguous chunks and calls fn(chunk, begin, end) for each on the installed
+ * executor, for loops that keep per-chunk state.  Every chunk is called, even when empty.
+ */
+template<typename Fn>
+inline void runChunks( int count, int numChunks, Fn&& fn ) {
+	numChunks = std::max(1, std::min(numChunks, count));
+	const int chunkSize = (count + numChunks - 1) / numChunks;
+	runBlocks(numChunks, numChunks, [&fn, count, chunkSize]( int chunk ) {
+		const int begin = std::min(count, chunk * chunkSize);
+		fn(chunk, begin, std::min(count, begin + chunkSize));
+	});
+}
+
+}
+
+template<typename Fn>
+void parallelFor( int begin, int end, int grainSize, Fn&& fn, int numThreads ) {
+	if( end <= begin ) {
+		return;
+	}
+	const int grain = detail::resolveGrainSize(end - begin, grainSize, numThreads);
+	const int numBlocks = (end - begin - 1) / grain + 1;
+	detail::runBlocks(numBlocks, numThreads, [&fn, begin, end, grain]( int block ) {
+		const int first = begin + block * grain;
+		fn(first, first + std::min(grain, end - first));
+	});
+}
+
+template<typename T, typename Fn, typename Combine>
+T parallelReduce( int begin, int end, int grainSize, const T& identity, Fn&& fn, Combine&& combine, int numThreads ) {
+	if( end <= begin ) {
+		return identity;
+	}
+	const int grain = detail::resolveGrainSize(end - begin, grainSize, numThreads);
+	const int numBlocks = (end - begin - 1) / grain + 1;
+	AlignedArray<T> values(numBlocks, identity);
+	detail::runBlocks(numBlocks, numThreads, [&fn, &values, begin, end, grain]( int block ) {
+		const int first = begin + block * grain;
+		values[block] = fn(first, first + std::min(grain, end - first));
+	});
+
+	T result = identity;
+	for( const T& value : values ) {
+		result = combine(result, value);
+	}
+	return result;
+}
@@ -0,0 +1,55 @@
+#ifndef __hmath_RadixSort__
+#define __hmath_RadixSort__
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "Parallel.hpp"
+
+namespace hm {
+
+/**
+ * Computes the permutation that stably sorts unsigned integer keys, such as Morton codes, in ascending order.
+ *
+ * This is a least-significant-digit radix sort with 8-bit digits.  Each pass counts the digits of one contiguous chunk
+ * per thread, and each thread then scatters its chunk to offsets derived from all chunk histograms, which keeps the
+ * sort stable.  Passes in which all keys share the same digit are skipped, so 30-bit codes take at most four passes
+ * and clustered codes fewer.
+ *
+ * @param keys        Keys to sort by.
+ * @param count       Number of keys.
+ * @param permutation Receives count indices; permutation[i] is the index of the i-th smallest key.
+ * @param numThreads  Number of threads; 0 uses all threads of the task executor.
+ */
+template<typename Key>
+inline void radixSortPermutation( const Key* keys, int count, int* permutation, int numThreads=0 );
+
+/**
+ * Gathers an array by a permutation, so that target[i] = source[permutation[i]].  source and target must not overlap.
+ *
+ * @param source      Source elements.
+ * @param permutation Permutation of [0, count).
+ * @param count       Number of elements.
+ * @param target      Receives count elements.
+ * @param numThreads  Number of threads; 0 uses all threads of the task executor.
+ */
+template<typename T>
+inline void permute( const T* source, const int* permutation, int count, T* target, int numThreads=0 );
+
+/**
+ * Sorts keys in place and reorders any number of attached arrays, such as Vector<N> points and their payloads, to
+ * match.  See radixSortPermutation.
+ *
+ * @param keys       Keys to sort.
+ * @param count      Number of keys, and of elements in each array.
+ * @param numThreads Number of threads; 0 uses all threads of the task executor.
+ * @param arrays     Arrays to reorder along with the keys.
+ */
+template<typename Key, typename... Arrays>
+inline void radixSortByKey( Key* keys, int count, int numThreads, Arrays*... arrays );
+
+#include "RadixSort.inl"
+
+}
+
+#endif
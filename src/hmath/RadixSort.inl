@@ -0,0 +1,107 @@
+namespace detail {
+
+static const int RadixBits = 8;
+static const int RadixSize = 1 << RadixBits;
+
+// sorts keys into sortedKeys, and their indices into permutation
+template<typename Key>
+inline void radixSort( const Key* keys, int count, int numThreads, Key* sortedKeys, int* permutation ) {
+	static_assert(std::is_integral<Key>::value && std::is_unsigned<Key>::value, "keys must be unsigned integers");
+	if( count <= 0 ) {
+		return;
+	}
+	numThreads = std::max(1, std::min(resolveThreadCount(numThreads), count));
+
+	std::vector<Key> keyScratch(count);
+	std::vector<int> indexScratch(count);
+	Key* srcKeys = sortedKeys;
+	Key* dstKeys = keyScratch.data();
+	int* srcIndices = permutation;
+	int* dstIndices = indexScratch.data();
+	parallelFor(0, count, 0, [&]( int begin, int end ) {
+		for( int i = begin; i < end; ++i ) {
+			srcKeys[i] = keys[i];
+			srcIndices[i] = i;
+		}
+	}, numThreads);
+
+	// histograms[chunk][digit], turned into scatter offsets in place
+	std::vector<int> histograms(numThreads * RadixSize);
+	for( int shift = 0; shift < static_cast<int>(sizeof(Key)) * 8; shift += RadixBits ) {
+		runChunks(count, numThreads, [&]( int chunk, int begin, int end ) {
+			int* histogram = &histograms[chunk * RadixSize];
+			std::fill(histogram, histogram + RadixSize, 0);
+			for( int i = begin; i < end; ++i ) {
+				++histogram[(srcKeys[i] >> shift) & (RadixSize - 1)];
+			}
+		});
+
+		int offset = 0;
+		bool uniform = false;
+		for( int digit = 0; digit < RadixSize && !uniform; ++digit ) {
+			const int first = offset;
+			for( int chunk = 0; chunk < numThreads; ++chunk ) {
+				int& entry = histograms[chunk * RadixSize + digit];
+				const int n = entry;
+				entry = offset;
+				offset += n;
+			}
+			uniform = (offset - first == count);
+		}
+		if( uniform ) {
+			continue;
+		}
+
+		runChunks(count, numThreads, [&]( int chunk, int begin, int end ) {
+			int* offsets = &histograms[chunk * RadixSize];
+			for( int i = begin; i < end; ++i ) {
+				const int slot = offsets[(srcKeys[i] >> shift) & (RadixSize - 1)]++;
+				dstKeys[slot] = srcKeys[i];
+				dstIndices[slot] = srcIndices[i];
+			}
+		});
+		std::swap(srcKeys, dstKeys);
+		std::swap(srcIndices, dstIndices);
+	}
+
+	// an odd number of passes leaves the result in the scratch buffers
+	if( srcKeys != sortedKeys ) {
+		std::memcpy(sortedKeys, srcKeys, sizeof(Key) * count);
+		std::memcpy(permutation, srcIndices, sizeof(int) * count);
+	}
+}
+
+template<typename T>
+inline void reorderInPlace( T* values, const int* permutation, int count, int numThreads ) {
+	const AlignedArray<T> source(values, values + count);
+	permute(source.data(), permutation, count, values, numThreads);
+}
+
+}
+
+template<typename Key>
+void radixSortPermutation( const Key* keys, int count, int* permutation, int numThreads ) {
+	std::vector<Key> sortedKeys(std::max(count, 0));
+	detail::radixSort(keys, count, numThreads, sortedKeys.data(), permutation);
+}
+
+template<typename T>
+void permute( const T* source, const int* permutation, int count, T* target, int numThreads ) {
+	parallelFor(0, count, 0, [=]( int begin, int end ) {
+		for( int i = begin; i < end; ++i ) {
+			target[i] = source[permutation[i]];
+		}
+	}, numThreads);
+}
+
+template<typename Key, typename... Arrays>
+void radixSortByKey( Key* keys, int count, int numThreads, Arrays*... arrays ) {
+	if( count <= 0 ) {
+		return;
+	}
+	std::vector<int> permutation(count);
+	const std::vector<Key> unsortedKeys(keys, keys + count);
+	detail::radixSort(unsortedKeys.data(), count, numThreads, keys, permutation.data());
+	const int expand[] = {0, (detail::reorderInPlace(arrays, permutation.data(), count, numThreads), 0)...};
+	(void)expand;
+}
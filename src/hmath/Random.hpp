@@ -0,0 +1,88 @@
+#ifndef __hmath_Random__
+#define __hmath_Random__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "Simd.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+
+namespace hm {
+
+/**
+ * xoshiro128+ pseudo-random number generator, run as 16 interleaved lanes so that bulk generation vectorizes.
+ *
+ * The lanes are the same xoshiro128+ sequence, 2^64 steps apart; each call to the generator steps all of them at
+ * once with independent 32-bit integer operations, which compilers turn into SIMD instructions, and the outputs are
+ * handed out lane by lane.  The lane count does not depend on the SIMD width, so a seed gives the same sequence on
+ * every build.
+ *
+ * Streams are 2^96 steps apart: give each thread its own stream number (or call jump()) for reproducible,
+ * non-overlapping sequences.  Floats use the upper 24 bits, which are the strongest bits of xoshiro128+.
+ */
+class Random {
+public:
+	static const int Lanes = 16;
+
+	/**
+	 * @param seed   Seed, expanded with splitmix64.
+	 * @param stream Stream number; each stream starts 2^96 steps after the previous one.
+	 */
+	explicit Random( std::uint64_t seed=0, int stream=0 );
+
+	void seed( std::uint64_t seed, int stream=0 );
+
+	// advances to the start of the next stream, 2^96 steps ahead
+	void jump();
+
+	std::uint32_t nextUInt();
+	// uniform in [0, 1)
+	float nextFloat();
+
+	void fill( std::uint32_t* values, int count );
+	// uniform in [0, 1)
+	void fill( float* values, int count );
+
+private:
+	// steps every lane, writing one output per lane
+	void step( std::uint32_t* output );
+	// applies a jump polynomial to every lane
+	void jump( const std::uint32_t* polynomial, int lane );
+
+	std::uint32_t state_[4][Lanes];
+	std::uint32_t buffer_[Lanes];
+	int bufferPosition_;
+};
+
+// single samples
+inline Vector3 sampleSphere( Random& random );
+inline Vector3 sampleHemisphere( Random& random );
+inline Vector3 sampleCosineHemisphere( Random& random );
+inline Vector2 sampleDisk( Random& random );
+
+/**
+ * Fills an array with points distributed uniformly on the unit sphere.
+ */
+inline void sampleSphere( Random& random, Vector3* points, int count );
+
+/**
+ * Fills an array with points distributed uniformly on the unit hemisphere around +z.
+ */
+inline void sampleHemisphere( Random& random, Vector3* points, int count );
+
+/**
+ * Fills an array with unit directions around +z with density cos(theta) / pi, as used for diffuse reflection.
+ */
+inline void sampleCosineHemisphere( Random& random, Vector3* directions, int count );
+
+/**
+ * Fills an array with points distributed uniformly in the unit disk.
+ */
+inline void sampleDisk( Random& random, Vector2* points, int count );
+
+#include "Random.inl"
+
+}
+
+#endif
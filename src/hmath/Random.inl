@@ -0,0 +1,293 @@
+namespace detail {
+
+inline std::uint64_t splitMix64( std::uint64_t& x ) {
+	std::uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+// jump polynomials of xoshiro128, equivalent to 2^64 and 2^96 steps
+static const std::uint32_t XoshiroJump[4] = {0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b};
+static const std::uint32_t XoshiroLongJump[4] = {0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662};
+
+inline void xoshiroStep( std::uint32_t* s ) {
+	const std::uint32_t t = s[1] << 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 11) | (s[3] >> 21);
+}
+
+inline void xoshiroJump( std::uint32_t* s, const std::uint32_t* polynomial ) {
+	std::uint32_t sum[4] = {0, 0, 0, 0};
+	for( int word = 0; word < 4; ++word ) {
+		for( int bit = 0; bit < 32; ++bit ) {
+			if( polynomial[word] & (1u << bit) ) {
+				for( int k = 0; k < 4; ++k ) {
+					sum[k] ^= s[k];
+				}
+			}
+			xoshiroStep(s);
+		}
+	}
+	for( int k = 0; k < 4; ++k ) {
+		s[k] = sum[k];
+	}
+}
+
+// sine and cosine of 2 pi u for u in [0, 1]: reduced to a quadrant and evaluated around its middle
+inline void randomSinCos( const simd::Float& u, simd::Float& s, simd::Float& c ) {
+	using simd::Float;
+	const Float scaled = u * Float(4.0f);
+	const Float quadrant = simd::floor(scaled);
+	const Float x = (scaled - quadrant - Float(0.5f)) * Float(1.57079632679f);
+	const Float x2 = x * x;
+	const Float sx = x * (Float(1.0f) + x2 * (Float(-1.0f / 6.0f) + x2 * (Float(1.0f / 120.0f) + x2 * (Float(-1.0f / 5040.0f) + x2 * Float(1.0f / 362880.0f)))));
+	const Float cx = Float(1.0f) + x2 * (Float(-0.5f) + x2 * (Float(1.0f / 24.0f) + x2 * (Float(-1.0f / 720.0f) + x2 * Float(1.0f / 40320.0f))));
+	// angle within the quadrant is pi/4 + x
+	const Float s0 = (sx + cx) * Float(0.70710678118f);
+	const Float c0 = (cx - sx) * Float(0.70710678118f);
+	const simd::Mask odd = (quadrant == Float(1.0f)) | (quadrant == Float(3.0f));
+	const simd::Mask upper = quadrant >= Float(2.0f);
+	const Float rotatedS = simd::select(odd, c0, s0);
+	const Float rotatedC = simd::select(odd, -s0, c0);
+	s = simd::select(upper, -rotatedS, rotatedS);
+	c = simd::select(upper, -rotatedC, rotatedC);
+}
+
+inline void randomSinCos( float u, float& s, float& c ) {
+	const float angle = 6.28318530718f * u;
+	s = std::sin(angle);
+	c = std::cos(angle);
+}
+
+inline float randomSqrt( float x ) {
+	return std::sqrt(x);
+}
+
+inline simd::Float randomSqrt( const simd::Float& x ) {
+	return simd::sqrt(x);
+}
+
+// the distributions, from two uniform numbers each
+template<typename T>
+inline void sphereKernel( const T& u, const T& v, T* p ) {
+	const T z = T(1.0f) - T(2.0f) * u;
+	const T r = randomSqrt(maximum(T(1.0f) - z * z, T(0.0f)));
+	T s, c;
+	randomSinCos(v, s, c);
+	p[0] = r * c;
+	p[1] = r * s;
+	p[2] = z;
+}
+
+template<typename T>
+inline void hemisphereKernel( const T& u, const T& v, T* p ) {
+	const T z = T(1.0f) - u;
+	const T r = randomSqrt(maximum(T(1.0f) - z * z, T(0.0f)));
+	T s, c;
+	randomSinCos(v, s, c);
+	p[0] = r * c;
+	p[1] = r * s;
+	p[2] = z;
+}
+
+// Malley's method: project a uniform disk sample up onto the hemisphere
+template<typename T>
+inline void cosineHemisphereKernel( const T& u, const T& v, T* p ) {
+	const T r = randomSqrt(u);
+	T s, c;
+	randomSinCos(v, s, c);
+	p[0] = r * c;
+	p[1] = r * s;
+	p[2] = randomSqrt(maximum(T(1.0f) - u, T(0.0f)));
+}
+
+template<typename T>
+inline void diskKernel( const T& u, const T& v, T* p ) {
+	const T r = randomSqrt(u);
+	T s, c;
+	randomSinCos(v, s, c);
+	p[0] = r * c;
+	p[1] = r * s;
+}
+
+template<int N, typename Kernel>
+inline Vector<N> sampleOne( Random& random, Kernel kernel ) {
+	const float u = random.nextFloat();
+	const float v = random.nextFloat();
+	float p[N];
+	kernel(u, v, p);
+	Vector<N> result;
+	for( int k = 0; k < N; ++k ) {
+		result[k] = p[k];
+	}
+	return result;
+}
+
+template<int N, typename Kernel>
+inline void sampleMany( Random& random, Vector<N>* points, int count, Kernel kernel ) {
+	using simd::Float;
+	const int W = SimdWidth;
+	for( int i = 0; i < count; i += W ) {
+		const int n = std::min(count - i, W);
+		float uv[2 * W];
+		random.fill(uv, 2 * W);
+		Float p[N];
+		kernel(Float::load(uv), Float::load(uv + W), p);
+		float soa[N * W];
+		for( int k = 0; k < N; ++k ) {
+			p[k].store(soa + k*W);
+		}
+		simd::storeTransposed(soa, N, n, &points[i][0]);
+	}
+}
+
+struct SphereKernel {
+	template<typename T> void operator()( const T& u, const T& v, T* p ) const { sphereKernel(u, v, p); }
+};
+
+struct HemisphereKernel {
+	template<typename T> void operator()( const T& u, const T& v, T* p ) const { hemisphereKernel(u, v, p); }
+};
+
+struct CosineHemisphereKernel {
+	template<typename T> void operator()( const T& u, const T& v, T* p ) const { cosineHemisphereKernel(u, v, p); }
+};
+
+struct DiskKernel {
+	template<typename T> void operator()( const T& u, const T& v, T* p ) const { diskKernel(u, v, p); }
+};
+
+}
+
+inline Random::Random( std::uint64_t seed, int stream ) {
+	this->seed(seed, stream);
+}
+
+inline void Random::seed( std::uint64_t seed, int stream ) {
+	std::uint64_t x = seed;
+	const std::uint64_t a = detail::splitMix64(x);
+	const std::uint64_t b = detail::splitMix64(x);
+	state_[0][0] = static_cast<std::uint32_t>(a);
+	state_[1][0] = static_cast<std::uint32_t>(a >> 32);
+	state_[2][0] = static_cast<std::uint32_t>(b);
+	state_[3][0] = static_cast<std::uint32_t>(b >> 32);
+	// each lane starts 2^64 steps after the previous one
+	for( int lane = 1; lane < Lanes; ++lane ) {
+		for( int k = 0; k < 4; ++k ) {
+			state_[k][lane] = state_[k][lane - 1];
+		}
+		jump(detail::XoshiroJump, lane);
+	}
+	for( int s = 0; s < stream; ++s ) {
+		jump(detail::XoshiroLongJump, -1);
+	}
+	bufferPosition_ = Lanes;
+}
+
+inline void Random::jump() {
+	jump(detail::XoshiroLongJump, -1);
+	bufferPosition_ = Lanes;
+}
+
+inline void Random::jump( const std::uint32_t* polynomial, int lane ) {
+	// lane -1 jumps all lanes
+	const int begin = (lane < 0) ? 0 : lane;
+	const int end = (lane < 0) ? Lanes : lane + 1;
+	for( int l = begin; l < end; ++l ) {
+		std::uint32_t s[4] = {state_[0][l], state_[1][l], state_[2][l], state_[3][l]};
+		detail::xoshiroJump(s, polynomial);
+		for( int k = 0; k < 4; ++k ) {
+			state_[k][l] = s[k];
+		}
+	}
+}
+
+inline void Random::step( std::uint32_t* output ) {
+	std::uint32_t* s0 = state_[0];
+	std::uint32_t* s1 = state_[1];
+	std::uint32_t* s2 = state_[2];
+	std::uint32_t* s3 = state_[3];
+	for( int l = 0; l < Lanes; ++l ) {
+		output[l] = s0[l] + s3[l];
+		const std::uint32_t t = s1[l] << 9;
+		s2[l] ^= s0[l];
+		s3[l] ^= s1[l];
+		s1[l] ^= s2[l];
+		s0[l] ^= s3[l];
+		s2[l] ^= t;
+		s3[l] = (s3[l] << 11) | (s3[l] >> 21);
+	}
+}
+
+inline std::uint32_t Random::nextUInt() {
+	if( bufferPosition_ == Lanes ) {
+		step(buffer_);
+		bufferPosition_ = 0;
+	}
+	return buffer_[bufferPosition_++];
+}
+
+inline float Random::nextFloat() {
+	return static_cast<float>(nextUInt() >> 8) * (1.0f / 16777216.0f);
+}
+
+inline void Random::fill( std::uint32_t* values, int count ) {
+	int i = 0;
+	while( i < count && bufferPosition_ < Lanes ) {
+		values[i++] = buffer_[bufferPosition_++];
+	}
+	for( ; i + Lanes <= count; i += Lanes ) {
+		step(values + i);
+	}
+	while( i < count ) {
+		values[i++] = nextUInt();
+	}
+}
+
+inline void Random::fill( float* values, int count ) {
+	std::uint32_t bits[Lanes];
+	for( int i = 0; i < count; i += Lanes ) {
+		const int n = std::min(count - i, static_cast<int>(Lanes));
+		fill(bits, n);
+		for( int j = 0; j < n; ++j ) {
+			values[i + j] = static_cast<float>(bits[j] >> 8) * (1.0f / 16777216.0f);
+		}
+	}
+}
+
+Vector3 sampleSphere( Random& random ) {
+	return detail::sampleOne<3>(random, detail::SphereKernel());
+}
+
+Vector3 sampleHemisphere( Random& random ) {
+	return detail::sampleOne<3>(random, detail::HemisphereKernel());
+}
+
+Vector3 sampleCosineHemisphere( Random& random ) {
+	return detail::sampleOne<3>(random, detail::CosineHemisphereKernel());
+}
+
+Vector2 sampleDisk( Random& random ) {
+	return detail::sampleOne<2>(random, detail::DiskKernel());
+}
+
+void sampleSphere( Random& random, Vector3* points, int count ) {
+	detail::sampleMany(random, points, count, detail::SphereKernel());
+}
+
+void sampleHemisphere( Random& random, Vector3* points, int count ) {
+	detail::sampleMany(random, points, count, detail::HemisphereKernel());
+}
+
+void sampleCosineHemisphere( Random& random, Vector3* directions, int count ) {
+	detail::sampleMany(random, directions, count, detail::CosineHemisphereKernel());
+}
+
+void sampleDisk( Random& random, Vector2* points, int count ) {
+	detail::sampleMany(random, points, count, detail::DiskKernel());
+}
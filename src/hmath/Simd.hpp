@@ -0,0 +1,325 @@
+#ifndef __hmath_Simd__
+#define __hmath_Simd__
+
+#include <cmath>
+
+/**
+ * Lane width used by the batch (structure-of-arrays) kernels.
+ *
+ * Batch functions transpose blocks of HMATH_SIMD_WIDTH inputs into per-component arrays and evaluate the scalar
+ * formula on simd::Float lanes.  The width follows the widest instruction set enabled at compile time, and can be
+ * overridden by defining HMATH_SIMD_WIDTH (4, 8 or 16) before including hmath.  Widths without a matching instruction
+ * set fall back to portable scalar lanes.
+ */
+#if !defined(HMATH_SIMD_WIDTH)
+	#if defined(__AVX512F__)
+		#define HMATH_SIMD_WIDTH 16
+	#elif defined(__AVX__)
+		#define HMATH_SIMD_WIDTH 8
+	#else
+		#define HMATH_SIMD_WIDTH 4
+	#endif
+#endif
+
+#if HMATH_SIMD_WIDTH == 16 && defined(__AVX512F__)
+	#define HMATH_SIMD_AVX512
+	#include <immintrin.h>
+#elif HMATH_SIMD_WIDTH == 8 && defined(__AVX__)
+	#define HMATH_SIMD_AVX
+	#include <immintrin.h>
+#elif HMATH_SIMD_WIDTH == 4 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define HMATH_SIMD_SSE
+	#include <emmintrin.h>
+	#if defined(__SSE4_1__) || defined(__AVX__)
+		#include <smmintrin.h>
+	#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define HMATH_SIMD_HAS_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace hm {
+
+const static int SimdWidth = HMATH_SIMD_WIDTH;
+
+static_assert(SimdWidth == 4 || SimdWidth == 8 || SimdWidth == 16, "HMATH_SIMD_WIDTH must be 4, 8 or 16.");
+
+namespace simd {
+
+/**
+ * Per-lane boolean produced by comparing two Floats.
+ */
+struct Mask {
+#if defined(HMATH_SIMD_AVX512)
+	__mmask16 m;
+#elif defined(HMATH_SIMD_AVX)
+	__m256 m;
+#elif defined(HMATH_SIMD_SSE)
+	__m128 m;
+#else
+	bool m[SimdWidth];
+#endif
+
+	// returns the value of a single lane
+	inline bool operator[]( int lane ) const;
+	// returns the lanes as bits, lane l in bit l
+	inline unsigned bits() const;
+};
+
+/**
+ * SimdWidth floats processed as one register.
+ */
+struct Float {
+#if defined(HMATH_SIMD_AVX512)
+	__m512 v;
+#elif defined(HMATH_SIMD_AVX)
+	__m256 v;
+#elif defined(HMATH_SIMD_SSE)
+	__m128 v;
+#else
+	float v[SimdWidth];
+#endif
+
+	Float() {
+		// uninitialized
+	}
+	inline Float( float value );
+
+	// loads/stores SimdWidth consecutive floats; the pointer does not need to be aligned
+	static inline Float load( const float* source );
+	inline void store( float* target ) const;
+};
+
+inline Float operator+( const Float& a ) {
+	return a;
+}
+
+inline Float operator-( const Float& a );
+inline Float operator+( const Float& a, const Float& b );
+inline Float operator-( const Float& a, const Float& b );
+inline Float operator*( const Float& a, const Float& b );
+inline Float operator/( const Float& a, const Float& b );
+inline Float minimum( const Float& a, const Float& b );
+inline Float maximum( const Float& a, const Float& b );
+inline Float sqrt( const Float& a );
+inline Float abs( const Float& a );
+// rounds toward negative infinity
+inline Float floor( const Float& a );
+
+inline Mask operator==( const Float& a, const Float& b );
+inline Mask operator!=( const Float& a, const Float& b );
+inline Mask operator<( const Float& a, const Float& b );
+inline Mask operator<=( const Float& a, const Float& b );
+inline Mask operator>( const Float& a, const Float& b );
+inline Mask operator>=( const Float& a, const Float& b );
+inline Mask operator&( const Mask& a, const Mask& b );
+inline Mask operator|( const Mask& a, const Mask& b );
+
+// per lane, returns a where the mask is set and b elsewhere
+inline Float select( const Mask& mask, const Float& a, const Float& b );
+
+inline Float& operator+=( Float& a, const Float& b ) {
+	return (a = a + b);
+}
+
+inline Float& operator-=( Float& a, const Float& b ) {
+	return (a = a - b);
+}
+
+inline Float& operator*=( Float& a, const Float& b ) {
+	return (a = a * b);
+}
+
+#if defined(HMATH_SIMD_AVX512)
+bool Mask::operator[]( int lane ) const { return ((m >> lane) & 1) != 0; }
+unsigned Mask::bits() const { return m; }
+Float::Float( float value ) : v(_mm512_set1_ps(value)) {}
+Float Float::load( const float* source ) { Float r; r.v = _mm512_loadu_ps(source); return r; }
+void Float::store( float* target ) const { _mm512_storeu_ps(target, v); }
+Float operator-( const Float& a ) { Float r; r.v = _mm512_sub_ps(_mm512_setzero_ps(), a.v); return r; }
+Float operator+( const Float& a, const Float& b ) { Float r; r.v = _mm512_add_ps(a.v, b.v); return r; }
+Float operator-( const Float& a, const Float& b ) { Float r; r.v = _mm512_sub_ps(a.v, b.v); return r; }
+Float operator*( const Float& a, const Float& b ) { Float r; r.v = _mm512_mul_ps(a.v, b.v); return r; }
+Float operator/( const Float& a, const Float& b ) { Float r; r.v = _mm512_div_ps(a.v, b.v); return r; }
+Float minimum( const Float& a, const Float& b ) { Float r; r.v = _mm512_min_ps(a.v, b.v); return r; }
+Float maximum( const Float& a, const Float& b ) { Float r; r.v = _mm512_max_ps(a.v, b.v); return r; }
+Float sqrt( const Float& a ) { Float r; r.v = _mm512_sqrt_ps(a.v); return r; }
+Float abs( const Float& a ) { Float r; r.v = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(0x7fffffff))); return r; }
+Float floor( const Float& a ) { Float r; r.v = _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); return r; }
+Mask operator==( const Float& a, const Float& b ) { Mask r; r.m = _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ); return r; }
+Mask operator!=( const Float& a, const Float& b ) { Mask r; r.m = _mm512_cmp_ps_mask(a.v, b.v, _CMP_NEQ_UQ); return r; }
+Mask operator<( const Float& a, const Float& b ) { Mask r; r.m = _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ); return r; }
+Mask operator<=( const Float& a, const Float& b ) { Mask r; r.m = _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ); return r; }
+Mask operator>( const Float& a, const Float& b ) { Mask r; r.m = _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ); return r; }
+Mask operator>=( const Float& a, const Float& b ) { Mask r; r.m = _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ); return r; }
+Mask operator&( const Mask& a, const Mask& b ) { Mask r; r.m = static_cast<__mmask16>(a.m & b.m); return r; }
+Mask operator|( const Mask& a, const Mask& b ) { Mask r; r.m = static_cast<__mmask16>(a.m | b.m); return r; }
+Float select( const Mask& mask, const Float& a, const Float& b ) { Float r; r.v = _mm512_mask_blend_ps(mask.m, b.v, a.v); return r; }
+#elif defined(HMATH_SIMD_AVX)
+bool Mask::operator[]( int lane ) const { return ((_mm256_movemask_ps(m) >> lane) & 1) != 0; }
+unsigned Mask::bits() const { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+Float::Float( float value ) : v(_mm256_set1_ps(value)) {}
+Float Float::load( const float* source ) { Float r; r.v = _mm256_loadu_ps(source); return r; }
+void Float::store( float* target ) const { _mm256_storeu_ps(target, v); }
+Float operator-( const Float& a ) { Float r; r.v = _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); return r; }
+Float operator+( const Float& a, const Float& b ) { Float r; r.v = _mm256_add_ps(a.v, b.v); return r; }
+Float operator-( const Float& a, const Float& b ) { Float r; r.v = _mm256_sub_ps(a.v, b.v); return r; }
+Float operator*( const Float& a, const Float& b ) { Float r; r.v = _mm256_mul_ps(a.v, b.v); return r; }
+Float operator/( const Float& a, const Float& b ) { Float r; r.v = _mm256_div_ps(a.v, b.v); return r; }
+Float minimum( const Float& a, const Float& b ) { Float r; r.v = _mm256_min_ps(a.v, b.v); return r; }
+Float maximum( const Float& a, const Float& b ) { Float r; r.v = _mm256_max_ps(a.v, b.v); return r; }
+Float sqrt( const Float& a ) { Float r; r.v = _mm256_sqrt_ps(a.v); return r; }
+Float abs( const Float& a ) { Float r; r.v = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); return r; }
+Float floor( const Float& a ) { Float r; r.v = _mm256_floor_ps(a.v); return r; }
+Mask operator==( const Float& a, const Float& b ) { Mask r; r.m = _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); return r; }
+Mask operator!=( const Float& a, const Float& b ) { Mask r; r.m = _mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ); return r; }
+Mask operator<( const Float& a, const Float& b ) { Mask r; r.m = _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); return r; }
+Mask operator<=( const Float& a, const Float& b ) { Mask r; r.m = _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); return r; }
+Mask operator>( const Float& a, const Float& b ) { Mask r; r.m = _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); return r; }
+Mask operator>=( const Float& a, const Float& b ) { Mask r; r.m = _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); return r; }
+Mask operator&( const Mask& a, const Mask& b ) { Mask r; r.m = _mm256_and_ps(a.m, b.m); return r; }
+Mask operator|( const Mask& a, const Mask& b ) { Mask r; r.m = _mm256_or_ps(a.m, b.m); return r; }
+Float select( const Mask& mask, const Float& a, const Float& b ) { Float r; r.v = _mm256_blendv_ps(b.v, a.v, mask.m); return r; }
+#elif defined(HMATH_SIMD_SSE)
+bool Mask::operator[]( int lane ) const { return ((_mm_movemask_ps(m) >> lane) & 1) != 0; }
+unsigned Mask::bits() const { return static_cast<unsigned>(_mm_movemask_ps(m)); }
+Float::Float( float value ) : v(_mm_set1_ps(value)) {}
+Float Float::load( const float* source ) { Float r; r.v = _mm_loadu_ps(source); return r; }
+void Float::store( float* target ) const { _mm_storeu_ps(target, v); }
+Float operator-( const Float& a ) { Float r; r.v = _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); return r; }
+Float operator+( const Float& a, const Float& b ) { Float r; r.v = _mm_add_ps(a.v, b.v); return r; }
+Float operator-( const Float& a, const Float& b ) { Float r; r.v = _mm_sub_ps(a.v, b.v); return r; }
+Float operator*( const Float& a, const Float& b ) { Float r; r.v = _mm_mul_ps(a.v, b.v); return r; }
+Float operator/( const Float& a, const Float& b ) { Float r; r.v = _mm_div_ps(a.v, b.v); return r; }
+Float minimum( const Float& a, const Float& b ) { Float r; r.v = _mm_min_ps(a.v, b.v); return r; }
+Float maximum( const Float& a, const Float& b ) { Float r; r.v = _mm_max_ps(a.v, b.v); return r; }
+Float sqrt( const Float& a ) { Float r; r.v = _mm_sqrt_ps(a.v); return r; }
+Float abs( const Float& a ) { Float r; r.v = _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); return r; }
+#if defined(__SSE4_1__) || defined(__AVX__)
+Float floor( const Float& a ) { Float r; r.v = _mm_floor_ps(a.v); return r; }
+#else
+Float floor( const Float& a ) {
+	// truncate, step down where that rounded up, and keep values too large to have a fraction
+	const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+	const __m128 rounded = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a.v), _mm_set1_ps(1.0f)));
+	const __m128 small = _mm_cmplt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v), _mm_set1_ps(8388608.0f));
+	Float r; r.v = _mm_or_ps(_mm_and_ps(small, rounded), _mm_andnot_ps(small, a.v)); return r;
+}
+#endif
+Mask operator==( const Float& a, const Float& b ) { Mask r; r.m = _mm_cmpeq_ps(a.v, b.v); return r; }
+Mask operator!=( const Float& a, const Float& b ) { Mask r; r.m = _mm_cmpneq_ps(a.v, b.v); return r; }
+Mask operator<( const Float& a, const Float& b ) { Mask r; r.m = _mm_cmplt_ps(a.v, b.v); return r; }
+Mask operator<=( const Float& a, const Float& b ) { Mask r; r.m = _mm_cmple_ps(a.v, b.v); return r; }
+Mask operator>( const Float& a, const Float& b ) { Mask r; r.m = _mm_cmpgt_ps(a.v, b.v); return r; }
+Mask operator>=( const Float& a, const Float& b ) { Mask r; r.m = _mm_cmpge_ps(a.v, b.v); return r; }
+Mask operator&( const Mask& a, const Mask& b ) { Mask r; r.m = _mm_and_ps(a.m, b.m); return r; }
+Mask operator|( const Mask& a, const Mask& b ) { Mask r; r.m = _mm_or_ps(a.m, b.m); return r; }
+Float select( const Mask& mask, const Float& a, const Float& b ) { Float r; r.v = _mm_or_ps(_mm_and_ps(mask.m, a.v), _mm_andnot_ps(mask.m, b.v)); return r; }
+#else
+#define HMATH_SIMD_LANEWISE(expr) Float r; for( int i = 0; i < SimdWidth; ++i ) { r.v[i] = (expr); } return r;
+#define HMATH_SIMD_LANEWISE_MASK(expr) Mask r; for( int i = 0; i < SimdWidth; ++i ) { r.m[i] = (expr); } return r;
+bool Mask::operator[]( int lane ) const { return m[lane]; }
+unsigned Mask::bits() const { unsigned r = 0; for( int i = 0; i < SimdWidth; ++i ) { r |= static_cast<unsigned>(m[i]) << i; } return r; }
+Float::Float( float value ) { for( int i = 0; i < SimdWidth; ++i ) { v[i] = value; } }
+Float Float::load( const float* source ) { HMATH_SIMD_LANEWISE(source[i]) }
+void Float::store( float* target ) const { for( int i = 0; i < SimdWidth; ++i ) { target[i] = v[i]; } }
+Float operator-( const Float& a ) { HMATH_SIMD_LANEWISE(-a.v[i]) }
+Float operator+( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE(a.v[i] + b.v[i]) }
+Float operator-( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE(a.v[i] - b.v[i]) }
+Float operator*( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE(a.v[i] * b.v[i]) }
+Float operator/( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE(a.v[i] / b.v[i]) }
+Float minimum( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE(a.v[i] < b.v[i] ? a.v[i] : b.v[i]) }
+Float maximum( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE(a.v[i] > b.v[i] ? a.v[i] : b.v[i]) }
+Float sqrt( const Float& a ) { HMATH_SIMD_LANEWISE(sqrtf(a.v[i])) }
+Float abs( const Float& a ) { HMATH_SIMD_LANEWISE(fabsf(a.v[i])) }
+Float floor( const Float& a ) { HMATH_SIMD_LANEWISE(floorf(a.v[i])) }
+Mask operator==( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE_MASK(a.v[i] == b.v[i]) }
+Mask operator!=( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE_MASK(a.v[i] != b.v[i]) }
+Mask operator<( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE_MASK(a.v[i] < b.v[i]) }
+Mask operator<=( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE_MASK(a.v[i] <= b.v[i]) }
+Mask operator>( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE_MASK(a.v[i] > b.v[i]) }
+Mask operator>=( const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE_MASK(a.v[i] >= b.v[i]) }
+Mask operator&( const Mask& a, const Mask& b ) { HMATH_SIMD_LANEWISE_MASK(a.m[i] && b.m[i]) }
+Mask operator|( const Mask& a, const Mask& b ) { HMATH_SIMD_LANEWISE_MASK(a.m[i] || b.m[i]) }
+Float select( const Mask& mask, const Float& a, const Float& b ) { HMATH_SIMD_LANEWISE(mask.m[i] ? a.v[i] : b.v[i]) }
+#undef HMATH_SIMD_LANEWISE
+#undef HMATH_SIMD_LANEWISE_MASK
+#endif
+
+/**
+ * Transposes up to SimdWidth records of `components` consecutive floats into `components` rows of SimdWidth floats,
+ * so that soa[c*SimdWidth + l] holds component c of record l.  Lanes past `count` are set to zero.
+ *
+ * @param aos        Source records.
+ * @param components Number of floats per record.
+ * @param count      Number of records to read.
+ * @param soa        Target rows; must hold components*SimdWidth floats.
+ */
+inline void loadTransposed( const float* aos, int components, int count, float* soa ) {
+#if defined(HMATH_SIMD_HAS_SSE2)
+	if( count >= SimdWidth && components % 4 == 0 ) {
+		for( int l = 0; l < SimdWidth; l += 4 ) {
+			for( int c = 0; c < components; c += 4 ) {
+				__m128 r0 = _mm_loadu_ps(aos + (l + 0) * components + c);
+				__m128 r1 = _mm_loadu_ps(aos + (l + 1) * components + c);
+				__m128 r2 = _mm_loadu_ps(aos + (l + 2) * components + c);
+				__m128 r3 = _mm_loadu_ps(aos + (l + 3) * components + c);
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				_mm_storeu_ps(soa + (c + 0) * SimdWidth + l, r0);
+				_mm_storeu_ps(soa + (c + 1) * SimdWidth + l, r1);
+				_mm_storeu_ps(soa + (c + 2) * SimdWidth + l, r2);
+				_mm_storeu_ps(soa + (c + 3) * SimdWidth + l, r3);
+			}
+		}
+		return;
+	}
+#endif
+	for( int l = 0; l < SimdWidth; ++l ) {
+		for( int c = 0; c < components; ++c ) {
+			soa[c * SimdWidth + l] = (l < count) ? aos[l * components + c] : 0.0f;
+		}
+	}
+}
+
+/**
+ * Inverse of loadTransposed; only the first `count` records are written.
+ *
+ * @param soa        Source rows of SimdWidth floats.
+ * @param components Number of floats per record.
+ * @param count      Number of records to write.
+ * @param aos        Target records.
+ */
+inline void storeTransposed( const float* soa, int components, int count, float* aos ) {
+#if defined(HMATH_SIMD_HAS_SSE2)
+	if( count >= SimdWidth && components % 4 == 0 ) {
+		for( int l = 0; l < SimdWidth; l += 4 ) {
+			for( int c = 0; c < components; c += 4 ) {
+				__m128 r0 = _mm_loadu_ps(soa + (c + 0) * SimdWidth + l);
+				__m128 r1 = _mm_loadu_ps(soa + (c + 1) * SimdWidth + l);
+				__m128 r2 = _mm_loadu_ps(soa + (c + 2) * SimdWidth + l);
+				__m128 r3 = _mm_loadu_ps(soa + (c + 3) * SimdWidth + l);
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				_mm_storeu_ps(aos + (l + 0) * components + c, r0);
+				_mm_storeu_ps(aos + (l + 1) * components + c, r1);
+				_mm_storeu_ps(aos + (l + 2) * components + c, r2);
+				_mm_storeu_ps(aos + (l + 3) * components + c, r3);
+			}
+		}
+		return;
+	}
+#endif
+	const int n = (count < SimdWidth) ? count : SimdWidth;
+	for( int l = 0; l < n; ++l ) {
+		for( int c = 0; c < components; ++c ) {
+			aos[l * components + c] = soa[c * SimdWidth + l];
+		}
+	}
+}
+
+}
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef __hmath_SpatialHashGrid__
+#define __hmath_SpatialHashGrid__
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Parallel.hpp"
+#include "Vector3.hpp"
+
+namespace hm {
+
+/**
+ * Uniform grid over Vector3 points, hashed into a fixed number of buckets, for neighbor queries over points that move
+ * every frame.
+ *
+ * build() is a parallel counting sort: each point is hashed by its cell, the buckets are counted, and the points are
+ * scattered into one contiguous array ordered by bucket.  Each bucket is then described by a start and a count, so a
+ * rebuild touches no per-cell allocations and the point data of neighboring points stays close in memory.  Points of
+ * different cells may share a bucket; queries filter by distance, so this only costs time.  The order of points
+ * within a bucket is unspecified when building on several threads.
+ */
+class SpatialHashGrid {
+public:
+	SpatialHashGrid();
+
+	/**
+	 * Rebuilds the grid.  Internal buffers are reused across builds of similar sizes.
+	 *
+	 * @param points     Input points.
+	 * @param count      Number of points.
+	 * @param cellSize   Edge length of the cells; queries are fastest when this is close to the query radius.
+	 * @param numThreads Number of threads; 0 uses all threads of the task executor.
+	 * @param numBuckets Number of hash buckets, rounded up to a power of two; 0 uses twice the number of points.
+	 */
+	void build( const Vector3* points, int count, float cellSize, int numThreads=0, int numBuckets=0 );
+
+	int size() const;
+	float cellSize() const;
+
+	/**
+	 * Finds all points within a radius of a query point, in no particular order.
+	 *
+	 * @param query        Query point.
+	 * @param radius       Search radius.
+	 * @param indices      Found indices are appended to this.
+	 * @param sqrDistances If not null, the squared distances are appended to this.
+	 * @return Number of points found.
+	 */
+	int withinRadius( const Vector3& query, float radius, std::vector<int>& indices, std::vector<float>* sqrDistances=nullptr ) const;
+
+	/**
+	 * Calls callback(i, j, sqrDistance) once for every unordered pair of distinct points within a radius of each other.
+	 *
+	 * @param radius   Pair distance.
+	 * @param callback Called with the indices of both points and their squared distance.
+	 */
+	template<typename Callback>
+	void forEachPair( float radius, Callback&& callback ) const;
+
+	// bucket access, for custom traversals
+	int bucketOf( const Vector3& point ) const;
+	int bucketStart( int bucket ) const;
+	int bucketCount( int bucket ) const;
+	// points and original indices in bucket order
+	Vector3 const& sortedPoint( int slot ) const;
+	int sortedIndex( int slot ) const;
+
+private:
+	static const int MaxLocalBuckets = 64;
+	// cell coordinates are clamped to [-MaxCellCoord, MaxCellCoord], so that stepping past either end cannot overflow
+	static const int MaxCellCoord = 1 << 30;
+
+	// the cell along one axis; NaN falls into cell 0
+	inline int cellCoord( float value ) const;
+	inline int hashCell( int x, int y, int z ) const;
+	// writes the distinct buckets of all cells overlapping the box around center, returns their number; none for NaN
+	int gatherBuckets( const Vector3& center, float radius, int* local, std::vector<int>& overflow, const int*& buckets ) const;
+
+	float cellSize_;
+	float invCellSize_;
+	int bucketMask_;
+	std::vector<int> bucketStart_;
+	std::vector<int> bucketCount_;
+	std::vector<Vector3> sortedPoints_;
+	std::vector<int> sortedIndices_;
+	std::vector<int> pointBuckets_;
+	std::vector<int> pointRanks_;
+	std::unique_ptr<std::atomic<int>[]> counts_;
+	int numCounts_;
+};
+
+#include "SpatialHashGrid.inl"
+
+}
+
+#endif
@@ -0,0 +1,227 @@
+inline SpatialHashGrid::SpatialHashGrid()
+	: cellSize_(1.0f), invCellSize_(1.0f), bucketMask_(0), numCounts_(0) {
+}
+
+inline void SpatialHashGrid::build( const Vector3* points, int count, float cellSize, int numThreads, int numBuckets ) {
+	assert(cellSize > 0.0f);
+	count = std::max(count, 0);
+	numThreads = detail::resolveThreadCount(numThreads);
+	cellSize_ = cellSize;
+	invCellSize_ = 1.0f / cellSize;
+
+	int buckets = 1;
+	const int wanted = (numBuckets > 0) ? numBuckets : 2 * count;
+	while( buckets < wanted && buckets < (1 << 30) ) {
+		buckets <<= 1;
+	}
+	bucketMask_ = buckets - 1;
+
+	bucketStart_.resize(buckets);
+	bucketCount_.resize(buckets);
+	sortedPoints_.resize(count);
+	sortedIndices_.resize(count);
+	pointBuckets_.resize(count);
+	pointRanks_.resize(count);
+	if( numCounts_ != buckets ) {
+		counts_.reset(new std::atomic<int>[buckets]);
+		numCounts_ = buckets;
+	}
+
+	// count the points of each bucket
+	parallelFor(0, buckets, 0, [this]( int begin, int end ) {
+		for( int b = begin; b < end; ++b ) {
+			counts_[b].store(0, std::memory_order_relaxed);
+		}
+	}, numThreads);
+	parallelFor(0, count, 0, [this, points]( int begin, int end ) {
+		for( int i = begin; i < end; ++i ) {
+			const int bucket = bucketOf(points[i]);
+			pointBuckets_[i] = bucket;
+			// the count before this point is its rank within the bucket
+			pointRanks_[i] = counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+		}
+	}, numThreads);
+
+	// exclusive prefix sum of the counts, per chunk and then across chunks
+	std::vector<int> chunkTotals(numThreads + 1, 0);
+	detail::runChunks(buckets, numThreads, [this, &chunkTotals]( int chunk, int begin, int end ) {
+		int total = 0;
+		for( int b = begin; b < end; ++b ) {
+			const int n = counts_[b].load(std::memory_order_relaxed);
+			bucketCount_[b] = n;
+			bucketStart_[b] = total;
+			total += n;
+		}
+		chunkTotals[chunk + 1] = total;
+	});
+	for( int t = 1; t <= numThreads; ++t ) {
+		chunkTotals[t] += chunkTotals[t - 1];
+	}
+	detail::runChunks(buckets, numThreads, [this, &chunkTotals]( int chunk, int begin, int end ) {
+		const int offset = chunkTotals[chunk];
+		for( int b = begin; b < end; ++b ) {
+			bucketStart_[b] += offset;
+		}
+	});
+
+	// scatter into bucket order
+	parallelFor(0, count, 0, [this, points]( int begin, int end ) {
+		for( int i = begin; i < end; ++i ) {
+			const int slot = bucketStart_[pointBuckets_[i]] + pointRanks_[i];
+			sortedPoints_[slot] = points[i];
+			sortedIndices_[slot] = i;
+		}
+	}, numThreads);
+}
+
+inline int SpatialHashGrid::size() const {
+	return static_cast<int>(sortedPoints_.size());
+}
+
+inline float SpatialHashGrid::cellSize() const {
+	return cellSize_;
+}
+
+inline int SpatialHashGrid::cellCoord( float value ) const {
+	// clamped before the conversion, which is undefined outside the int range; clamping keeps the cells in order, so
+	// far points still land in the cells of a query covering them
+	const float cell = std::floor(value * invCellSize_);
+	if( cell != cell ) {
+		return 0;
+	}
+	return static_cast<int>(std::max(std::min(cell, static_cast<float>(MaxCellCoord)), -static_cast<float>(MaxCellCoord)));
+}
+
+inline int SpatialHashGrid::hashCell( int x, int y, int z ) const {
+	const std::uint32_t h = (static_cast<std::uint32_t>(x) * 73856093u) ^ (static_cast<std::uint32_t>(y) * 19349663u) ^ (static_cast<std::uint32_t>(z) * 83492791u);
+	return static_cast<int>(h & static_cast<std::uint32_t>(bucketMask_));
+}
+
+inline int SpatialHashGrid::bucketOf( const Vector3& point ) const {
+	return hashCell(cellCoord(point[0]), cellCoord(point[1]), cellCoord(point[2]));
+}
+
+inline int SpatialHashGrid::bucketStart( int bucket ) const {
+	return bucketStart_[bucket];
+}
+
+inline int SpatialHashGrid::bucketCount( int bucket ) const {
+	return bucketCount_[bucket];
+}
+
+inline Vector3 const& SpatialHashGrid::sortedPoint( int slot ) const {
+	return sortedPoints_[slot];
+}
+
+inline int SpatialHashGrid::sortedIndex( int slot ) const {
+	return sortedIndices_[slot];
+}
+
+inline int SpatialHashGrid::gatherBuckets( const Vector3& center, float radius, int* local, std::vector<int>& overflow, const int*& buckets ) const {
+	int minCell[3], maxCell[3];
+	std::int64_t numCells = 1;
+	for( int i = 0; i < 3; ++i ) {
+		const float lower = center[i] - radius;
+		const float upper = center[i] + radius;
+		if( !(lower <= upper) ) {
+			// NaN center or radius
+			return 0;
+		}
+		minCell[i] = cellCoord(lower);
+		maxCell[i] = cellCoord(upper);
+		// saturated past any bucket count, as the product of three spans of up to 2^31 cells overflows 64 bits
+		const std::int64_t span = static_cast<std::int64_t>(maxCell[i]) - minCell[i] + 1;
+		numCells = std::min(numCells * span, static_cast<std::int64_t>(1) << 31);
+	}
+
+	if( numCells <= MaxLocalBuckets ) {
+		// few cells; deduplicate colliding buckets with a linear scan
+		int count = 0;
+		for( int x = minCell[0]; x <= maxCell[0]; ++x ) {
+			for( int y = minCell[1]; y <= maxCell[1]; ++y ) {
+				for( int z = minCell[2]; z <= maxCell[2]; ++z ) {
+					const int bucket = hashCell(x, y, z);
+					if( std::find(local, local + count, bucket) == local + count ) {
+						local[count++] = bucket;
+					}
+				}
+			}
+		}
+		buckets = local;
+		return count;
+	}
+
+	overflow.clear();
+	if( numCells > static_cast<std::int64_t>(bucketMask_) + 1 ) {
+		// more cells than buckets; every bucket is hit or nearly so, and enumerating the cells could take forever
+		for( int bucket = 0; bucket <= bucketMask_; ++bucket ) {
+			overflow.push_back(bucket);
+		}
+		buckets = overflow.data();
+		return static_cast<int>(overflow.size());
+	}
+	for( int x = minCell[0]; x <= maxCell[0]; ++x ) {
+		for( int y = minCell[1]; y <= maxCell[1]; ++y ) {
+			for( int z = minCell[2]; z <= maxCell[2]; ++z ) {
+				overflow.push_back(hashCell(x, y, z));
+			}
+		}
+	}
+	std::sort(overflow.begin(), overflow.end());
+	overflow.erase(std::unique(overflow.begin(), overflow.end()), overflow.end());
+	buckets = overflow.data();
+	return static_cast<int>(overflow.size());
+}
+
+inline int SpatialHashGrid::withinRadius( const Vector3& query, float radius, std::vector<int>& indices, std::vector<float>* sqrDistances ) const {
+	if( sortedPoints_.empty() ) {
+		return 0;
+	}
+
+	int local[MaxLocalBuckets];
+	std::vector<int> overflow;
+	const int* buckets;
+	const int numBuckets = gatherBuckets(query, radius, local, overflow, buckets);
+
+	const float sqrRadius = radius * radius;
+	int found = 0;
+	for( int b = 0; b < numBuckets; ++b ) {
+		const int begin = bucketStart_[buckets[b]];
+		const int end = begin + bucketCount_[buckets[b]];
+		for( int slot = begin; slot < end; ++slot ) {
+			const float d2 = sqrDistance(query, sortedPoints_[slot]);
+			if( d2 <= sqrRadius ) {
+				indices.push_back(sortedIndices_[slot]);
+				if( sqrDistances ) {
+					sqrDistances->push_back(d2);
+				}
+				++found;
+			}
+		}
+	}
+	return found;
+}
+
+template<typename Callback>
+void SpatialHashGrid::forEachPair( float radius, Callback&& callback ) const {
+	int local[MaxLocalBuckets];
+	std::vector<int> overflow;
+	const float sqrRadius = radius * radius;
+	const int count = size();
+	for( int i = 0; i < count; ++i ) {
+		const Vector3& point = sortedPoints_[i];
+		const int* buckets;
+		const int numBuckets = gatherBuckets(point, radius, local, overflow, buckets);
+		for( int b = 0; b < numBuckets; ++b ) {
+			// each pair is reported from its lower slot only
+			const int begin = std::max(bucketStart_[buckets[b]], i + 1);
+			const int end = bucketStart_[buckets[b]] + bucketCount_[buckets[b]];
+			for( int j = begin; j < end; ++j ) {
+				const float d2 = sqrDistance(point, sortedPoints_[j]);
+				if( d2 <= sqrRadius ) {
+					callback(sortedIndices_[i], sortedIndices_[j], d2);
+				}
+			}
+		}
+	}
+}
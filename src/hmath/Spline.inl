@@ -0,0 +1,244 @@
+template<int N>
+CubicCurve<N>::CubicCurve() {
+	for( int i = 0; i < 4; ++i ) {
+		coefficients_[i] = Vector<N>(std::array<float, N>{});
+	}
+}
+
+template<int N>
+CubicCurve<N>::CubicCurve( const Vector<N>& a, const Vector<N>& b, const Vector<N>& c, const Vector<N>& d ) {
+	coefficients_[0] = a;
+	coefficients_[1] = b;
+	coefficients_[2] = c;
+	coefficients_[3] = d;
+}
+
+template<int N>
+CubicCurve<N> CubicCurve<N>::bezier( const Vector<N>& p0, const Vector<N>& p1, const Vector<N>& p2, const Vector<N>& p3 ) {
+	return CubicCurve(p0, 3.0f * (p1 - p0), 3.0f * (p0 - 2.0f * p1 + p2), (p3 - p0) + 3.0f * (p1 - p2));
+}
+
+template<int N>
+CubicCurve<N> CubicCurve<N>::catmullRom( const Vector<N>& p0, const Vector<N>& p1, const Vector<N>& p2, const Vector<N>& p3 ) {
+	return hermite(p1, 0.5f * (p2 - p0), p2, 0.5f * (p3 - p1));
+}
+
+template<int N>
+CubicCurve<N> CubicCurve<N>::hermite( const Vector<N>& p0, const Vector<N>& m0, const Vector<N>& p1, const Vector<N>& m1 ) {
+	return CubicCurve(p0, m0, 3.0f * (p1 - p0) - 2.0f * m0 - m1, 2.0f * (p0 - p1) + m0 + m1);
+}
+
+template<int N>
+Vector<N> CubicCurve<N>::evaluate( float t ) const {
+	return ((coefficients_[3] * t + coefficients_[2]) * t + coefficients_[1]) * t + coefficients_[0];
+}
+
+template<int N>
+Vector<N> CubicCurve<N>::derivative( float t ) const {
+	return ((3.0f * t) * coefficients_[3] + 2.0f * coefficients_[2]) * t + coefficients_[1];
+}
+
+template<int N>
+Vector<N> CubicCurve<N>::secondDerivative( float t ) const {
+	return (6.0f * t) * coefficients_[3] + 2.0f * coefficients_[2];
+}
+
+template<int N>
+Vector<N> CubicCurve<N>::tangent( float t ) const {
+	Vector<N> result = derivative(t);
+	if( normalize(result) == 0.0f ) {
+		result = Vector<N>(std::array<float, N>{});
+	}
+	return result;
+}
+
+template<int N>
+void CubicCurve<N>::tessellate( int steps, Vector<N>* points ) const {
+	assert(steps >= 1);
+	const float h = 1.0f / static_cast<float>(steps);
+	const float h2 = h * h;
+	const float h3 = h2 * h;
+	// the third difference of a cubic is constant
+	Vector<N> point = coefficients_[0];
+	Vector<N> d1 = coefficients_[1] * h + coefficients_[2] * h2 + coefficients_[3] * h3;
+	Vector<N> d2 = coefficients_[2] * (2.0f * h2) + coefficients_[3] * (6.0f * h3);
+	const Vector<N> d3 = coefficients_[3] * (6.0f * h3);
+	for( int i = 0; i < steps; ++i ) {
+		points[i] = point;
+		point += d1;
+		d1 += d2;
+		d2 += d3;
+	}
+	points[steps] = evaluate(1.0f);
+}
+
+template<int N>
+Vector<N> const& CubicCurve<N>::coefficient( int i ) const {
+	return coefficients_[i];
+}
+
+template<int N>
+void tessellate( const CubicCurve<N>* curves, int count, int steps, Vector<N>* points ) {
+	for( int i = 0; i < count; ++i ) {
+		curves[i].tessellate(steps, points + i * (steps + 1));
+	}
+}
+
+template<int N>
+CubicSpline<N>::CubicSpline() {
+}
+
+template<int N>
+void CubicSpline<N>::setBezier( const Vector<N>* points, int count ) {
+	assert(count >= 4 && (count - 1) % 3 == 0);
+	const int numSegments = (count - 1) / 3;
+	segments_.resize(numSegments);
+	for( int i = 0; i < numSegments; ++i ) {
+		const Vector<N>* p = points + 3 * i;
+		segments_[i] = CubicCurve<N>::bezier(p[0], p[1], p[2], p[3]);
+	}
+}
+
+template<int N>
+void CubicSpline<N>::setCatmullRom( const Vector<N>* points, int count ) {
+	assert(count >= 2);
+	const int numSegments = count - 1;
+	segments_.resize(numSegments);
+	for( int i = 0; i < numSegments; ++i ) {
+		const Vector<N> before = (i > 0) ? points[i - 1] : 2.0f * points[0] - points[1];
+		const Vector<N> after = (i + 2 < count) ? points[i + 2] : 2.0f * points[count - 1] - points[count - 2];
+		segments_[i] = CubicCurve<N>::catmullRom(before, points[i], points[i + 1], after);
+	}
+}
+
+template<int N>
+int CubicSpline<N>::numSegments() const {
+	return static_cast<int>(segments_.size());
+}
+
+template<int N>
+CubicCurve<N> const& CubicSpline<N>::segment( int index ) const {
+	return segments_[index];
+}
+
+template<int N>
+int CubicSpline<N>::locate( float u, float& t ) const {
+	assert(!segments_.empty());
+	const int last = numSegments() - 1;
+	const int index = std::max(0, std::min(static_cast<int>(std::floor(u)), last));
+	t = clamp01(u - static_cast<float>(index));
+	return index;
+}
+
+template<int N>
+Vector<N> CubicSpline<N>::evaluate( float u ) const {
+	float t;
+	const int index = locate(u, t);
+	return segments_[index].evaluate(t);
+}
+
+template<int N>
+Vector<N> CubicSpline<N>::derivative( float u ) const {
+	float t;
+	const int index = locate(u, t);
+	return segments_[index].derivative(t);
+}
+
+template<int N>
+Vector<N> CubicSpline<N>::tangent( float u ) const {
+	float t;
+	const int index = locate(u, t);
+	return segments_[index].tangent(t);
+}
+
+template<int N>
+void CubicSpline<N>::tessellate( int stepsPerSegment, Vector<N>* points ) const {
+	// consecutive segments share their end points, so each one overwrites the last point of the previous one
+	for( int i = 0; i < numSegments(); ++i ) {
+		segments_[i].tessellate(stepsPerSegment, points + i * stepsPerSegment);
+	}
+}
+
+template<int N>
+ArcLengthTable<N>::ArcLengthTable()
+	: samplesPerSegment_(1) {
+}
+
+template<int N>
+void ArcLengthTable<N>::build( const CubicSpline<N>& spline, int samplesPerSegment ) {
+	assert(samplesPerSegment >= 1);
+	samplesPerSegment_ = samplesPerSegment;
+	const int numSamples = spline.numSegments() * samplesPerSegment + 1;
+	AlignedArray<Vector<N>> points(numSamples);
+	spline.tessellate(samplesPerSegment, points.data());
+
+	lengths_.resize(numSamples);
+	lengths_[0] = 0.0f;
+	for( int i = 1; i < numSamples; ++i ) {
+		lengths_[i] = lengths_[i - 1] + distance(points[i - 1], points[i]);
+	}
+}
+
+template<int N>
+float ArcLengthTable<N>::length() const {
+	return lengths_.empty() ? 0.0f : lengths_.back();
+}
+
+template<int N>
+float ArcLengthTable<N>::parameterAt( float distance ) const {
+	if( lengths_.size() < 2 || distance <= 0.0f ) {
+		return 0.0f;
+	}
+	const int last = static_cast<int>(lengths_.size()) - 1;
+	if( distance >= lengths_[last] ) {
+		return static_cast<float>(last) / static_cast<float>(samplesPerSegment_);
+	}
+
+	// the chord [i, i+1] containing the distance; linear within it
+	const int i = static_cast<int>(std::upper_bound(lengths_.begin(), lengths_.end(), distance) - lengths_.begin()) - 1;
+	const float chord = lengths_[i + 1] - lengths_[i];
+	const float fraction = (chord > 0.0f) ? (distance - lengths_[i]) / chord : 0.0f;
+	return (static_cast<float>(i) + fraction) / static_cast<float>(samplesPerSegment_);
+}
+
+template<int N>
+BezierPatch<N>::BezierPatch() {
+}
+
+template<int N>
+BezierPatch<N>::BezierPatch( const Vector<N>* controlPoints ) {
+	for( int row = 0; row < 4; ++row ) {
+		const Vector<N>* p = controlPoints + 4 * row;
+		rows_[row] = CubicCurve<N>::bezier(p[0], p[1], p[2], p[3]);
+	}
+}
+
+template<int N>
+Vector<N> BezierPatch<N>::evaluate( float u, float v ) const {
+	return CubicCurve<N>::bezier(rows_[0].evaluate(u), rows_[1].evaluate(u), rows_[2].evaluate(u), rows_[3].evaluate(u)).evaluate(v);
+}
+
+template<int N>
+Vector<N> BezierPatch<N>::derivativeU( float u, float v ) const {
+	return CubicCurve<N>::bezier(rows_[0].derivative(u), rows_[1].derivative(u), rows_[2].derivative(u), rows_[3].derivative(u)).evaluate(v);
+}
+
+template<int N>
+Vector<N> BezierPatch<N>::derivativeV( float u, float v ) const {
+	return CubicCurve<N>::bezier(rows_[0].evaluate(u), rows_[1].evaluate(u), rows_[2].evaluate(u), rows_[3].evaluate(u)).derivative(v);
+}
+
+template<int N>
+void BezierPatch<N>::tessellate( int uSteps, int vSteps, Vector<N>* points ) const {
+	// the u coefficients of the patch at a fixed v are cubics in v; forward difference them along v, and then
+	// each row of the grid along u
+	AlignedArray<Vector<N>> coefficients(4 * (vSteps + 1));
+	for( int i = 0; i < 4; ++i ) {
+		const CubicCurve<N> alongV = CubicCurve<N>::bezier(rows_[0].coefficient(i), rows_[1].coefficient(i), rows_[2].coefficient(i), rows_[3].coefficient(i));
+		alongV.tessellate(vSteps, coefficients.data() + i * (vSteps + 1));
+	}
+	for( int j = 0; j <= vSteps; ++j ) {
+		const CubicCurve<N> alongU(coefficients[j], coefficients[(vSteps + 1) + j], coefficients[2 * (vSteps + 1) + j], coefficients[3 * (vSteps + 1) + j]);
+		alongU.tessellate(uSteps, points + j * (uSteps + 1));
+	}
+}
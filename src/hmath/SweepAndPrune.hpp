@@ -0,0 +1,109 @@
+#ifndef __hmath_SweepAndPrune__
+#define __hmath_SweepAndPrune__
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <vector>
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include "Tracing.hpp"
+#include "Vector3.hpp"
+
+namespace hm {
+
+/**
+ * Box aligned with the coordinate axes.
+ */
+struct AxisAlignedBox {
+	Vector3 lower;
+	Vector3 upper;
+};
+
+/**
+ * Pair of overlapping boxes, by their indices in the input array, with first < second.
+ */
+struct BoxPair {
+	int first;
+	int second;
+};
+
+/**
+ * Sweep-and-prune broadphase: finds all pairs of overlapping AxisAlignedBoxes.
+ *
+ * The boxes are kept sorted by their lower bound along one axis.  Boxes move little from one frame to the next, so
+ * update() restores that order with an insertion sort, which takes close to linear time on nearly sorted input; it
+ * falls back to a full sort when the order changed too much.  The sort axis is chosen as the one along which the box
+ * centers spread the most, whenever the number of boxes changes.
+ *
+ * findPairs() sweeps the sorted boxes: each box is tested against the boxes after it until their lower bound passes
+ * its upper bound.  The bounds along all three axes are stored in sorted order as separate arrays, so SimdWidth
+ * candidates are tested per step with a few comparisons.  Boxes that touch count as overlapping.
+ *
+ * Boxes are identified by their index, so a body must keep its index across updates for the order to carry over.
+ */
+class SweepAndPrune {
+public:
+	SweepAndPrune();
+
+	/**
+	 * Updates the boxes and restores the sort order.
+	 *
+	 * @param boxes      Input boxes.
+	 * @param count      Number of boxes.  A different count than in the previous update sorts from scratch.
+	 * @param numThreads Number of threads; 0 uses all threads of the task executor.
+	 */
+	void update( const AxisAlignedBox* boxes, int count, int numThreads=0 );
+
+	/**
+	 * Finds all pairs of overlapping boxes, without allocating.  The pairs come in sweep order on one thread, and in no
+	 * particular order on several.
+	 *
+	 * @param pairs      Receives the pairs, up to capacity of them.
+	 * @param capacity   Number of pairs that fit into pairs.
+	 * @param numThreads Number of threads; 0 uses all threads of the task executor.
+	 * @return Number of overlapping pairs, which may be larger than capacity; the pairs past it are not written.
+	 */
+	int findPairs( BoxPair* pairs, int capacity, int numThreads=0 ) const;
+
+	void clear();
+
+	int size() const;
+	// axis the boxes are sorted along
+	int sortAxis() const;
+	// index of the box at each position of the sort order
+	std::vector<int> const& sortedIndices() const;
+
+private:
+	// pairs buffered per task before being copied to the output
+	static const int PairBatch = 256;
+	// number of boxes per task of the sweep
+	static const int SweepGrain = 1024;
+	// moves per box after which the insertion sort gives up for a full sort
+	static const int MaxMovesPerBox = 8;
+
+	// sorts entries_ by key; incrementally if that takes few moves, fully otherwise
+	void sortEntries();
+	// copies the bounds of the boxes into the sweep arrays in sort order
+	void gatherBounds( const AxisAlignedBox* boxes, int numThreads );
+
+	struct Entry {
+		float key;
+		int index;
+	};
+
+	int count_;
+	int axis_;
+	std::vector<Entry> entries_;
+	std::vector<int> sortedIndices_;
+	// bounds in sort order, followed by SimdWidth NaN entries that overlap nothing; 0 is the sort axis
+	std::vector<float> lower_[3];
+	std::vector<float> upper_[3];
+};
+
+#include "SweepAndPrune.inl"
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+inline SweepAndPrune::SweepAndPrune()
+	: count_(0), axis_(0) {
+}
+
+inline void SweepAndPrune::update( const AxisAlignedBox* boxes, int count, int numThreads ) {
+	HMATH_TRACE_BATCH(SweepAndPruneUpdate, 0, count);
+	count = std::max(count, 0);
+
+	if( count != count_ ) {
+		// new boxes: sort along the axis of largest spread from scratch
+		count_ = count;
+		double sum[3] = {0.0, 0.0, 0.0};
+		double sqrSum[3] = {0.0, 0.0, 0.0};
+		for( int i = 0; i < count; ++i ) {
+			for( int a = 0; a < 3; ++a ) {
+				const double center = 0.5 * (static_cast<double>(boxes[i].lower[a]) + boxes[i].upper[a]);
+				sum[a] += center;
+				sqrSum[a] += center * center;
+			}
+		}
+		axis_ = 0;
+		for( int a = 1; a < 3; ++a ) {
+			// variance times count squared
+			if( count * sqrSum[a] - sum[a] * sum[a] > count * sqrSum[axis_] - sum[axis_] * sum[axis_] ) {
+				axis_ = a;
+			}
+		}
+		entries_.resize(count);
+		for( int i = 0; i < count; ++i ) {
+			entries_[i].key = boxes[i].lower[axis_];
+			entries_[i].index = i;
+		}
+		std::sort(entries_.begin(), entries_.end(), []( const Entry& a, const Entry& b ) {
+			return a.key < b.key;
+		});
+	} else {
+		const int axis = axis_;
+		Entry* entries = entries_.data();
+		parallelFor(0, count, 0, [=]( int first, int last ) {
+			for( int s = first; s < last; ++s ) {
+				entries[s].key = boxes[entries[s].index].lower[axis];
+			}
+		}, numThreads);
+		sortEntries();
+	}
+
+	gatherBounds(boxes, numThreads);
+}
+
+inline void SweepAndPrune::sortEntries() {
+	const int count = static_cast<int>(entries_.size());
+	const long long maxMoves = static_cast<long long>(MaxMovesPerBox) * count;
+	long long moves = 0;
+	for( int i = 1; i < count; ++i ) {
+		const Entry entry = entries_[i];
+		int j = i;
+		while( j > 0 && entries_[j - 1].key > entry.key ) {
+			entries_[j] = entries_[j - 1];
+			--j;
+		}
+		entries_[j] = entry;
+		moves += i - j;
+		if( moves > maxMoves ) {
+			// too far from sorted for insertion; the entries are still a permutation
+			std::sort(entries_.begin(), entries_.end(), []( const Entry& a, const Entry& b ) {
+				return a.key < b.key;
+			});
+			return;
+		}
+	}
+}
+
+inline void SweepAndPrune::gatherBounds( const AxisAlignedBox* boxes, int numThreads ) {
+	const int count = count_;
+	const int padded = count + SimdWidth;
+	sortedIndices_.resize(count);
+	for( int a = 0; a < 3; ++a ) {
+		// the padding is NaN, which fails every comparison, even against infinite bounds
+		lower_[a].resize(padded);
+		upper_[a].resize(padded);
+		std::fill(lower_[a].begin() + count, lower_[a].end(), std::numeric_limits<float>::quiet_NaN());
+		std::fill(upper_[a].begin() + count, upper_[a].end(), std::numeric_limits<float>::quiet_NaN());
+	}
+
+	const int axes[3] = {axis_, (axis_ + 1) % 3, (axis_ + 2) % 3};
+	const Entry* entries = entries_.data();
+	int* indices = sortedIndices_.data();
+	float* lower[3] = {lower_[0].data(), lower_[1].data(), lower_[2].data()};
+	float* upper[3] = {upper_[0].data(), upper_[1].data(), upper_[2].data()};
+	parallelFor(0, count, 0, [&]( int first, int last ) {
+		for( int s = first; s < last; ++s ) {
+			const int index = entries[s].index;
+			const AxisAlignedBox& box = boxes[index];
+			indices[s] = index;
+			for( int a = 0; a < 3; ++a ) {
+				lower[a][s] = box.lower[axes[a]];
+				upper[a][s] = box.upper[axes[a]];
+			}
+		}
+	}, numThreads);
+}
+
+inline int SweepAndPrune::findPairs( BoxPair* pairs, int capacity, int numThreads ) const {
+	HMATH_TRACE_BATCH(SweepAndPrunePairs, 0, count_);
+	const int* indices = sortedIndices_.data();
+	const float* lower0 = lower_[0].data();
+	const float* upper0 = upper_[0].data();
+	const float* lower1 = lower_[1].data();
+	const float* upper1 = upper_[1].data();
+	const float* lower2 = lower_[2].data();
+	const float* upper2 = upper_[2].data();
+	std::atomic<int> total(0);
+
+	parallelFor(0, count_, SweepGrain, [&]( int first, int last ) {
+		using simd::Float;
+		const int W = SimdWidth;
+		const unsigned allLanes = (1u << W) - 1u;
+		BoxPair batch[PairBatch];
+		int numBatched = 0;
+		const auto flush = [&]() {
+			const int offset = total.fetch_add(numBatched);
+			const int n = std::min(numBatched, capacity - offset);
+			for( int k = 0; k < n; ++k ) {
+				pairs[offset + k] = batch[k];
+			}
+			numBatched = 0;
+		};
+
+		for( int s = first; s < last; ++s ) {
+			const int self = indices[s];
+			const Float end(upper0[s]);
+			const Float lo1(lower1[s]), hi1(upper1[s]);
+			const Float lo2(lower2[s]), hi2(upper2[s]);
+			// the boxes after s overlap it along the sort axis up to the first that starts past its end; the sweep
+			// also stops at the last box, so every load stays within the padding
+			for( int j = s + 1; j < count_; j += W ) {
+				const simd::Mask inRange = Float::load(lower0 + j) <= end;
+				const simd::Mask overlap = inRange & (Float::load(lower1 + j) <= hi1) & (Float::load(upper1 + j) >= lo1) &
+					(Float::load(lower2 + j) <= hi2) & (Float::load(upper2 + j) >= lo2);
+				unsigned bits = overlap.bits();
+				for( int lane = 0; bits != 0; ++lane, bits >>= 1 ) {
+					if( bits & 1u ) {
+						const int other = indices[j + lane];
+						batch[numBatched].first = std::min(self, other);
+						batch[numBatched].second = std::max(self, other);
+						if( ++numBatched == PairBatch ) {
+							flush();
+						}
+					}
+				}
+				if( inRange.bits() != allLanes ) {
+					break;
+				}
+			}
+		}
+		if( numBatched > 0 ) {
+			flush();
+		}
+	}, numThreads);
+	return total.load();
+}
+
+inline void SweepAndPrune::clear() {
+	count_ = 0;
+	axis_ = 0;
+	entries_.clear();
+	sortedIndices_.clear();
+	for( int a = 0; a < 3; ++a ) {
+		lower_[a].clear();
+		upper_[a].clear();
+	}
+}
+
+inline int SweepAndPrune::size() const {
+	return count_;
+}
+
+inline int SweepAndPrune::sortAxis() const {
+	return axis_;
+}
+
+inline std::vector<int> const& SweepAndPrune::sortedIndices() const {
+	return sortedIndices_;
+}
@@ -0,0 +1,35 @@
+#ifndef __hmath_SymmetricEigen__
+#define __hmath_SymmetricEigen__
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "Matrix.hpp"
+#include "Tracing.hpp"
+#include "Vector.hpp"
+
+namespace hm {
+
+/**
+ * Computes the eigenvalues and eigenvectors of a symmetric Matrix, M = V diag(eigenvalues) V^T, with cyclic Jacobi
+ * rotations.
+ *
+ * Each rotation zeroes one off-diagonal entry; a sweep rotates every pair once, and convergence is quadratic, so a 3x3
+ * covariance Matrix takes three or four sweeps.  Unlike the characteristic polynomial, the rotations stay accurate for
+ * repeated and tiny eigenvalues, and the eigenvectors come out orthonormal.
+ *
+ * @param M            Symmetric input Matrix.
+ * @param eigenvalues  Receives the eigenvalues, largest first.
+ * @param eigenvectors Receives the unit eigenvectors as columns, in the order of the eigenvalues.
+ * @param maxSweeps    Maximum number of sweeps.
+ * @return Whether or not the off-diagonal entries converged to rounding noise.
+ */
+template<int N>
+inline bool symmetricEigen( const Matrix<N, N>& M, Vector<N>& eigenvalues, Matrix<N, N>& eigenvectors, int maxSweeps=32 );
+
+#include "SymmetricEigen.inl"
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+template<int N>
+bool symmetricEigen( const Matrix<N, N>& M, Vector<N>& eigenvalues, Matrix<N, N>& eigenvectors, int maxSweeps ) {
+	HMATH_TRACE_SCOPE(SymmetricEigen, N);
+	Matrix<N, N> A = M;
+	Matrix<N, N> V = Matrix<N, N>::identity();
+
+	float norm = 0.0f;
+	for( int i = 0; i < N * N; ++i ) {
+		norm += A[i] * A[i];
+	}
+	// off-diagonal mass below this is rounding noise of the diagonal
+	const float epsilon = std::numeric_limits<float>::epsilon();
+	const float tolerance = epsilon * epsilon * norm;
+
+	const auto isDiagonal = [&A, tolerance]() {
+		float off = 0.0f;
+		for( int p = 0; p < N; ++p ) {
+			for( int q = p + 1; q < N; ++q ) {
+				off += A(p, q) * A(p, q);
+			}
+		}
+		return off <= tolerance;
+	};
+
+	// checked after every sweep, so that converging on the last allowed one still counts
+	bool converged = isDiagonal();
+	for( int sweep = 0; sweep < maxSweeps && !converged; ++sweep ) {
+		for( int p = 0; p < N; ++p ) {
+			for( int q = p + 1; q < N; ++q ) {
+				const float apq = A(p, q);
+				if( apq == 0.0f ) {
+					continue;
+				}
+				// the smaller of the two rotation angles that zero A(p, q)
+				const float theta = (A(q, q) - A(p, p)) / (2.0f * apq);
+				const float t = std::copysign(1.0f, theta) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0f));
+				const float c = 1.0f / std::sqrt(t * t + 1.0f);
+				const float s = t * c;
+
+				for( int k = 0; k < N; ++k ) {
+					const float akp = A(k, p);
+					const float akq = A(k, q);
+					A(k, p) = c * akp - s * akq;
+					A(k, q) = s * akp + c * akq;
+				}
+				for( int k = 0; k < N; ++k ) {
+					const float apk = A(p, k);
+					const float aqk = A(q, k);
+					A(p, k) = c * apk - s * aqk;
+					A(q, k) = s * apk + c * aqk;
+				}
+				for( int k = 0; k < N; ++k ) {
+					const float vkp = V(k, p);
+					const float vkq = V(k, q);
+					V(k, p) = c * vkp - s * vkq;
+					V(k, q) = s * vkp + c * vkq;
+				}
+			}
+		}
+		converged = isDiagonal();
+	}
+
+	// selection sort, largest first; N is small
+	int order[N];
+	for( int i = 0; i < N; ++i ) {
+		order[i] = i;
+	}
+	for( int i = 0; i < N; ++i ) {
+		int largest = i;
+		for( int j = i + 1; j < N; ++j ) {
+			if( A(order[j], order[j]) > A(order[largest], order[largest]) ) {
+				largest = j;
+			}
+		}
+		std::swap(order[i], order[largest]);
+	}
+	for( int i = 0; i < N; ++i ) {
+		eigenvalues[i] = A(order[i], order[i]);
+		for( int k = 0; k < N; ++k ) {
+			eigenvectors(k, i) = V(k, order[i]);
+		}
+	}
+	return converged;
+}
@@ -0,0 +1,135 @@
+#ifndef __hmath_ThreadRegistry__
+#define __hmath_ThreadRegistry__
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "Aligned.hpp"
+
+namespace hm {
+
+namespace detail {
+
+/**
+ * Event count written only by its owning thread.
+ *
+ * Other threads never write the value, so the owner's relaxed load/store increment cannot overwrite them.  Instead,
+ * reset() records the current value as a baseline that read() subtracts: an increment racing with the reset either
+ * lands before the baseline or is counted after it, and the count never comes back to its value before the reset.
+ * The baseline is only accessed under the registry lock.
+ */
+struct ThreadCount {
+	std::atomic<std::uint64_t> value;
+	std::uint64_t baseline;
+
+	ThreadCount() : value(0), baseline(0) {
+	}
+
+	// called by the owning thread only; a relaxed load/store pair avoids a locked read-modify-write while still
+	// letting other threads read the value safely
+	void add( std::uint64_t n ) {
+		value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+
+	void reset() {
+		baseline = value.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t read() const {
+		return value.load(std::memory_order_relaxed) - baseline;
+	}
+};
+
+/**
+ * Hands out one Block per thread and aggregates all of them into a Snapshot.
+ *
+ * Block must be default constructible and provide reset() and addTo(Snapshot&) const; it is expected to be
+ * cache-line-aligned and made of ThreadCounts written only by its owning thread.  reset() and addTo() are only called
+ * under the registry lock, which is taken once when a thread first touches its block, when it exits, when
+ * aggregating and when resetting, never on the hot path.
+ */
+template<typename Block, typename Snapshot>
+class ThreadRegistry {
+public:
+	static ThreadRegistry& instance() {
+		// intentionally leaked so that threads exiting during static destruction can still retire their blocks
+		static ThreadRegistry* registry = new ThreadRegistry();
+		return *registry;
+	}
+
+	// returns the calling thread's block, creating it on first use
+	static Block& local() {
+		thread_local Holder holder;
+		return *holder.block;
+	}
+
+	Snapshot snapshot() {
+		Snapshot result;
+		snapshot(result);
+		return result;
+	}
+
+	// overwrites result, so that large snapshots can reuse a buffer
+	void snapshot( Snapshot& result ) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		result = retired_;
+		for( auto block : live_ ) {
+			block->addTo(result);
+		}
+	}
+
+	void reset() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		retired_ = Snapshot();
+		for( auto block : live_ ) {
+			block->reset();
+		}
+	}
+
+private:
+	struct Holder {
+		Holder() : block(instance().acquire()) {
+		}
+		~Holder() {
+			instance().retire(block);
+		}
+		Block* block;
+	};
+
+	Block* acquire() {
+		// placement into aligned memory, as over-aligned new is not available before C++17
+		void* memory = alignedMalloc(sizeof(Block), alignof(Block));
+		if( !memory ) {
+			throw std::bad_alloc();
+		}
+		Block* block = new(memory) Block();
+		std::lock_guard<std::mutex> lock(mutex_);
+		live_.push_back(block);
+		return block;
+	}
+
+	void retire( Block* block ) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		block->addTo(retired_);
+		for( auto it = live_.begin(); it != live_.end(); ++it ) {
+			if( *it == block ) {
+				live_.erase(it);
+				break;
+			}
+		}
+		block->~Block();
+		alignedFree(block);
+	}
+
+	std::mutex mutex_;
+	std::vector<Block*> live_;
+	Snapshot retired_;
+};
+
+}
+
+}
+
+#endif
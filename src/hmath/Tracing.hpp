@@ -0,0 +1,351 @@
+#ifndef __hmath_Tracing__
+#define __hmath_Tracing__
+
+#include <cstdint>
+
+#if defined(HMATH_TRACING)
+#include <atomic>
+#include <chrono>
+#include <new>
+#include "ThreadRegistry.hpp"
+#if defined(HMATH_TRACING_TSC)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+#endif
+#endif
+
+/**
+ * Optional latency tracing of hmath's expensive entry points.
+ *
+ * Define HMATH_TRACING (identically in every translation unit) to enable it.  Traced functions open a ScopedTimer whose
+ * duration is recorded into the calling thread's histograms without locking, and is forwarded to the installed
+ * TraceSink, if any.  Durations are measured in ticks of std::chrono::steady_clock, or of the CPU time stamp counter
+ * when HMATH_TRACING_TSC is also defined; traceTicksPerSecond converts them.  Without HMATH_TRACING the tracing macros
+ * expand to nothing and snapshots are always empty.
+ */
+#define HMATH_TRACE_CONCAT_IMPL(a, b) a##b
+#define HMATH_TRACE_CONCAT(a, b) HMATH_TRACE_CONCAT_IMPL(a, b)
+#if defined(HMATH_TRACING)
+	#define HMATH_TRACE_SCOPE(span, arg) ::hm::ScopedTimer HMATH_TRACE_CONCAT(hmathTimer, __LINE__)(::hm::Span::span, (arg), 1)
+	#define HMATH_TRACE_BATCH(span, arg, items) ::hm::ScopedTimer HMATH_TRACE_CONCAT(hmathTimer, __LINE__)(::hm::Span::span, (arg), (items))
+#else
+	#define HMATH_TRACE_SCOPE(span, arg) ((void)0)
+	#define HMATH_TRACE_BATCH(span, arg, items) ((void)0)
+#endif
+
+namespace hm {
+
+enum class Span : int {
+	GaussianElimination, // argument: number of rows
+	Inverse,             // argument: matrix dimension
+	InverseBatch,        // argument: matrix dimension; items: number of matrices
+	NormalMatrixBatch,   // items: number of matrices
+	MultiplyBatch,       // argument: inner dimension; items: number of products
+	SampleTracksBatch,   // argument: value dimension; items: number of tracks
+	NoiseBatch,          // argument: dimension; items: number of points
+	ScreenRaysBatch,     // items: number of rays
+	Cholesky,            // argument: number of rows
+	CholeskyBatch,       // argument: matrix dimension; items: number of matrices
+	LeastSquaresBatch,   // argument: number of unknowns; items: number of rows
+	SymmetricEigen,      // argument: matrix dimension
+	CovarianceBatch,     // argument: point dimension; items: number of points
+	ConvexHullBuild,     // items: number of points
+	SweepAndPruneUpdate, // items: number of boxes
+	SweepAndPrunePairs,  // items: number of boxes
+
+	NumSpans
+};
+
+const static int NumSpans = static_cast<int>(Span::NumSpans);
+
+/* Span arguments are bucketed exactly up to this value; the last bucket holds all larger arguments. */
+const static int MaxTracedArgument = 16;
+
+/* Durations are bucketed by powers of two: bucket b holds durations in [2^b, 2^(b+1)) ticks, bucket 0 also holds 0. */
+const static int NumDurationBuckets = 40;
+
+/**
+ * A completed span, as passed to a TraceSink.
+ */
+struct TraceEvent {
+	Span span;
+	int argument;
+	std::uint64_t items;
+	std::uint64_t start;    // ticks
+	std::uint64_t duration; // ticks
+};
+
+/**
+ * Receives every completed span, on the thread that ran it.  Implementations must be thread-safe and cheap.
+ */
+class TraceSink {
+public:
+	virtual ~TraceSink() {
+	}
+	virtual void onSpan( const TraceEvent& event ) = 0;
+};
+
+struct SpanHistogram {
+	std::uint64_t calls;
+	std::uint64_t items;
+	std::uint64_t totalTicks;
+	std::uint64_t buckets[MaxTracedArgument + 1][NumDurationBuckets];
+};
+
+struct TraceSnapshot {
+	SpanHistogram spans[NumSpans];
+
+	TraceSnapshot() {
+		for( auto& span : spans ) {
+			span.calls = span.items = span.totalTicks = 0;
+			for( auto& row : span.buckets ) {
+				for( auto& value : row ) {
+					value = 0;
+				}
+			}
+		}
+	}
+
+	SpanHistogram const& operator[]( Span span ) const {
+		return spans[static_cast<int>(span)];
+	}
+};
+
+/**
+ * Returns a stable name for a span, suitable as a metric key.
+ *
+ * @param span Span to name.
+ */
+inline const char* spanName( Span span ) {
+	switch( span ) {
+		case Span::GaussianElimination: return "gaussian_elimination";
+		case Span::Inverse: return "inverse";
+		case Span::InverseBatch: return "inverse.batch";
+		case Span::NormalMatrixBatch: return "normal_matrix.batch";
+		case Span::MultiplyBatch: return "multiply.batch";
+		case Span::SampleTracksBatch: return "sample_tracks.batch";
+		case Span::NoiseBatch: return "noise.batch";
+		case Span::ScreenRaysBatch: return "screen_rays.batch";
+		case Span::Cholesky: return "cholesky";
+		case Span::CholeskyBatch: return "cholesky.batch";
+		case Span::LeastSquaresBatch: return "least_squares.batch";
+		case Span::SymmetricEigen: return "symmetric_eigen";
+		case Span::CovarianceBatch: return "covariance.batch";
+		case Span::ConvexHullBuild: return "convex_hull.build";
+		case Span::SweepAndPruneUpdate: return "sweep_and_prune.update";
+		case Span::SweepAndPrunePairs: return "sweep_and_prune.pairs";
+		default: return "unknown";
+	}
+}
+
+#if defined(HMATH_TRACING)
+namespace detail {
+
+inline std::uint64_t traceTicks() {
+#if defined(HMATH_TRACING_TSC)
+	return __rdtsc();
+#else
+	return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline int durationBucket( std::uint64_t ticks ) {
+	int bucket = 0;
+	while( ticks > 1 && bucket < NumDurationBuckets - 1 ) {
+		ticks >>= 1;
+		++bucket;
+	}
+	return bucket;
+}
+
+// Per-thread counts.  A span's duration histogram for one argument is only allocated the first time the thread records
+// into it, so a block holds the few histograms its thread uses rather than all NumSpans * (MaxTracedArgument + 1).
+struct alignas(CacheLineSize) TraceBlock {
+	struct Histogram {
+		ThreadCount buckets[NumDurationBuckets];
+	};
+	struct Span {
+		ThreadCount calls;
+		ThreadCount items;
+		ThreadCount totalTicks;
+		std::atomic<Histogram*> histograms[MaxTracedArgument + 1];
+	};
+	Span spans[NumSpans];
+
+	TraceBlock() {
+		for( auto& span : spans ) {
+			for( auto& histogram : span.histograms ) {
+				histogram.store(nullptr, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	~TraceBlock() {
+		for( auto& span : spans ) {
+			for( auto& histogram : span.histograms ) {
+				delete histogram.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	TraceBlock( const TraceBlock& ) = delete;
+	TraceBlock& operator=( const TraceBlock& ) = delete;
+
+	// called by the owning thread only; null if the histogram could not be allocated
+	Histogram* histogram( int span, int argument ) {
+		std::atomic<Histogram*>& slot = spans[span].histograms[argument];
+		Histogram* histogram = slot.load(std::memory_order_relaxed);
+		if( !histogram ) {
+			histogram = new(std::nothrow) Histogram();
+			slot.store(histogram, std::memory_order_release);
+		}
+		return histogram;
+	}
+
+	void reset() {
+		for( auto& span : spans ) {
+			span.calls.reset();
+			span.items.reset();
+			span.totalTicks.reset();
+			for( auto& slot : span.histograms ) {
+				if( Histogram* histogram = slot.load(std::memory_order_acquire) ) {
+					for( auto& count : histogram->buckets ) {
+						count.reset();
+					}
+				}
+			}
+		}
+	}
+
+	void addTo( TraceSnapshot& snapshot ) const {
+		for( int s = 0; s < NumSpans; ++s ) {
+			snapshot.spans[s].calls += spans[s].calls.read();
+			snapshot.spans[s].items += spans[s].items.read();
+			snapshot.spans[s].totalTicks += spans[s].totalTicks.read();
+			for( int a = 0; a <= MaxTracedArgument; ++a ) {
+				if( const Histogram* histogram = spans[s].histograms[a].load(std::memory_order_acquire) ) {
+					for( int b = 0; b < NumDurationBuckets; ++b ) {
+						snapshot.spans[s].buckets[a][b] += histogram->buckets[b].read();
+					}
+				}
+			}
+		}
+	}
+};
+
+using TraceRegistry = ThreadRegistry<TraceBlock, TraceSnapshot>;
+
+inline std::atomic<TraceSink*>& traceSink() {
+	static std::atomic<TraceSink*> sink(nullptr);
+	return sink;
+}
+
+}
+
+/**
+ * Times the enclosing scope and records it under the given span.
+ */
+class ScopedTimer {
+public:
+	ScopedTimer( Span span, int argument, std::uint64_t items )
+		: span_(span), argument_(argument), items_(items), start_(detail::traceTicks()) {
+	}
+
+	~ScopedTimer() {
+		const std::uint64_t end = detail::traceTicks();
+		const std::uint64_t duration = (end > start_) ? end - start_ : 0;
+
+		const int argBucket = (argument_ < 0) ? 0 : (argument_ < MaxTracedArgument ? argument_ : MaxTracedArgument);
+		auto& block = detail::TraceRegistry::local();
+		auto& span = block.spans[static_cast<int>(span_)];
+		span.calls.add(1);
+		span.items.add(items_);
+		span.totalTicks.add(duration);
+		if( auto histogram = block.histogram(static_cast<int>(span_), argBucket) ) {
+			histogram->buckets[detail::durationBucket(duration)].add(1);
+		}
+
+		if( TraceSink* sink = detail::traceSink().load(std::memory_order_acquire) ) {
+			const TraceEvent event = {span_, argument_, items_, start_, duration};
+			sink->onSpan(event);
+		}
+	}
+
+	ScopedTimer( const ScopedTimer& ) = delete;
+	ScopedTimer& operator=( const ScopedTimer& ) = delete;
+
+private:
+	Span span_;
+	int argument_;
+	std::uint64_t items_;
+	std::uint64_t start_;
+};
+#endif
+
+/**
+ * Installs a sink that receives every completed span, or removes it when null.  The sink must outlive all spans that
+ * may still be running when it is replaced.
+ *
+ * @param sink Sink to install.
+ */
+inline void setTraceSink( TraceSink* sink ) {
+#if defined(HMATH_TRACING)
+	detail::traceSink().store(sink, std::memory_order_release);
+#else
+	(void)sink;
+#endif
+}
+
+/**
+ * Returns the number of trace ticks per second.  With HMATH_TRACING_TSC the time stamp counter is calibrated against
+ * steady_clock on first use, which takes about 10 milliseconds.
+ */
+inline double traceTicksPerSecond() {
+#if defined(HMATH_TRACING) && defined(HMATH_TRACING_TSC)
+	static const double ticksPerSecond = []() {
+		const auto clockStart = std::chrono::steady_clock::now();
+		const std::uint64_t tickStart = detail::traceTicks();
+		while( std::chrono::steady_clock::now() - clockStart < std::chrono::milliseconds(10) ) {
+		}
+		const std::uint64_t ticks = detail::traceTicks() - tickStart;
+		const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - clockStart;
+		return static_cast<double>(ticks) / seconds.count();
+	}();
+	return ticksPerSecond;
+#elif defined(HMATH_TRACING)
+	return static_cast<double>(std::chrono::steady_clock::period::den) / std::chrono::steady_clock::period::num;
+#else
+	return 1.0;
+#endif
+}
+
+/**
+ * Writes the span histograms summed over all threads, including threads that have exited.  A snapshot holds every
+ * histogram, which is large, so it is filled in place and can be reused from one call to the next.
+ *
+ * @param snapshot Receives the histograms.
+ */
+inline void traceSnapshot( TraceSnapshot& snapshot ) {
+#if defined(HMATH_TRACING)
+	detail::TraceRegistry::instance().snapshot(snapshot);
+#else
+	snapshot = TraceSnapshot();
+#endif
+}
+
+/**
+ * Resets the histograms of all threads.  A span racing with the reset is either recorded before or after it; the
+ * histograms never return to their values before the reset.
+ */
+inline void resetTracing() {
+#if defined(HMATH_TRACING)
+	detail::TraceRegistry::instance().reset();
+#endif
+}
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef __hmath_Unroll__
+#define __hmath_Unroll__
+
+#include <type_traits>
+#include <utility>
+
+namespace hm {
+
+namespace detail {
+
+/**
+ * Longest loop that unroll and unrolledSum expand at compile time; longer ones stay loops so that code size stays
+ * reasonable.  This covers every element of an 8x8 matrix.
+ */
+const static int MaxUnrolledCount = 64;
+
+template<typename Fn, int... I>
+inline void unrollImpl( Fn& fn, std::integer_sequence<int, I...> ) {
+	const int expand[] = {0, (fn(std::integral_constant<int, I>()), 0)...};
+	(void)expand;
+}
+
+template<int N, typename Fn>
+inline void unrollImpl( Fn& fn, std::false_type ) {
+	for( int i = 0; i < N; ++i ) {
+		fn(i);
+	}
+}
+
+template<int N, typename Fn>
+inline void unrollImpl( Fn& fn, std::true_type ) {
+	unrollImpl(fn, std::make_integer_sequence<int, N>());
+}
+
+/**
+ * Calls fn(i) for i in [0, N) in order.  Up to MaxUnrolledCount, the calls are expanded at compile time and i is a
+ * std::integral_constant<int>, which converts to int wherever fn uses it as one; beyond that, fn is called in a loop.
+ */
+template<int N, typename Fn>
+inline void unroll( Fn&& fn ) {
+	unrollImpl<N>(fn, std::integral_constant<bool, (N <= MaxUnrolledCount)>());
+}
+
+/**
+ * Returns fn(0) + fn(1) + ... + fn(N - 1), summed left to right.  Expanded at compile time like unroll.
+ */
+template<int N, typename Fn>
+inline float unrolledSum( Fn&& fn ) {
+	float sum = 0.0f;
+	unroll<N>([&]( auto i ) {
+		sum += fn(i);
+	});
+	return sum;
+}
+
+}
+
+}
+
+#endif
@@ -5,13 +5,15 @@
 #include <initializer_list>
 #include <cassert>
 #include <type_traits>
+#include "Aligned.hpp"
 #include "Constants.hpp"
 #include "Functions.hpp"
+#include "Instrumentation.hpp"
 
 namespace hm {
 
 template<int N>
-class Vector {
+class alignas(VectorAlignment<N>::value) Vector {
 public:
 	Vector();
 	Vector( const std::array<float, N>& values );
@@ -251,10 +251,12 @@ float sqrLength( const Vector<N>& vec ) {
 
 template<int N>
 float normalize( Vector<N>& vec ) {
+	HMATH_COUNT(NormalizeCalls);
 	const float length = sqrtf(dot(vec, vec));
 	if( length > 0.0f ) {
 		vec /= length;
 	} else {
+		HMATH_COUNT(NormalizeZeroLength);
 		vec.makeZero();
 	}
 	return length;
@@ -262,6 +264,7 @@ float normalize( Vector<N>& vec ) {
 
 template<int N>
 float normalizeRobust( Vector<N>& vec ) {
+	HMATH_COUNT(NormalizeCalls);
 	float maxAbsComp = fabsf(vec[0]);
 	for( int i = 1; i < N; ++i ) {
 		const float absComp = fabsf(vec[i]);
@@ -275,6 +278,7 @@ float normalizeRobust( Vector<N>& vec ) {
 		vec /= length;
 		length *= maxAbsComp;
 	} else {
+		HMATH_COUNT(NormalizeZeroLength);
 		length = 0.0f;
 		vec.makeZero();
 	}
@@ -0,0 +1,110 @@
+#include "CppUnitTest.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <hmath/AnimationTrack.hpp>
+#include <hmath/Vector3.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(AnimationTrackTest) {
+	static void assertNear( const hm::Vector3& expected, const hm::Vector3& actual, float tolerance=1e-5f ) {
+		for( int c = 0; c < 3; ++c ) {
+			Assert::AreEqual(expected[c], actual[c], tolerance);
+		}
+	}
+
+	static hm::AnimationTrack<3> randomTrack( std::mt19937& rng, hm::Interpolation interpolation, int count ) {
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		std::vector<float> times(count);
+		std::vector<hm::Vector3> values(count);
+		float time = dist(rng);
+		for( int k = 0; k < count; ++k ) {
+			time += 0.1f + std::fabs(dist(rng));
+			times[k] = time;
+			values[k] = {dist(rng), dist(rng), dist(rng)};
+		}
+		hm::AnimationTrack<3> track;
+		track.setKeys(times.data(), values.data(), count, interpolation);
+		return track;
+	}
+
+	TEST_METHOD(Interpolate) {
+		const float times[] = {0.0f, 1.0f, 3.0f};
+		const hm::Vector3 values[] = {{0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f}, {3.0f, 2.0f, 1.0f}};
+
+		hm::AnimationTrack<3> linear;
+		linear.setKeys(times, values, 3, hm::Interpolation::Linear);
+		assertNear(values[0], linear.sample(-1.0f));
+		assertNear(hm::lerp(values[0], values[1], 0.25f), linear.sample(0.25f));
+		assertNear(hm::lerp(values[1], values[2], 0.5f), linear.sample(2.0f));
+		assertNear(values[2], linear.sample(5.0f));
+
+		hm::AnimationTrack<3> step;
+		step.setKeys(times, values, 3, hm::Interpolation::Step);
+		assertNear(values[0], step.sample(0.99f));
+		assertNear(values[1], step.sample(1.0f));
+		assertNear(values[1], step.sample(2.9f));
+		assertNear(values[2], step.sample(3.0f));
+
+		// Hermite with explicit tangents passes through the keys with the given derivatives
+		const hm::Vector3 inTangents[] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+		const hm::Vector3 outTangents[] = {{2.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f}, {0.0f, 0.0f, 2.0f}};
+		hm::AnimationTrack<3> hermite;
+		hermite.setKeys(times, values, inTangents, outTangents, 3);
+		assertNear(values[1], hermite.sample(1.0f));
+		const float h = 1e-3f;
+		const hm::Vector3 arriving = (hermite.sample(1.0f) - hermite.sample(1.0f - h)) / h;
+		const hm::Vector3 leaving = (hermite.sample(1.0f + h) - hermite.sample(1.0f)) / h;
+		assertNear(inTangents[1], arriving, 1e-2f);
+		assertNear(outTangents[1], leaving, 1e-2f);
+
+		// automatic tangents reproduce a linear motion exactly
+		const hm::Vector3 line[] = {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {3.0f, 3.0f, 3.0f}};
+		hm::AnimationTrack<3> automatic;
+		automatic.setKeys(times, line, 3, hm::Interpolation::Hermite);
+		assertNear(hm::Vector3({2.0f, 2.0f, 2.0f}), automatic.sample(2.0f));
+
+		hm::AnimationTrack<3> empty;
+		assertNear(hm::Vector3({0.0f, 0.0f, 0.0f}), empty.sample(1.0f));
+	}
+
+	TEST_METHOD(Sampler) {
+		std::mt19937 rng(1);
+		const hm::AnimationTrack<3> track = randomTrack(rng, hm::Interpolation::Hermite, 50);
+		hm::AnimationSampler<3> sampler(&track);
+		// forwards, then a jump backwards, then forwards again
+		for( float time : {-2.0f, 0.0f, 0.5f, 0.51f, 3.0f, 3.05f, 100.0f, 1.0f, 1.2f, 1.4f} ) {
+			assertNear(track.sample(time), sampler.sample(time), 0.0f);
+		}
+		for( int s = 0; s < track.size() - 1; ++s ) {
+			const float time = track.keyTime(s);
+			Assert::AreEqual(track.findSegment(time), track.findSegment(time, s > 0 ? s - 1 : -1));
+		}
+	}
+
+	TEST_METHOD(Batch) {
+		std::mt19937 rng(2);
+		std::vector<hm::AnimationTrack<3>> tracks;
+		for( int i = 0; i < 37; ++i ) {
+			tracks.push_back(randomTrack(rng, static_cast<hm::Interpolation>(i % 3), i % 7));
+		}
+		const int count = static_cast<int>(tracks.size());
+		std::vector<int> hints(count, -1);
+		std::vector<hm::Vector3> results(count);
+		for( float time = -1.0f; time < 6.0f; time += 0.37f ) {
+			hm::sampleTracks(tracks.data(), count, time, results.data(), hints.data());
+			for( int i = 0; i < count; ++i ) {
+				assertNear(tracks[i].sample(time), results[i]);
+			}
+		}
+		hm::sampleTracks(tracks.data(), count, 2.0f, results.data());
+		for( int i = 0; i < count; ++i ) {
+			assertNear(tracks[i].sample(2.0f), results[i]);
+		}
+	}
+};
+
+}
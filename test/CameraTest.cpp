@@ -0,0 +1,95 @@
+#include "CppUnitTest.h"
+#include <vector>
+#include <hmath/Camera.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(CameraTest) {
+	static void assertNear( const hm::Matrix4x4& expected, const hm::Matrix4x4& actual, float tolerance ) {
+		for( int i = 0; i < 16; ++i ) {
+			Assert::AreEqual(expected[i], actual[i], tolerance);
+		}
+	}
+
+	static hm::Vector4 homogeneous( const hm::Vector3& p ) {
+		return hm::Vector4({p[0], p[1], p[2], 1.0f});
+	}
+
+	TEST_METHOD(Matrices) {
+		const hm::Vector3 eye({3.0f, 2.0f, 5.0f});
+		const hm::Vector3 target({0.0f, 0.5f, -1.0f});
+		const hm::Vector3 up({0.0f, 1.0f, 0.0f});
+		hm::Camera camera;
+		camera.setLookAt(eye, target, up);
+		camera.setPerspective(0.9f, 1.5f, 0.5f, 200.0f);
+
+		const hm::Matrix4x4 view = hm::makeLookAt(eye, target, up);
+		const hm::Matrix4x4 projection = hm::makePerspective(0.9f, 1.5f, 0.5f, 200.0f);
+		assertNear(view, camera.view(), 0.0f);
+		assertNear(projection, camera.projection(), 0.0f);
+		assertNear(projection * view, camera.viewProjection(), 0.0f);
+		assertNear(hm::inverse(view), camera.inverseView(), 1e-5f);
+		assertNear(hm::inverse(projection), camera.inverseProjection(), 0.0f);
+		assertNear(hm::Matrix4x4::identity(), camera.viewProjection() * camera.inverseViewProjection(), 1e-4f);
+
+		// moving the camera keeps the projection, resizing keeps the view; a marker written into the cached projection
+		// shows whether it was recomputed
+		const hm::Matrix4x4 inverseProjection = camera.inverseProjection();
+		hm::Matrix4x4& cachedProjection = const_cast<hm::Matrix4x4&>(camera.projection());
+		cachedProjection[1] = 42.0f;
+		camera.setLookAt(target, eye, up);
+		assertNear(hm::makeLookAt(target, eye, up), camera.view(), 0.0f);
+		assertNear(inverseProjection, camera.inverseProjection(), 0.0f);
+		Assert::AreEqual(42.0f, camera.projection()[1], 0.0f);
+		camera.setAspect(2.0f);
+		assertNear(hm::makePerspective(0.9f, 2.0f, 0.5f, 200.0f), camera.projection(), 0.0f);
+		assertNear(hm::makeLookAt(target, eye, up), camera.view(), 0.0f);
+		assertNear(hm::Matrix4x4::identity(), camera.viewProjection() * camera.inverseViewProjection(), 1e-4f);
+
+		camera.setOrthographic(-4.0f, 4.0f, -3.0f, 3.0f, 0.1f, 50.0f);
+		Assert::IsFalse(camera.isPerspective());
+		assertNear(hm::makeOrthographic(-4.0f, 4.0f, -3.0f, 3.0f, 0.1f, 50.0f), camera.projection(), 0.0f);
+		camera.setAspect(3.0f);
+		assertNear(hm::makeOrthographic(-4.0f, 4.0f, -3.0f, 3.0f, 0.1f, 50.0f), camera.projection(), 0.0f);
+	}
+
+	TEST_METHOD(ScreenRays) {
+		hm::Camera camera;
+		camera.setLookAt(hm::Vector3({1.0f, 4.0f, 6.0f}), hm::Vector3({0.0f, 0.0f, 0.0f}), hm::Vector3({0.0f, 1.0f, 0.0f}));
+		camera.setPerspective(1.2f, 16.0f / 9.0f, 0.25f, 100.0f);
+		const float width = 1920.0f, height = 1080.0f;
+
+		// the center ray runs from the near plane along the view direction
+		hm::Vector3 origin, direction;
+		camera.screenRay(hm::Vector2({width * 0.5f, height * 0.5f}), width, height, origin, direction);
+		hm::Vector3 forward = camera.target() - camera.eye();
+		hm::normalize(forward);
+		Assert::IsTrue(hm::sqrDistance(forward, direction) < 1e-10f);
+		Assert::IsTrue(hm::sqrDistance(camera.eye() + forward * 0.25f, origin) < 1e-8f);
+
+		std::vector<hm::Vector2> pixels;
+		for( int y = 0; y < 7; ++y ) {
+			for( int x = 0; x < 5; ++x ) {
+				pixels.push_back(hm::Vector2({x * width / 4.0f, y * height / 6.0f}));
+			}
+		}
+		const int count = static_cast<int>(pixels.size());
+		std::vector<hm::Vector3> origins(count), directions(count);
+		camera.screenRays(pixels.data(), count, width, height, origins.data(), directions.data());
+		for( int i = 0; i < count; ++i ) {
+			camera.screenRay(pixels[i], width, height, origin, direction);
+			Assert::IsTrue(hm::sqrDistance(origin, origins[i]) < 1e-10f);
+			Assert::IsTrue(hm::sqrDistance(direction, directions[i]) < 1e-10f);
+			Assert::AreEqual(1.0f, hm::length(directions[i]), 1e-6f);
+
+			// a point along the ray projects back onto the pixel
+			const hm::Vector4 clip = homogeneous(origins[i] + directions[i] * 10.0f) * camera.viewProjection();
+			Assert::AreEqual(pixels[i][0], (clip[0] / clip[3] + 1.0f) * 0.5f * width, 0.05f);
+			Assert::AreEqual(pixels[i][1], (1.0f - clip[1] / clip[3]) * 0.5f * height, 0.05f);
+		}
+	}
+};
+
+}
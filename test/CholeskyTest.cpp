@@ -0,0 +1,214 @@
+#include "CppUnitTest.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <hmath/Cholesky.hpp>
+#include <hmath/GaussianElimination.hpp>
+#include <hmath/Matrix.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(CholeskyTest) {
+	// B^T B + n I for a random B, which is symmetric positive definite and well conditioned
+	static std::vector<float> randomSpd( int n, std::mt19937& rng ) {
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		std::vector<float> B(n * n), M(n * n, 0.0f);
+		for( auto& b : B ) {
+			b = dist(rng);
+		}
+		for( int r = 0; r < n; ++r ) {
+			for( int c = 0; c < n; ++c ) {
+				for( int k = 0; k < n; ++k ) {
+					M[r * n + c] += B[k * n + r] * B[k * n + c];
+				}
+			}
+			M[r * n + r] += static_cast<float>(n);
+		}
+		return M;
+	}
+
+	template<int N>
+	static hm::Matrix<N, N> randomSpdMatrix( std::mt19937& rng ) {
+		const std::vector<float> values = randomSpd(N, rng);
+		hm::Matrix<N, N> M;
+		for( int i = 0; i < N * N; ++i ) {
+			M[i] = values[i];
+		}
+		return M;
+	}
+
+	template<int N>
+	static void assertNear( const hm::Matrix<N, N>& expected, const hm::Matrix<N, N>& actual, float tolerance ) {
+		for( int i = 0; i < N * N; ++i ) {
+			Assert::AreEqual(expected[i], actual[i], tolerance);
+		}
+	}
+
+	TEST_METHOD(Fixed) {
+		std::mt19937 rng(5);
+		const hm::Matrix<4, 4> M = randomSpdMatrix<4>(rng);
+		const hm::CholeskyDecomposition<4> ldlt(M);
+		Assert::IsTrue(ldlt.isPositiveDefinite());
+
+		// L D L^T and G G^T both reproduce M
+		const hm::Matrix<4, 4> L = ldlt.unitLower();
+		const hm::Vector<4> d = ldlt.diagonal();
+		hm::Matrix<4, 4> LD = L;
+		for( int r = 0; r < 4; ++r ) {
+			for( int c = 0; c < 4; ++c ) {
+				LD(r, c) *= d[c];
+				Assert::AreEqual((c > r) ? 0.0f : (c == r ? 1.0f : L(r, c)), L(r, c));
+			}
+		}
+		assertNear(M, hm::multiplyAB(LD, hm::transpose(L)), 1e-4f);
+		const hm::Matrix<4, 4> G = ldlt.lower();
+		assertNear(M, hm::multiplyAB(G, hm::transpose(G)), 1e-4f);
+
+		const hm::Vector<4> b({1.0f, -2.0f, 0.5f, 3.0f});
+		const hm::Vector<4> x = ldlt.solve(b);
+		Assert::IsTrue(hm::sqrDistance(M * x, b) < 1e-10f);
+		assertNear(hm::inverse(M), ldlt.inverse(), 1e-5f);
+		Assert::AreEqual(hm::determinant(M), ldlt.determinant(), 1e-4f * hm::determinant(M));
+
+		// indefinite and singular matrices are rejected
+		hm::Matrix<2, 2> indefinite = {1.0f, 2.0f, 2.0f, 1.0f};
+		hm::CholeskyDecomposition<2> rejected(indefinite);
+		Assert::IsFalse(rejected.isPositiveDefinite());
+		Assert::AreEqual(0.0f, hm::sqrLength(rejected.solve(hm::Vector<2>({1.0f, 1.0f}))));
+		Assert::IsFalse(rejected.update(hm::Vector<2>({1.0f, 0.0f})));
+		hm::Matrix<3, 3> singular = {1.0f, 2.0f, 3.0f, 2.0f, 4.0f, 6.0f, 3.0f, 6.0f, 9.0f};
+		Assert::IsFalse(hm::CholeskyDecomposition<3>(singular).isPositiveDefinite());
+		Assert::IsFalse(hm::CholeskyDecomposition<3>().isPositiveDefinite());
+	}
+
+	TEST_METHOD(RankOneUpdate) {
+		std::mt19937 rng(9);
+		const hm::Matrix<6, 6> M = randomSpdMatrix<6>(rng);
+		const hm::Vector<6> v({0.5f, -1.0f, 2.0f, 0.25f, 1.5f, -0.75f});
+		hm::Matrix<6, 6> Mv = M;
+		for( int r = 0; r < 6; ++r ) {
+			for( int c = 0; c < 6; ++c ) {
+				Mv(r, c) += v[r] * v[c];
+			}
+		}
+
+		hm::CholeskyDecomposition<6> ldlt(M);
+		Assert::IsTrue(ldlt.update(v));
+		assertNear(hm::CholeskyDecomposition<6>(Mv).packed(), ldlt.packed(), 1e-4f);
+		Assert::IsTrue(ldlt.downdate(v));
+		assertNear(hm::CholeskyDecomposition<6>(M).packed(), ldlt.packed(), 1e-4f);
+
+		// a downdate that would leave M indefinite is refused without changing the factors
+		const hm::Matrix<6, 6> before = ldlt.packed();
+		const hm::Vector<6> large = v * 10.0f;
+		Assert::IsFalse(ldlt.downdate(large));
+		assertNear(before, ldlt.packed(), 0.0f);
+
+		// the same through the runtime-sized decomposition
+		hm::CholeskyDecomposition<0> dynamic(6, &M[0]);
+		Assert::IsTrue(dynamic.update(&v[0]));
+		for( int i = 0; i < 36; ++i ) {
+			Assert::AreEqual(hm::CholeskyDecomposition<6>(Mv).packed()[i], dynamic.packed()[i], 1e-4f);
+		}
+		Assert::IsTrue(dynamic.downdate(&v[0]));
+		Assert::IsFalse(dynamic.downdate(&large[0]));
+	}
+
+	TEST_METHOD(Dynamic) {
+		std::mt19937 rng(3);
+		const int n = 40;
+		const std::vector<float> M = randomSpd(n, rng);
+		hm::CholeskyDecomposition<0> ldlt(n, M.data());
+		Assert::IsTrue(ldlt.isPositiveDefinite());
+		Assert::AreEqual(n, ldlt.size());
+
+		std::vector<float> b(n), x(n);
+		for( int i = 0; i < n; ++i ) {
+			b[i] = static_cast<float>(i % 7) - 3.0f;
+		}
+		Assert::IsTrue(ldlt.solve(b.data(), x.data()));
+		for( int r = 0; r < n; ++r ) {
+			float sum = 0.0f;
+			for( int c = 0; c < n; ++c ) {
+				sum += M[r * n + c] * x[c];
+			}
+			Assert::AreEqual(b[r], sum, 1e-4f);
+		}
+		// in place
+		Assert::IsTrue(ldlt.solve(b.data(), b.data()));
+		for( int i = 0; i < n; ++i ) {
+			Assert::AreEqual(x[i], b[i]);
+		}
+
+		std::vector<float> inverse(n * n), expected(n * n);
+		float determinant;
+		Assert::IsTrue(ldlt.inverse(inverse.data()));
+		hm::GaussianElimination()(n, M.data(), expected.data(), determinant, nullptr, nullptr, nullptr, 0, nullptr);
+		for( int i = 0; i < n * n; ++i ) {
+			Assert::AreEqual(expected[i], inverse[i], 1e-5f);
+		}
+
+		// only the lower triangle is read
+		std::vector<float> lower = M;
+		for( int r = 0; r < n; ++r ) {
+			for( int c = r + 1; c < n; ++c ) {
+				lower[r * n + c] = 1e9f;
+			}
+		}
+		hm::CholeskyDecomposition<0> fromLower(n, lower.data());
+		for( int i = 0; i < n * n; ++i ) {
+			Assert::AreEqual(ldlt.packed()[i], fromLower.packed()[i]);
+		}
+
+		std::vector<float> indefinite = M;
+		indefinite[(n - 1) * n + n - 1] = -1.0f;
+		Assert::IsFalse(ldlt.factor(n, indefinite.data()));
+		Assert::IsFalse(ldlt.solve(b.data(), x.data()));
+		Assert::AreEqual(0.0f, x[0]);
+	}
+
+	TEST_METHOD(Batch) {
+		std::mt19937 rng(11);
+		const int count = 37;
+		std::vector<hm::Matrix<5, 5>> M(count);
+		std::vector<hm::Vector<5>> b(count);
+		for( int i = 0; i < count; ++i ) {
+			M[i] = randomSpdMatrix<5>(rng);
+			b[i] = hm::Vector<5>({1.0f, static_cast<float>(i), -2.0f, 0.5f, 3.0f});
+		}
+		M[7](2, 2) = -5.0f;
+		M[36].makeZero();
+
+		std::vector<hm::CholeskyDecomposition<5>> factors(count);
+		hm::factorCholesky(M.data(), factors.data(), count);
+		std::vector<hm::Vector<5>> x = b;
+		bool flags[count];
+		hm::solveCholesky(M.data(), x.data(), x.data(), flags, count);
+		for( int i = 0; i < count; ++i ) {
+			const hm::CholeskyDecomposition<5> scalar(M[i]);
+			Assert::AreEqual(scalar.isPositiveDefinite(), factors[i].isPositiveDefinite());
+			Assert::AreEqual(scalar.isPositiveDefinite(), flags[i]);
+			Assert::AreEqual(i != 7 && i != 36, flags[i]);
+			assertNear(scalar.packed(), factors[i].packed(), 1e-5f);
+			const hm::Vector<5> expected = scalar.solve(b[i]);
+			for( int c = 0; c < 5; ++c ) {
+				Assert::AreEqual(expected[c], x[i][c], 1e-4f);
+			}
+		}
+
+		// sizes beyond the SIMD kernel take the scalar path
+		std::vector<hm::Matrix<9, 9>> large(3);
+		for( auto& m : large ) {
+			m = randomSpdMatrix<9>(rng);
+		}
+		std::vector<hm::CholeskyDecomposition<9>> largeFactors(3);
+		hm::factorCholesky(large.data(), largeFactors.data(), 3);
+		for( int i = 0; i < 3; ++i ) {
+			assertNear(hm::CholeskyDecomposition<9>(large[i]).packed(), largeFactors[i].packed(), 0.0f);
+		}
+	}
+};
+
+}
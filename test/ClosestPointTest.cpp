@@ -0,0 +1,248 @@
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <hmath/ClosestPoint.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(ClosestPointTest) {
+	static hm::Vector3 randomPoint( std::mt19937& rng, float extent ) {
+		std::uniform_real_distribution<float> dist(-extent, extent);
+		const float x = dist(rng), y = dist(rng), z = dist(rng);
+		return hm::Vector3{x, y, z};
+	}
+
+	TEST_METHOD(Segment) {
+		const float EPSILON = 1e-5f;
+		hm::Vector3 closest;
+		float t;
+
+		// projection inside, and clamped at either end
+		float sqrDistance = hm::closestPointOnSegment(hm::Vector3{1.0f, 2.0f, 0.0f}, hm::Vector3::zero(), hm::Vector3{4.0f, 0.0f, 0.0f}, closest, t);
+		Assert::AreEqual(4.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(0.25f, t, EPSILON);
+		Assert::AreEqual(1.0f, closest[0], EPSILON);
+		sqrDistance = hm::closestPointOnSegment(hm::Vector3{-3.0f, 0.0f, 0.0f}, hm::Vector3::zero(), hm::Vector3{4.0f, 0.0f, 0.0f}, closest, t);
+		Assert::AreEqual(9.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(0.0f, t);
+		sqrDistance = hm::closestPointOnSegment(hm::Vector3{6.0f, 0.0f, 1.0f}, hm::Vector3::zero(), hm::Vector3{4.0f, 0.0f, 0.0f}, closest, t);
+		Assert::AreEqual(5.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(1.0f, t);
+
+		// a segment of zero length is a point
+		sqrDistance = hm::closestPointOnSegment(hm::Vector3{1.0f, 1.0f, 1.0f}, hm::Vector3{2.0f, 2.0f, 2.0f}, hm::Vector3{2.0f, 2.0f, 2.0f}, closest, t);
+		Assert::AreEqual(3.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(0.0f, t);
+		Assert::AreEqual(2.0f, closest[1]);
+	}
+
+	TEST_METHOD(Triangle) {
+		const float EPSILON = 1e-4f;
+		const hm::Vector3 a = hm::Vector3::zero(), b{2.0f, 0.0f, 0.0f}, c{0.0f, 2.0f, 0.0f};
+		hm::Vector3 closest, barycentric;
+
+		// above the interior
+		float sqrDistance = hm::closestPointOnTriangle(hm::Vector3{0.5f, 0.5f, 3.0f}, a, b, c, closest, barycentric);
+		Assert::AreEqual(9.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(0.5f, barycentric[0], EPSILON);
+		Assert::AreEqual(0.25f, barycentric[1], EPSILON);
+		Assert::AreEqual(0.25f, barycentric[2], EPSILON);
+		// vertex and edge regions
+		sqrDistance = hm::closestPointOnTriangle(hm::Vector3{-1.0f, -1.0f, 0.0f}, a, b, c, closest, barycentric);
+		Assert::AreEqual(2.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(1.0f, barycentric[0], EPSILON);
+		sqrDistance = hm::closestPointOnTriangle(hm::Vector3{2.0f, 2.0f, 0.0f}, a, b, c, closest, barycentric);
+		Assert::AreEqual(2.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(0.0f, barycentric[0], EPSILON);
+		Assert::AreEqual(0.5f, barycentric[1], EPSILON);
+		Assert::AreEqual(0.5f, barycentric[2], EPSILON);
+
+		// the closest point is never farther than any sampled point of the triangle
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		for( int i = 0; i < 200; ++i ) {
+			const hm::Vector3 ta = randomPoint(rng, 2.0f), tb = randomPoint(rng, 2.0f), tc = randomPoint(rng, 2.0f);
+			const hm::Vector3 p = randomPoint(rng, 4.0f);
+			sqrDistance = hm::closestPointOnTriangle(p, ta, tb, tc, closest, barycentric);
+			const hm::Vector3 rebuilt = ta * barycentric[0] + tb * barycentric[1] + tc * barycentric[2];
+			Assert::IsTrue(hm::sqrDistance(closest, rebuilt) < EPSILON);
+			Assert::AreEqual(hm::sqrDistance(closest, p), sqrDistance, EPSILON);
+			for( int j = 0; j < 100; ++j ) {
+				float u = unit(rng), v = unit(rng);
+				if( u + v > 1.0f ) {
+					u = 1.0f - u;
+					v = 1.0f - v;
+				}
+				const hm::Vector3 sample = ta + (tb - ta) * u + (tc - ta) * v;
+				Assert::IsTrue(sqrDistance <= hm::sqrDistance(sample, p) + EPSILON);
+			}
+		}
+
+		// collinear and single-point triangles
+		sqrDistance = hm::closestPointOnTriangle(hm::Vector3{1.0f, 1.0f, 0.0f}, a, b, hm::Vector3{4.0f, 0.0f, 0.0f}, closest, barycentric);
+		Assert::AreEqual(1.0f, sqrDistance, EPSILON);
+		sqrDistance = hm::closestPointOnTriangle(hm::Vector3{1.0f, 1.0f, 1.0f}, a, a, a, closest, barycentric);
+		Assert::AreEqual(3.0f, sqrDistance, EPSILON);
+	}
+
+	TEST_METHOD(Segments) {
+		const float EPSILON = 1e-4f;
+		hm::Vector3 closest0, closest1;
+		float s, t;
+
+		// crossing, parallel, and with a point
+		float sqrDistance = hm::closestPointsOnSegments(hm::Vector3{-1.0f, 0.0f, 0.0f}, hm::Vector3{1.0f, 0.0f, 0.0f}, hm::Vector3{0.0f, -1.0f, 1.0f}, hm::Vector3{0.0f, 1.0f, 1.0f}, closest0, closest1, s, t);
+		Assert::AreEqual(1.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(0.5f, s, EPSILON);
+		Assert::AreEqual(0.5f, t, EPSILON);
+		sqrDistance = hm::closestPointsOnSegments(hm::Vector3::zero(), hm::Vector3{1.0f, 0.0f, 0.0f}, hm::Vector3{3.0f, 1.0f, 0.0f}, hm::Vector3{5.0f, 1.0f, 0.0f}, closest0, closest1, s, t);
+		Assert::AreEqual(5.0f, sqrDistance, EPSILON);
+		sqrDistance = hm::closestPointsOnSegments(hm::Vector3::zero(), hm::Vector3{2.0f, 0.0f, 0.0f}, hm::Vector3{1.0f, 1.0f, 0.0f}, hm::Vector3{1.0f, 1.0f, 0.0f}, closest0, closest1, s, t);
+		Assert::AreEqual(1.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(0.5f, s, EPSILON);
+		sqrDistance = hm::closestPointsOnSegments(hm::Vector3{1.0f, 1.0f, 1.0f}, hm::Vector3{1.0f, 1.0f, 1.0f}, hm::Vector3{1.0f, 1.0f, 1.0f}, hm::Vector3{1.0f, 1.0f, 1.0f}, closest0, closest1, s, t);
+		Assert::AreEqual(0.0f, sqrDistance);
+
+		// never farther than any pair of sampled points
+		std::mt19937 rng(11);
+		for( int i = 0; i < 200; ++i ) {
+			const hm::Vector3 p0 = randomPoint(rng, 2.0f), q0 = randomPoint(rng, 2.0f), p1 = randomPoint(rng, 2.0f), q1 = randomPoint(rng, 2.0f);
+			sqrDistance = hm::closestPointsOnSegments(p0, q0, p1, q1, closest0, closest1, s, t);
+			Assert::AreEqual(hm::sqrDistance(closest0, closest1), sqrDistance, EPSILON);
+			for( int j = 0; j <= 20; ++j ) {
+				for( int k = 0; k <= 20; ++k ) {
+					const hm::Vector3 a = p0 + (q0 - p0) * (j / 20.0f);
+					const hm::Vector3 b = p1 + (q1 - p1) * (k / 20.0f);
+					Assert::IsTrue(sqrDistance <= hm::sqrDistance(a, b) + EPSILON);
+				}
+			}
+		}
+	}
+
+	TEST_METHOD(Box) {
+		const float EPSILON = 1e-5f;
+		const float half = 0.70710678f;
+		hm::OrientedBox box;
+		box.center = hm::Vector3{1.0f, 0.0f, 0.0f};
+		box.axes[0] = hm::Vector3{half, half, 0.0f};
+		box.axes[1] = hm::Vector3{-half, half, 0.0f};
+		box.axes[2] = hm::Vector3{0.0f, 0.0f, 1.0f};
+		box.halfExtents = hm::Vector3{1.0f, 2.0f, 3.0f};
+		hm::Vector3 closest, local;
+
+		// inside, and outside past the first axis
+		float sqrDistance = hm::closestPointOnBox(hm::Vector3{1.5f, 0.5f, 2.0f}, box, closest, local);
+		Assert::AreEqual(0.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(2.0f, local[2], EPSILON);
+		sqrDistance = hm::closestPointOnBox(box.center + box.axes[0] * 4.0f, box, closest, local);
+		Assert::AreEqual(9.0f, sqrDistance, EPSILON);
+		Assert::AreEqual(1.0f, local[0], EPSILON);
+		Assert::AreEqual(0.0f, local[1], EPSILON);
+	}
+
+	TEST_METHOD(Blocks) {
+		// every lane of the batch forms matches the scalar forms
+		const float EPSILON = 1e-5f;
+		const int count = hm::SimdWidth * 3 + 1;
+		const int numBlocks = (count + hm::SimdWidth - 1) / hm::SimdWidth;
+		std::mt19937 rng(3);
+		std::vector<hm::Vector3> p(count), a(count), b(count), c(count), d(count);
+		for( int i = 0; i < count; ++i ) {
+			p[i] = randomPoint(rng, 4.0f);
+			a[i] = randomPoint(rng, 2.0f);
+			b[i] = randomPoint(rng, 2.0f);
+			c[i] = randomPoint(rng, 2.0f);
+			d[i] = randomPoint(rng, 2.0f);
+		}
+		// some degenerate lanes
+		b[1] = a[1];
+		c[2] = a[2] + (b[2] - a[2]) * 0.5f;
+		d[3] = c[3];
+
+		std::vector<hm::Vector3Block> pb(numBlocks), ab(numBlocks), bb(numBlocks), cb(numBlocks), db(numBlocks);
+		hm::packBlocks(p.data(), count, pb.data());
+		hm::packBlocks(a.data(), count, ab.data());
+		hm::packBlocks(b.data(), count, bb.data());
+		hm::packBlocks(c.data(), count, cb.data());
+		hm::packBlocks(d.data(), count, db.data());
+
+		std::vector<hm::Vector3Block> closest0(numBlocks), closest1(numBlocks);
+		std::vector<hm::Vector3> closest0Out(count), closest1Out(count);
+		std::vector<float> s(numBlocks * hm::SimdWidth), t(numBlocks * hm::SimdWidth), sqrDistance(numBlocks * hm::SimdWidth);
+
+		for( int i = 0; i < numBlocks; ++i ) {
+			hm::closestPointOnSegment(pb[i], ab[i], bb[i], closest0[i], &t[i * hm::SimdWidth], &sqrDistance[i * hm::SimdWidth]);
+		}
+		hm::unpackBlocks(closest0.data(), count, closest0Out.data());
+		for( int i = 0; i < count; ++i ) {
+			hm::Vector3 closest;
+			float tScalar;
+			Assert::AreEqual(hm::closestPointOnSegment(p[i], a[i], b[i], closest, tScalar), sqrDistance[i], EPSILON);
+			Assert::AreEqual(tScalar, t[i], EPSILON);
+			Assert::IsTrue(hm::sqrDistance(closest, closest0Out[i]) < EPSILON);
+		}
+
+		for( int i = 0; i < numBlocks; ++i ) {
+			hm::closestPointOnTriangle(pb[i], ab[i], bb[i], cb[i], closest0[i], closest1[i], &sqrDistance[i * hm::SimdWidth]);
+		}
+		hm::unpackBlocks(closest0.data(), count, closest0Out.data());
+		hm::unpackBlocks(closest1.data(), count, closest1Out.data());
+		for( int i = 0; i < count; ++i ) {
+			hm::Vector3 closest, barycentric;
+			Assert::AreEqual(hm::closestPointOnTriangle(p[i], a[i], b[i], c[i], closest, barycentric), sqrDistance[i], EPSILON);
+			Assert::IsTrue(hm::sqrDistance(closest, closest0Out[i]) < EPSILON);
+			Assert::IsTrue(hm::sqrDistance(barycentric, closest1Out[i]) < EPSILON);
+		}
+
+		for( int i = 0; i < numBlocks; ++i ) {
+			hm::closestPointsOnSegments(ab[i], bb[i], cb[i], db[i], closest0[i], closest1[i], &s[i * hm::SimdWidth], &t[i * hm::SimdWidth], &sqrDistance[i * hm::SimdWidth]);
+		}
+		hm::unpackBlocks(closest0.data(), count, closest0Out.data());
+		hm::unpackBlocks(closest1.data(), count, closest1Out.data());
+		for( int i = 0; i < count; ++i ) {
+			hm::Vector3 first, second;
+			float sScalar, tScalar;
+			Assert::AreEqual(hm::closestPointsOnSegments(a[i], b[i], c[i], d[i], first, second, sScalar, tScalar), sqrDistance[i], EPSILON);
+			Assert::AreEqual(sScalar, s[i], EPSILON);
+			Assert::AreEqual(tScalar, t[i], EPSILON);
+			Assert::IsTrue(hm::sqrDistance(first, closest0Out[i]) < EPSILON);
+			Assert::IsTrue(hm::sqrDistance(second, closest1Out[i]) < EPSILON);
+		}
+
+		// axis-aligned boxes centered at a with half extents |d|
+		std::vector<hm::OrientedBox> boxes(count);
+		std::vector<hm::Vector3> axes[3] = {std::vector<hm::Vector3>(count, hm::Vector3{1.0f, 0.0f, 0.0f}), std::vector<hm::Vector3>(count, hm::Vector3{0.0f, 1.0f, 0.0f}), std::vector<hm::Vector3>(count, hm::Vector3{0.0f, 0.0f, 1.0f})};
+		std::vector<hm::Vector3> halfExtents(count);
+		for( int i = 0; i < count; ++i ) {
+			halfExtents[i] = hm::Vector3{std::fabs(d[i][0]), std::fabs(d[i][1]), std::fabs(d[i][2])};
+			boxes[i].center = a[i];
+			for( int k = 0; k < 3; ++k ) {
+				boxes[i].axes[k] = axes[k][i];
+			}
+			boxes[i].halfExtents = halfExtents[i];
+		}
+		std::vector<hm::OrientedBoxBlock> boxBlocks(numBlocks);
+		for( int i = 0; i < numBlocks; ++i ) {
+			const int first = i * hm::SimdWidth;
+			const int n = std::min(hm::SimdWidth, count - first);
+			hm::packBlocks(&a[first], n, &boxBlocks[i].center);
+			for( int k = 0; k < 3; ++k ) {
+				hm::packBlocks(&axes[k][first], n, &boxBlocks[i].axes[k]);
+			}
+			hm::packBlocks(&halfExtents[first], n, &boxBlocks[i].halfExtents);
+			hm::closestPointOnBox(pb[i], boxBlocks[i], closest0[i], closest1[i], &sqrDistance[first]);
+		}
+		hm::unpackBlocks(closest0.data(), count, closest0Out.data());
+		for( int i = 0; i < count; ++i ) {
+			hm::Vector3 closest, local;
+			Assert::AreEqual(hm::closestPointOnBox(p[i], boxes[i], closest, local), sqrDistance[i], EPSILON);
+			Assert::IsTrue(hm::sqrDistance(closest, closest0Out[i]) < EPSILON);
+		}
+	}
+};
+
+}
@@ -0,0 +1,143 @@
+#include "CppUnitTest.h"
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include <hmath/ConvexHull.hpp>
+#include <hmath/Parallel.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(ConvexHullTest) {
+	// checks that the hull is a closed, consistently oriented triangle mesh of genus 0 with all points inside it
+	static void assertValid( const hm::ConvexHull& hull, const std::vector<hm::Vector3>& points ) {
+		const std::vector<hm::Vector3>& vertices = hull.vertices();
+		const std::vector<int>& indices = hull.indices();
+		std::map<std::pair<int, int>, int> edges;
+		for( size_t t = 0; t < indices.size(); t += 3 ) {
+			for( int e = 0; e < 3; ++e ) {
+				++edges[std::make_pair(indices[t + e], indices[t + (e + 1) % 3])];
+			}
+		}
+		for( const auto& edge : edges ) {
+			Assert::AreEqual(1, edge.second);
+			Assert::IsTrue(edges.count(std::make_pair(edge.first.second, edge.first.first)) == 1);
+		}
+		const int numEdges = static_cast<int>(edges.size()) / 2;
+		Assert::AreEqual(2, static_cast<int>(vertices.size()) - numEdges + hull.numTriangles());
+
+		for( size_t i = 0; i < vertices.size(); ++i ) {
+			Assert::AreEqual(0.0f, hm::sqrDistance(points[hull.sourceIndices()[i]], vertices[i]));
+		}
+		// normals in double, as those of slivers lose their direction in float
+		for( size_t t = 0; t < indices.size(); t += 3 ) {
+			const hm::Vector3& a = vertices[indices[t]];
+			const hm::Vector3& b = vertices[indices[t + 1]];
+			const hm::Vector3& c = vertices[indices[t + 2]];
+			double u[3], v[3];
+			for( int i = 0; i < 3; ++i ) {
+				u[i] = static_cast<double>(b[i]) - a[i];
+				v[i] = static_cast<double>(c[i]) - a[i];
+			}
+			const double n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+			const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			for( const hm::Vector3& p : points ) {
+				const double d = (n[0] * (p[0] - a[0]) + n[1] * (p[1] - a[1]) + n[2] * (p[2] - a[2])) / length;
+				Assert::IsTrue(d <= 2.0 * hull.tolerance());
+			}
+		}
+	}
+
+	TEST_METHOD(Box) {
+		// the corners of a box, with points inside and on its faces
+		std::mt19937 rng(41);
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		std::vector<hm::Vector3> points;
+		for( int i = 0; i < 5000; ++i ) {
+			points.push_back(hm::Vector3({dist(rng), dist(rng), dist(rng)}));
+			points.push_back(hm::Vector3({1.0f, dist(rng), dist(rng)}));
+		}
+		for( int corner = 0; corner < 8; ++corner ) {
+			points.push_back(hm::Vector3({(corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f}));
+		}
+
+		hm::ConvexHull hull;
+		Assert::IsTrue(hull.build(points.data(), static_cast<int>(points.size())));
+		Assert::AreEqual(8, static_cast<int>(hull.vertices().size()));
+		Assert::AreEqual(12, hull.numTriangles());
+		for( int index : hull.sourceIndices() ) {
+			Assert::IsTrue(index >= 10000);
+		}
+		assertValid(hull, points);
+	}
+
+	TEST_METHOD(Sphere) {
+		// every point is a vertex, and many are nearly coplanar with their neighbors
+		std::mt19937 rng(43);
+		std::normal_distribution<float> dist(0.0f, 1.0f);
+		std::vector<hm::Vector3> points(3000);
+		for( auto& p : points ) {
+			p = hm::Vector3({dist(rng), dist(rng), dist(rng)});
+			hm::normalize(p);
+			p = p * 100.0f + hm::Vector3({500.0f, -200.0f, 50.0f});
+		}
+		hm::ConvexHull hull;
+		Assert::IsTrue(hull.build(points.data(), static_cast<int>(points.size())));
+		Assert::IsTrue(hull.vertices().size() > 2900);
+		assertValid(hull, points);
+	}
+
+	TEST_METHOD(Parallel) {
+		// enough points for several ranges; the hull is the same for any number of threads
+		std::mt19937 rng(47);
+		std::normal_distribution<float> dist(0.0f, 1.0f);
+		std::vector<hm::Vector3> points(300000);
+		for( auto& p : points ) {
+			p = hm::Vector3({dist(rng), 2.0f * dist(rng), dist(rng)});
+		}
+		hm::ThreadPool pool(4);
+		hm::setTaskExecutor(&pool);
+		hm::ConvexHull serial, parallel;
+		Assert::IsTrue(serial.build(points.data(), static_cast<int>(points.size()), 1));
+		Assert::IsTrue(parallel.build(points.data(), static_cast<int>(points.size())));
+		hm::setTaskExecutor(nullptr);
+		Assert::IsTrue(serial.indices() == parallel.indices());
+		Assert::IsTrue(serial.sourceIndices() == parallel.sourceIndices());
+
+		std::vector<hm::Vector3> subset(points.begin(), points.begin() + 20000);
+		hm::ConvexHull small;
+		Assert::IsTrue(small.build(subset.data(), static_cast<int>(subset.size())));
+		assertValid(small, subset);
+	}
+
+	TEST_METHOD(Degenerate) {
+		hm::ConvexHull hull;
+		std::vector<hm::Vector3> points;
+		for( int i = 0; i < 100; ++i ) {
+			points.push_back(hm::Vector3({static_cast<float>(i % 10), static_cast<float>(i / 10), 3.0f}));
+		}
+		// coplanar points span only two dimensions
+		Assert::IsFalse(hull.build(points.data(), static_cast<int>(points.size())));
+		Assert::AreEqual(0, hull.numTriangles());
+		Assert::IsFalse(hull.build(points.data(), 3));
+
+		// one point off the plane makes a pyramid with the four corners
+		points.push_back(hm::Vector3({4.5f, 4.5f, 10.0f}));
+		Assert::IsTrue(hull.build(points.data(), static_cast<int>(points.size())));
+		Assert::AreEqual(5, static_cast<int>(hull.vertices().size()));
+		Assert::AreEqual(6, hull.numTriangles());
+		assertValid(hull, points);
+
+		// points that are all NaN have no extremes
+		const float nan = std::numeric_limits<float>::quiet_NaN();
+		const std::vector<hm::Vector3> invalid(8, hm::Vector3({nan, nan, nan}));
+		Assert::IsFalse(hull.build(invalid.data(), static_cast<int>(invalid.size())));
+		Assert::AreEqual(0, hull.numTriangles());
+	}
+};
+
+}
@@ -0,0 +1,210 @@
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <hmath/Covariance.hpp>
+#include <hmath/Parallel.hpp>
+#include <hmath/SymmetricEigen.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(CovarianceTest) {
+	// covariance by two passes in double, as reference
+	template<int N>
+	static void reference( const std::vector<hm::Vector<N>>& points, double* mean, double* covariance ) {
+		for( int r = 0; r < N; ++r ) {
+			mean[r] = 0.0;
+			for( const auto& p : points ) {
+				mean[r] += p[r];
+			}
+			mean[r] /= static_cast<double>(points.size());
+		}
+		for( int r = 0; r < N; ++r ) {
+			for( int c = 0; c < N; ++c ) {
+				double sum = 0.0;
+				for( const auto& p : points ) {
+					sum += (p[r] - mean[r]) * (p[c] - mean[c]);
+				}
+				covariance[r * N + c] = sum / static_cast<double>(points.size());
+			}
+		}
+	}
+
+	// points around a center far from the origin, stretched along the axes by scale
+	static std::vector<hm::Vector3> cloud( int count, const hm::Vector3& scale, std::mt19937& rng ) {
+		std::normal_distribution<float> dist(0.0f, 1.0f);
+		std::vector<hm::Vector3> points(count);
+		for( auto& p : points ) {
+			p = hm::Vector3({1000.0f + scale[0] * dist(rng), -500.0f + scale[1] * dist(rng), 250.0f + scale[2] * dist(rng)});
+		}
+		return points;
+	}
+
+	TEST_METHOD(Accumulate) {
+		std::mt19937 rng(23);
+		const std::vector<hm::Vector3> points = cloud(5003, hm::Vector3({3.0f, 1.0f, 0.5f}), rng);
+		double mean[3], covariance[9];
+		reference<3>(points, mean, covariance);
+
+		// one at a time, in SIMD lanes, and merged from uneven chunks all agree with the reference
+		hm::CovarianceAccumulator<3> single, batch, merged;
+		for( const auto& p : points ) {
+			single.add(p);
+		}
+		batch.add(points.data(), static_cast<int>(points.size()));
+		for( int first = 0, size = 1; first < static_cast<int>(points.size()); first += size, size *= 3 ) {
+			hm::CovarianceAccumulator<3> chunk;
+			chunk.add(points.data() + first, std::min(size, static_cast<int>(points.size()) - first));
+			merged.merge(chunk);
+		}
+		for( const hm::CovarianceAccumulator<3>* accumulator : {&single, &batch, &merged} ) {
+			Assert::AreEqual(static_cast<std::int64_t>(points.size()), accumulator->count());
+			const hm::Matrix<3, 3> C = accumulator->covariance();
+			for( int r = 0; r < 3; ++r ) {
+				Assert::AreEqual(static_cast<float>(mean[r]), accumulator->mean()[r], 1e-3f);
+				for( int c = 0; c < 3; ++c ) {
+					Assert::AreEqual(static_cast<float>(covariance[r * 3 + c]), C(r, c), 2e-3f);
+					Assert::AreEqual(C(r, c), C(c, r));
+				}
+			}
+		}
+		const float n = static_cast<float>(points.size());
+		Assert::AreEqual(batch.covariance()(0, 0) * n / (n - 1.0f), batch.sampleCovariance()(0, 0), 1e-4f);
+
+		hm::CovarianceAccumulator<3> empty;
+		Assert::AreEqual(0.0f, empty.covariance()(0, 0));
+		empty.merge(batch);
+		Assert::AreEqual(batch.scatter()(1, 2), empty.scatter()(1, 2));
+
+		// the threaded sum is the same for any number of threads
+		std::vector<hm::Vector3> many;
+		for( int i = 0; i < 20; ++i ) {
+			many.insert(many.end(), points.begin(), points.end());
+		}
+		hm::ThreadPool pool(4);
+		hm::setTaskExecutor(&pool);
+		const hm::CovarianceAccumulator<3> serial = hm::computeCovariance(many.data(), static_cast<int>(many.size()), 1);
+		const hm::CovarianceAccumulator<3> parallel = hm::computeCovariance(many.data(), static_cast<int>(many.size()));
+		hm::setTaskExecutor(nullptr);
+		for( int i = 0; i < 9; ++i ) {
+			Assert::AreEqual(serial.scatter()[i], parallel.scatter()[i]);
+			Assert::AreEqual(static_cast<float>(covariance[i]), parallel.covariance()[i], 2e-3f);
+		}
+	}
+
+	template<int N>
+	static void checkBatchMatchesSingle() {
+		std::mt19937 rng(N);
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		std::vector<hm::Vector<N>> points(2 * hm::SimdWidth + 3);
+		for( auto& p : points ) {
+			for( int i = 0; i < N; ++i ) {
+				p[i] = dist(rng);
+			}
+		}
+		hm::CovarianceAccumulator<N> single, batch;
+		for( const auto& p : points ) {
+			single.add(p);
+		}
+		batch.add(points.data(), static_cast<int>(points.size()));
+		Assert::IsTrue(single.count() == batch.count());
+		for( int i = 0; i < N * N; ++i ) {
+			Assert::AreEqual(single.covariance()[i], batch.covariance()[i], 1e-5f);
+		}
+	}
+
+	TEST_METHOD(Dimensions) {
+		// lanes up to 8 dimensions, one point at a time beyond, including past the unrolling limit
+		checkBatchMatchesSingle<8>();
+		checkBatchMatchesSingle<9>();
+		checkBatchMatchesSingle<65>();
+	}
+
+	TEST_METHOD(Eigen) {
+		const hm::Matrix<4, 4> M = {
+			4.0f, 1.0f, -2.0f, 2.0f,
+			1.0f, 2.0f, 0.0f, 1.0f,
+			-2.0f, 0.0f, 3.0f, -2.0f,
+			2.0f, 1.0f, -2.0f, -1.0f
+		};
+		hm::Vector<4> values;
+		hm::Matrix<4, 4> V;
+		Assert::IsTrue(hm::symmetricEigen(M, values, V));
+		for( int i = 1; i < 4; ++i ) {
+			Assert::IsTrue(values[i - 1] >= values[i]);
+		}
+		// V is orthonormal and V diag(values) V^T gives back M
+		hm::Matrix<4, 4> VD = V;
+		for( int r = 0; r < 4; ++r ) {
+			for( int c = 0; c < 4; ++c ) {
+				VD(r, c) *= values[c];
+			}
+		}
+		const hm::Matrix<4, 4> product = hm::multiplyAB(VD, hm::transpose(V));
+		const hm::Matrix<4, 4> identity = hm::multiplyAB(hm::transpose(V), V);
+		for( int i = 0; i < 16; ++i ) {
+			Assert::AreEqual(M[i], product[i], 1e-5f);
+			Assert::AreEqual(hm::Matrix<4, 4>::identity()[i], identity[i], 1e-6f);
+		}
+
+		// repeated eigenvalues
+		hm::Vector3 repeated;
+		hm::Matrix<3, 3> axes;
+		Assert::IsTrue(hm::symmetricEigen(hm::Matrix<3, 3>::identity(), repeated, axes));
+		Assert::AreEqual(1.0f, repeated[2]);
+
+		// a single rotation diagonalizes a 2x2 matrix, so converging on the only allowed sweep is reported
+		const hm::Matrix<2, 2> small = {2.0f, 1.0f, 1.0f, 3.0f};
+		hm::Vector<2> smallValues;
+		hm::Matrix<2, 2> smallVectors;
+		Assert::IsTrue(hm::symmetricEigen(small, smallValues, smallVectors, 1));
+		Assert::IsFalse(hm::symmetricEigen(small, smallValues, smallVectors, 0));
+	}
+
+	TEST_METHOD(PlaneAndAxes) {
+		std::mt19937 rng(31);
+		std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+		std::normal_distribution<float> noise(0.0f, 0.01f);
+		hm::Vector3 expectedNormal({1.0f, 2.0f, -2.0f});
+		hm::normalize(expectedNormal);
+		const hm::Vector3 u = hm::Vector3({2.0f, -1.0f, 0.0f}) / std::sqrt(5.0f);
+		const hm::Vector3 v = hm::Vector3({2.0f, 4.0f, 5.0f}) / std::sqrt(45.0f);
+		const hm::Vector3 origin({5.0f, -3.0f, 7.0f});
+
+		// points on a plane, spread more along u than v
+		std::vector<hm::Vector3> points(2000);
+		for( auto& p : points ) {
+			p = origin + u * (2.0f * dist(rng)) + v * dist(rng) + expectedNormal * noise(rng);
+		}
+		hm::CovarianceAccumulator<3> accumulator;
+		accumulator.add(points.data(), static_cast<int>(points.size()));
+
+		hm::Vector3 point, normal;
+		Assert::IsTrue(hm::fitPlane(accumulator, point, normal));
+		Assert::AreEqual(1.0f, std::fabs(hm::dot(normal, expectedNormal)), 1e-4f);
+		Assert::AreEqual(0.0f, hm::dot(point - origin, expectedNormal), 0.01f);
+
+		hm::Matrix<3, 3> axes;
+		hm::Vector3 variances;
+		Assert::IsTrue(hm::principalAxes(accumulator, axes, variances));
+		Assert::AreEqual(1.0f, std::fabs(hm::dot(hm::Vector3({axes(0, 0), axes(1, 0), axes(2, 0)}), u)), 1e-3f);
+		Assert::AreEqual(1.0f, std::fabs(hm::dot(hm::Vector3({axes(0, 1), axes(1, 1), axes(2, 1)}), v)), 1e-3f);
+		// uniform over [-20, 20] and [-10, 10]
+		Assert::AreEqual(400.0f / 3.0f, variances[0], 15.0f);
+		Assert::AreEqual(100.0f / 3.0f, variances[1], 4.0f);
+
+		// collinear points have no unique plane
+		hm::CovarianceAccumulator<3> line;
+		for( int i = 0; i < 10; ++i ) {
+			line.add(origin + u * static_cast<float>(i));
+		}
+		Assert::IsFalse(hm::fitPlane(line, point, normal));
+		Assert::IsFalse(hm::principalAxes(hm::CovarianceAccumulator<3>(), axes, variances));
+	}
+};
+
+}
@@ -0,0 +1,178 @@
+#include "CppUnitTest.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <hmath/Half.hpp>
+#include <hmath/Random.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(HalfTest) {
+	// decodes binary16 from its definition
+	static float referenceToFloat( std::uint16_t bits ) {
+		const float sign = (bits & 0x8000) ? -1.0f : 1.0f;
+		const int exponent = (bits >> 10) & 0x1f;
+		const int mantissa = bits & 0x3ff;
+		if( exponent == 0x1f ) {
+			return mantissa ? std::numeric_limits<float>::quiet_NaN() : sign * std::numeric_limits<float>::infinity();
+		}
+		if( exponent == 0 ) {
+			return sign * std::ldexp(static_cast<float>(mantissa), -24);
+		}
+		return sign * std::ldexp(static_cast<float>(mantissa + 1024), exponent - 25);
+	}
+
+	static std::uint32_t floatBits( float value ) {
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	TEST_METHOD(Conversion) {
+		Assert::AreEqual(0x3c00, static_cast<int>(hm::Half(1.0f).bits()));
+		Assert::AreEqual(0xc000, static_cast<int>(hm::Half(-2.0f).bits()));
+		Assert::AreEqual(0x7bff, static_cast<int>(hm::Half(65504.0f).bits()));
+		Assert::AreEqual(0x3555, static_cast<int>(hm::Half(1.0f / 3.0f).bits()));
+		Assert::AreEqual(0x8000, static_cast<int>(hm::Half(-0.0f).bits()));
+		// overflow, infinity, NaN
+		Assert::AreEqual(0x7c00, static_cast<int>(hm::Half(65520.0f).bits()));
+		Assert::AreEqual(0xfc00, static_cast<int>(hm::Half(-std::numeric_limits<float>::infinity()).bits()));
+		Assert::IsTrue(std::isnan(hm::Half(std::numeric_limits<float>::quiet_NaN()).toFloat()));
+		// subnormals and underflow
+		Assert::AreEqual(0x0001, static_cast<int>(hm::Half(std::ldexp(1.0f, -24)).bits()));
+		Assert::AreEqual(0x03ff, static_cast<int>(hm::Half(std::ldexp(1023.0f, -24)).bits()));
+		Assert::AreEqual(0x0000, static_cast<int>(hm::Half(std::ldexp(1.0f, -26)).bits()));
+		// ties round to even
+		Assert::AreEqual(0x3c00, static_cast<int>(hm::Half(1.0f + std::ldexp(1.0f, -11)).bits()));
+		Assert::AreEqual(0x3c02, static_cast<int>(hm::Half(1.0f + 3.0f * std::ldexp(1.0f, -11)).bits()));
+		Assert::AreEqual(0x0000, static_cast<int>(hm::Half(std::ldexp(1.0f, -25)).bits()));
+		Assert::AreEqual(0x0002, static_cast<int>(hm::Half(3.0f * std::ldexp(1.0f, -25)).bits()));
+
+		// every half value widens exactly and narrows back to itself
+		for( int bits = 0; bits < 0x10000; ++bits ) {
+			const hm::Half half = hm::Half::fromBits(static_cast<std::uint16_t>(bits));
+			const float value = half.toFloat();
+			const float reference = referenceToFloat(static_cast<std::uint16_t>(bits));
+			if( std::isnan(reference) ) {
+				Assert::IsTrue(std::isnan(value));
+				continue;
+			}
+			Assert::AreEqual(floatBits(reference), floatBits(value));
+			Assert::AreEqual(bits, static_cast<int>(hm::Half(value).bits()));
+		}
+	}
+
+	TEST_METHOD(Batch) {
+		// float bit patterns spanning every exponent, plus the neighbors of each half
+		std::vector<float> values;
+		hm::Random random(7);
+		for( int i = 0; i < 20000; ++i ) {
+			std::uint32_t bits = random.nextUInt();
+			if( ((bits >> 23) & 0xff) == 0xff ) {
+				continue;
+			}
+			float value;
+			std::memcpy(&value, &bits, sizeof(value));
+			values.push_back(value);
+		}
+		for( int bits = 0; bits < 0x7c00; bits += 7 ) {
+			const float value = hm::Half::fromBits(static_cast<std::uint16_t>(bits)).toFloat();
+			values.push_back(value);
+			values.push_back(std::nextafter(value, 0.0f));
+			values.push_back(std::nextafter(value, 1e6f));
+			values.push_back(-value);
+		}
+		const int count = static_cast<int>(values.size());
+
+		std::vector<hm::Half> halves(count);
+		hm::packHalf(values.data(), halves.data(), count);
+		std::vector<float> widened(count);
+		hm::unpackHalf(halves.data(), widened.data(), count);
+		for( int i = 0; i < count; ++i ) {
+			const hm::Half expected(values[i]);
+			Assert::AreEqual(static_cast<int>(expected.bits()), static_cast<int>(halves[i].bits()));
+			Assert::AreEqual(floatBits(expected.toFloat()), floatBits(widened[i]));
+		}
+
+		// vectors and matrices
+		const hm::Vector3 points[3] = {hm::Vector3({1.0f, 2.0f, 3.0f}), hm::Vector3({-0.5f, 0.25f, 1000.0f}), hm::Vector3({0.1f, 0.2f, 0.3f})};
+		hm::HalfVector<3> packed[3];
+		hm::packHalf(points, packed, 3);
+		hm::Vector3 unpacked[3];
+		hm::unpackHalf(packed, unpacked, 3);
+		for( int i = 0; i < 3; ++i ) {
+			Assert::IsTrue(hm::sqrDistance(unpacked[i], packed[i].toVector()) == 0.0f);
+			Assert::IsTrue(hm::sqrDistance(unpacked[i], points[i]) < 1e-6f * hm::sqrLength(points[i]));
+		}
+		hm::Matrix4x4 M = hm::Matrix4x4::identity();
+		M(3, 0) = 5.0f;
+		M(1, 2) = -0.75f;
+		hm::HalfMatrix<4, 4> packedMatrix;
+		hm::packHalf(&M, &packedMatrix, 1);
+		Assert::AreEqual(0x4500, static_cast<int>(packedMatrix(3, 0).bits()));
+		hm::Matrix4x4 unpackedMatrix;
+		hm::unpackHalf(&packedMatrix, &unpackedMatrix, 1);
+		for( int i = 0; i < 16; ++i ) {
+			Assert::AreEqual(M[i], unpackedMatrix[i]);
+		}
+	}
+
+	TEST_METHOD(PackedOperations) {
+		hm::Random random(11);
+		const int count = 37;
+		std::vector<hm::Vector3> points(count);
+		std::vector<hm::HalfVector<3>> packed(count);
+		for( int i = 0; i < count; ++i ) {
+			for( int k = 0; k < 3; ++k ) {
+				points[i][k] = random.nextFloat() * 20.0f - 10.0f;
+			}
+			packed[i] = hm::HalfVector<3>(points[i]);
+			// the operations work on the stored values
+			points[i] = packed[i].toVector();
+		}
+
+		const hm::Vector3 direction({0.3f, -0.4f, 0.5f});
+		std::vector<float> dots(count), pairDots(count);
+		hm::dot(packed.data(), count, direction, dots.data());
+		hm::dot(packed.data(), packed.data(), count, pairDots.data());
+		for( int i = 0; i < count; ++i ) {
+			Assert::AreEqual(hm::dot(points[i], direction), dots[i], 1e-4f);
+			Assert::AreEqual(hm::sqrLength(points[i]), pairDots[i], 1e-3f);
+		}
+
+		hm::Matrix4x4 M = hm::Matrix4x4::identity();
+		M(0, 1) = 0.5f;
+		M(2, 0) = -2.0f;
+		M(3, 0) = 1.0f;
+		M(3, 2) = 4.0f;
+		std::vector<hm::Vector3> transformed(count);
+		hm::transformPoints(packed.data(), count, M, transformed.data());
+		for( int i = 0; i < count; ++i ) {
+			for( int c = 0; c < 3; ++c ) {
+				const float expected = points[i][0] * M(0, c) + points[i][1] * M(1, c) + points[i][2] * M(2, c) + M(3, c);
+				Assert::AreEqual(expected, transformed[i][c], 1e-4f);
+			}
+		}
+
+		hm::Vector3 boxMin, boxMax;
+		Assert::IsFalse(hm::bounds(packed.data(), 0, boxMin, boxMax));
+		for( int n : {1, 5, count} ) {
+			Assert::IsTrue(hm::bounds(packed.data(), n, boxMin, boxMax));
+			for( int k = 0; k < 3; ++k ) {
+				float lo = points[0][k], hi = points[0][k];
+				for( int i = 1; i < n; ++i ) {
+					lo = std::min(lo, points[i][k]);
+					hi = std::max(hi, points[i][k]);
+				}
+				Assert::AreEqual(lo, boxMin[k]);
+				Assert::AreEqual(hi, boxMax[k]);
+			}
+		}
+	}
+};
+
+}
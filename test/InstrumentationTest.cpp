@@ -0,0 +1,138 @@
+#include "CppUnitTest.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <hmath/Instrumentation.hpp>
+#include <hmath/Matrix3x3.hpp>
+#include <hmath/Vector3.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// the counters only exist when the whole project is built with HMATH_INSTRUMENTATION; the Debug configurations build
+// without it, so that the disabled macros are compiled and tested too
+#if defined(HMATH_INSTRUMENTATION)
+
+namespace hmath_test {
+
+TEST_CLASS(InstrumentationTest) {
+	TEST_METHOD(Counters) {
+		hm::resetInstrumentation();
+		hm::InstrumentationSnapshot before = hm::instrumentationSnapshot();
+		for( int i = 0; i < hm::NumCounters; ++i ) {
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(before.counters[i]));
+		}
+
+		// one regular and one singular 3x3 system
+		const hm::GaussianElimination solve;
+		const float regular[] = {2.0f, 0.0f, 0.0f, 0.0f, 3.0f, 0.0f, 0.0f, 0.0f, 4.0f};
+		const float singular[] = {1.0f, 2.0f, 3.0f, 2.0f, 4.0f, 6.0f, 0.0f, 0.0f, 1.0f};
+		float inverse[9], determinant;
+		Assert::IsTrue(solve(3, regular, inverse, determinant, nullptr, nullptr, nullptr, 0, nullptr));
+		Assert::IsFalse(solve(3, singular, inverse, determinant, nullptr, nullptr, nullptr, 0, nullptr));
+		hm::InstrumentationSnapshot after = hm::instrumentationSnapshot();
+		hm::InstrumentationSnapshot delta = after - before;
+		Assert::AreEqual(2ull, static_cast<unsigned long long>(delta[hm::Counter::GaussianEliminationCalls]));
+		Assert::AreEqual(1ull, static_cast<unsigned long long>(delta[hm::Counter::GaussianEliminationSingular]));
+		Assert::AreEqual(2ull, static_cast<unsigned long long>(delta.matrixSizes[3]));
+
+		// inverses, of which one fails
+		before = after;
+		bool invertible;
+		hm::inverse(hm::Matrix3x3::identity(), &invertible);
+		Assert::IsTrue(invertible);
+		hm::inverse(hm::Matrix3x3::zero(), &invertible);
+		Assert::IsFalse(invertible);
+		after = hm::instrumentationSnapshot();
+		delta = after - before;
+		Assert::AreEqual(2ull, static_cast<unsigned long long>(delta[hm::Counter::InverseCalls]));
+		Assert::AreEqual(1ull, static_cast<unsigned long long>(delta[hm::Counter::InverseNotInvertible]));
+
+		// normalization on another thread, which is aggregated after it exits
+		before = after;
+		std::thread worker([]() {
+			hm::Vector3 v({3.0f, 0.0f, 4.0f});
+			hm::normalize(v);
+			hm::Vector3 zero = hm::Vector3::zero();
+			hm::normalizeRobust(zero);
+		});
+		worker.join();
+		hm::Vector3 v({0.0f, 1.0f, 0.0f});
+		hm::normalize(v);
+		after = hm::instrumentationSnapshot();
+		delta = after - before;
+		Assert::AreEqual(3ull, static_cast<unsigned long long>(delta[hm::Counter::NormalizeCalls]));
+		Assert::AreEqual(1ull, static_cast<unsigned long long>(delta[hm::Counter::NormalizeZeroLength]));
+
+		// reset zeroes live and retired counters alike
+		hm::resetInstrumentation();
+		after = hm::instrumentationSnapshot();
+		for( int i = 0; i < hm::NumCounters; ++i ) {
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(after.counters[i]));
+		}
+		for( int i = 0; i <= hm::MaxCountedMatrixSize; ++i ) {
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(after.matrixSizes[i]));
+		}
+	}
+
+	TEST_METHOD(ResetRace) {
+		// a reset racing with another thread's increments is never undone by them
+		std::atomic<bool> stop(false);
+		std::atomic<unsigned long long> done(0);
+		std::thread worker([&]() {
+			hm::Vector3 v({3.0f, 0.0f, 4.0f});
+			while( !stop.load() ) {
+				hm::normalize(v);
+				done.fetch_add(1);
+			}
+		});
+		for( int i = 0; i < 10000; ++i ) {
+			const unsigned long long first = done.load();
+			hm::resetInstrumentation();
+			const hm::InstrumentationSnapshot snapshot = hm::instrumentationSnapshot();
+			const unsigned long long last = done.load();
+			// at most one call in flight across the reset is counted on top of those that completed since
+			Assert::IsTrue(static_cast<unsigned long long>(snapshot[hm::Counter::NormalizeCalls]) <= last - first + 1);
+		}
+		stop.store(true);
+		worker.join();
+	}
+
+	TEST_METHOD(Names) {
+		Assert::IsTrue(std::strcmp("inverse.calls", hm::counterName(hm::Counter::InverseCalls)) == 0);
+		Assert::IsTrue(std::strcmp("normalize.zero_length", hm::counterName(hm::Counter::NormalizeZeroLength)) == 0);
+	}
+};
+
+}
+
+#else
+
+namespace hmath_test {
+
+TEST_CLASS(InstrumentationTest) {
+	TEST_METHOD(Disabled) {
+		bool invertible;
+		hm::inverse(hm::Matrix3x3::zero(), &invertible);
+		Assert::IsFalse(invertible);
+		hm::Vector3 v({3.0f, 0.0f, 4.0f});
+		hm::normalize(v);
+		HMATH_COUNT(NormalizeCalls);
+		HMATH_COUNT_N(InverseCalls, 2);
+		HMATH_COUNT_MATRIX_SIZE(3);
+		hm::resetInstrumentation();
+
+		// nothing is counted, and the snapshot is all zero
+		const hm::InstrumentationSnapshot snapshot = hm::instrumentationSnapshot();
+		for( int i = 0; i < hm::NumCounters; ++i ) {
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(snapshot.counters[i]));
+		}
+		for( int i = 0; i <= hm::MaxCountedMatrixSize; ++i ) {
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(snapshot.matrixSizes[i]));
+		}
+		Assert::IsTrue(std::strcmp("inverse.calls", hm::counterName(hm::Counter::InverseCalls)) == 0);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <hmath/KdTree.hpp>
+#include <hmath/Vector3.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(KdTreeTest) {
+	static std::vector<hm::Vector3> randomPoints( int count, unsigned seed ) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+		std::vector<hm::Vector3> points(count);
+		for( auto& p : points ) {
+			p = {dist(rng), dist(rng), dist(rng)};
+		}
+		return points;
+	}
+
+	static std::vector<float> bruteForce( const std::vector<hm::Vector3>& points, const hm::Vector3& query ) {
+		std::vector<float> sqrDistances;
+		for( const auto& p : points ) {
+			sqrDistances.push_back(hm::sqrDistance(p, query));
+		}
+		std::sort(sqrDistances.begin(), sqrDistances.end());
+		return sqrDistances;
+	}
+
+	TEST_METHOD(Nearest) {
+		const auto points = randomPoints(5000, 1);
+		hm::KdTree<3> tree;
+		tree.build(points.data(), static_cast<int>(points.size()), 4);
+		Assert::AreEqual(5000, tree.size());
+
+		const auto queries = randomPoints(50, 2);
+		for( const auto& query : queries ) {
+			int indices[8];
+			float sqrDistances[8];
+			Assert::AreEqual(8, tree.nearest(query, 8, indices, sqrDistances));
+
+			const auto expected = bruteForce(points, query);
+			for( int i = 0; i < 8; ++i ) {
+				Assert::AreEqual(expected[i], sqrDistances[i], 1e-5f);
+				Assert::AreEqual(sqrDistances[i], hm::sqrDistance(points[indices[i]], query), 1e-5f);
+			}
+		}
+	}
+
+	TEST_METHOD(Approximate) {
+		const auto points = randomPoints(5000, 3);
+		hm::KdTree<3> tree;
+		tree.build(points.data(), static_cast<int>(points.size()));
+
+		const float epsilon = 0.5f;
+		const auto queries = randomPoints(50, 4);
+		for( const auto& query : queries ) {
+			int index;
+			float sqrDistance;
+			tree.nearest(query, 1, &index, &sqrDistance, epsilon);
+			const auto expected = bruteForce(points, query);
+			Assert::IsTrue(sqrDistance <= expected[0] * (1.0f + epsilon) * (1.0f + epsilon));
+		}
+	}
+
+	TEST_METHOD(Batch) {
+		const auto points = randomPoints(1000, 5);
+		hm::KdTree<3> tree;
+		tree.build(points.data(), static_cast<int>(points.size()));
+
+		const auto queries = randomPoints(100, 6);
+		std::vector<int> indices(100 * 4);
+		tree.nearest(queries.data(), 100, 4, indices.data(), nullptr, 0.0f, 3);
+		for( int q = 0; q < 100; ++q ) {
+			int expected[4];
+			tree.nearest(queries[q], 4, expected);
+			for( int i = 0; i < 4; ++i ) {
+				Assert::AreEqual(expected[i], indices[q * 4 + i]);
+			}
+		}
+
+		// fewer points than requested
+		hm::KdTree<3> small;
+		small.build(points.data(), 2);
+		small.nearest(queries.data(), 1, 4, indices.data());
+		Assert::AreEqual(-1, indices[2]);
+		Assert::AreEqual(-1, indices[3]);
+	}
+
+	TEST_METHOD(Radius) {
+		const auto points = randomPoints(5000, 7);
+		hm::KdTree<3> tree;
+		tree.build(points.data(), static_cast<int>(points.size()));
+
+		const hm::Vector3 query = {1.0f, -2.0f, 0.5f};
+		std::vector<int> indices;
+		const int found = tree.withinRadius(query, 3.0f, indices);
+		Assert::AreEqual(found, static_cast<int>(indices.size()));
+
+		const auto expected = bruteForce(points, query);
+		const auto expectedCount = std::upper_bound(expected.begin(), expected.end(), 9.0f) - expected.begin();
+		Assert::AreEqual(static_cast<int>(expectedCount), found);
+		for( int index : indices ) {
+			Assert::IsTrue(hm::sqrDistance(points[index], query) <= 9.0f);
+		}
+	}
+};
+
+}
@@ -0,0 +1,149 @@
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <hmath/Cholesky.hpp>
+#include <hmath/LeastSquares.hpp>
+#include <hmath/Parallel.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(LeastSquaresTest) {
+	// rows of the polynomial basis 1, t, t^2, ... at numRows points of [0, 1]
+	static std::vector<float> vandermonde( int numRows, int degree ) {
+		std::vector<float> A(numRows * (degree + 1));
+		for( int r = 0; r < numRows; ++r ) {
+			const float t = static_cast<float>(r) / static_cast<float>(numRows - 1);
+			float power = 1.0f;
+			for( int c = 0; c <= degree; ++c ) {
+				A[r * (degree + 1) + c] = power;
+				power *= t;
+			}
+		}
+		return A;
+	}
+
+	static std::vector<float> multiply( const std::vector<float>& A, const float* x, int numUnknowns ) {
+		std::vector<float> b(A.size() / numUnknowns, 0.0f);
+		for( size_t r = 0; r < b.size(); ++r ) {
+			for( int c = 0; c < numUnknowns; ++c ) {
+				b[r] += A[r * numUnknowns + c] * x[c];
+			}
+		}
+		return b;
+	}
+
+	TEST_METHOD(PolynomialFit) {
+		// an exact fit of a degree 5 polynomial, whose Vandermonde matrix has a condition number near 10^4
+		const int numRows = 500, k = 6;
+		const float coefficients[k] = {1.0f, -2.0f, 3.0f, 0.5f, -1.5f, 2.0f};
+		const std::vector<float> A = vandermonde(numRows, k - 1);
+		const std::vector<float> b = multiply(A, coefficients, k);
+
+		hm::LeastSquaresQR qr(k, 16);
+		qr.addRows(A.data(), b.data(), numRows);
+		Assert::AreEqual(static_cast<std::int64_t>(numRows), qr.numRows());
+		float x[k];
+		Assert::IsTrue(qr.solve(x));
+		float qrError = 0.0f;
+		for( int i = 0; i < k; ++i ) {
+			qrError = std::max(qrError, std::fabs(x[i] - coefficients[i]));
+		}
+		Assert::IsTrue(qrError < 0.05f);
+		Assert::IsTrue(qr.residualSumOfSquares() < 1e-6f);
+
+		// the normal equations square the condition number and lose far more
+		std::vector<float> AtA(k * k, 0.0f), Atb(k, 0.0f), normal(k);
+		for( int r = 0; r < numRows; ++r ) {
+			for( int i = 0; i < k; ++i ) {
+				Atb[i] += A[r * k + i] * b[r];
+				for( int j = 0; j < k; ++j ) {
+					AtA[i * k + j] += A[r * k + i] * A[r * k + j];
+				}
+			}
+		}
+		hm::CholeskyDecomposition<0>(k, AtA.data()).solve(Atb.data(), normal.data());
+		float normalError = 0.0f;
+		for( int i = 0; i < k; ++i ) {
+			normalError = std::max(normalError, std::fabs(normal[i] - coefficients[i]));
+		}
+		Assert::IsTrue(normalError > 10.0f * qrError);
+
+		// the factor is upper triangular
+		const float* R = qr.factor();
+		for( int r = 1; r <= k; ++r ) {
+			for( int c = 0; c < r; ++c ) {
+				Assert::AreEqual(0.0f, R[r * (k + 1) + c]);
+			}
+		}
+	}
+
+	TEST_METHOD(Residual) {
+		// fitting a line to points off the line leaves their squared distances
+		const float A[] = {1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 2.0f, 1.0f, 3.0f};
+		const float b[] = {0.0f, 2.0f, 2.0f, 4.0f};
+		float x[2], residual;
+		Assert::IsTrue(hm::solveLeastSquares(A, b, 4, 2, x, &residual));
+		Assert::AreEqual(0.2f, x[0], 1e-5f);
+		Assert::AreEqual(1.2f, x[1], 1e-5f);
+		float expected = 0.0f;
+		for( int r = 0; r < 4; ++r ) {
+			const float d = x[0] + x[1] * A[r * 2 + 1] - b[r];
+			expected += d * d;
+		}
+		Assert::AreEqual(expected, residual, 1e-5f);
+
+		// repeated columns have no unique solution
+		const float dependent[] = {1.0f, 2.0f, 2.0f, 4.0f, 3.0f, 6.0f};
+		Assert::IsFalse(hm::solveLeastSquares(dependent, b, 3, 2, x));
+		Assert::AreEqual(0.0f, x[0]);
+		float x3[3];
+		Assert::IsFalse(hm::LeastSquaresQR(3).solve(x3));
+	}
+
+	TEST_METHOD(Merge) {
+		std::mt19937 rng(17);
+		std::normal_distribution<float> noise(0.0f, 0.1f);
+		const int numRows = 100000, k = 4;
+		const float coefficients[k] = {0.5f, 2.0f, -1.0f, 3.0f};
+		const std::vector<float> A = vandermonde(numRows, k - 1);
+		std::vector<float> b = multiply(A, coefficients, k);
+		for( auto& value : b ) {
+			value += noise(rng);
+		}
+
+		// two halves merged match a single stream
+		hm::LeastSquaresQR all(k), first(k), second(k);
+		all.addRows(A.data(), b.data(), numRows);
+		first.addRows(A.data(), b.data(), numRows / 2);
+		second.addRows(A.data() + numRows / 2 * k, b.data() + numRows / 2, numRows - numRows / 2);
+		first.merge(second);
+		Assert::AreEqual(all.numRows(), first.numRows());
+		float expected[k], merged[k];
+		Assert::IsTrue(all.solve(expected));
+		Assert::IsTrue(first.solve(merged));
+		for( int i = 0; i < k; ++i ) {
+			Assert::AreEqual(expected[i], merged[i], 1e-2f);
+			Assert::AreEqual(coefficients[i], expected[i], 0.05f);
+		}
+		Assert::AreEqual(all.residualSumOfSquares(), first.residualSumOfSquares(), 1e-3f * all.residualSumOfSquares());
+
+		// the parallel solver gives the same result for any number of threads
+		hm::ThreadPool pool(4);
+		hm::setTaskExecutor(&pool);
+		float serial[k], parallel[k];
+		Assert::IsTrue(hm::solveLeastSquares(A.data(), b.data(), numRows, k, serial, nullptr, 1));
+		Assert::IsTrue(hm::solveLeastSquares(A.data(), b.data(), numRows, k, parallel));
+		hm::setTaskExecutor(nullptr);
+		for( int i = 0; i < k; ++i ) {
+			Assert::AreEqual(serial[i], parallel[i]);
+			Assert::AreEqual(expected[i], parallel[i], 1e-2f);
+		}
+	}
+};
+
+}
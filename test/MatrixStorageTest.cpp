@@ -0,0 +1,79 @@
+#include "CppUnitTest.h"
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <hmath/Aligned.hpp>
+#include <hmath/Matrix4x4.hpp>
+#include <hmath/MatrixStorage.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(MatrixStorageTest) {
+	static hm::Matrix4x4 sequence( int first ) {
+		hm::Matrix4x4 M;
+		for( int i = 0; i < 16; ++i ) {
+			M[i] = static_cast<float>(first + i);
+		}
+		return M;
+	}
+
+	TEST_METHOD(StoredMatrix) {
+		static_assert(std::is_trivially_copyable<hm::ColumnMajorMatrix4x4>::value, "StoredMatrix must be memcpy-able.");
+		static_assert(sizeof(hm::ColumnMajorMatrix4x4) == 16 * sizeof(float), "StoredMatrix must not be padded.");
+
+		const hm::Matrix4x4 M = hm::makeTranslation(1.0f, 2.0f, 3.0f);
+		const hm::ColumnMajorMatrix4x4 columns(M);
+		// translation is the last column of a row-vector matrix stored column-major
+		Assert::AreEqual(1.0f, columns.data()[3]);
+		Assert::AreEqual(2.0f, columns.data()[7]);
+		Assert::AreEqual(3.0f, columns.data()[11]);
+		const hm::RowMajorMatrix4x4 rows(M);
+		Assert::AreEqual(0, std::memcmp(rows.data(), &M[0], sizeof(rows)));
+
+		const hm::Matrix<2, 3> rect = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+		const hm::StoredMatrix<2, 3, hm::StorageOrder::ColumnMajor> stored(rect);
+		const float expected[6] = {1.0f, 4.0f, 2.0f, 5.0f, 3.0f, 6.0f};
+		for( int i = 0; i < 6; ++i ) {
+			Assert::AreEqual(expected[i], stored.data()[i]);
+		}
+		for( int r = 0; r < 2; ++r ) {
+			for( int c = 0; c < 3; ++c ) {
+				Assert::AreEqual(rect(r, c), stored(r, c));
+				Assert::AreEqual(rect(r, c), stored.toMatrix()(r, c));
+			}
+		}
+	}
+
+	TEST_METHOD(StoreMatrices) {
+		const int count = 9;
+		hm::AlignedArray<hm::Matrix4x4> matrices;
+		for( int i = 0; i < count; ++i ) {
+			matrices.push_back(sequence(i * 16));
+		}
+
+		// aligned targets take the streaming path, the offset one the plain path
+		hm::AlignedArray<float> aligned(count * 16 + 1);
+		for( float* target : {aligned.data(), aligned.data() + 1} ) {
+			hm::storeMatrices<hm::StorageOrder::ColumnMajor>(matrices.data(), count, target);
+			for( int i = 0; i < count; ++i ) {
+				for( int r = 0; r < 4; ++r ) {
+					for( int c = 0; c < 4; ++c ) {
+						Assert::AreEqual(matrices[i](r, c), target[i * 16 + c * 4 + r]);
+					}
+				}
+			}
+			hm::storeMatrices<hm::StorageOrder::RowMajor>(matrices.data(), count, target);
+			Assert::AreEqual(0, std::memcmp(target, matrices.data(), count * sizeof(hm::Matrix4x4)));
+		}
+
+		std::vector<hm::Matrix<3, 4>> affine(3, hm::Matrix<3, 4>({1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f}));
+		std::vector<float> target(3 * 12);
+		hm::storeMatrices<hm::StorageOrder::ColumnMajor>(affine.data(), 3, target.data());
+		Assert::AreEqual(5.0f, target[12 + 1]);
+		Assert::AreEqual(12.0f, target[24 + 11]);
+	}
+};
+
+}
@@ -1,7 +1,12 @@
 #include "CppUnitTest.h"
 #include "MathHelper.hpp"
+#include <limits>
+#include <new>
+#include <vector>
+#include <hmath/Aligned.hpp>
 #include <hmath/Matrix.hpp>
 #include <hmath/Matrix4x4.hpp>
+#include <hmath/MatrixBlock.hpp>
 #include <hmath/Vector4.hpp>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -52,6 +57,266 @@ TEST_CLASS(MatrixTest) {
 		Assert::AreEqual(-0.4828936039596641f, C.get(3, 2), EPSILON);
 		Assert::AreEqual(-0.282817066f, C.get(3, 3), EPSILON);
 	}
+
+	TEST_METHOD(InverseBatch) {
+		hm::Matrix4x4 M[11];
+		for( int i = 0; i < 11; ++i ) {
+			M[i] = hm::makeRotation(0.3f * i, 0.0f, 1.0f, 0.0f) * hm::makeTranslation(1.0f * i, -2.0f, 0.5f * i);
+		}
+		M[6] = hm::makeScale(1.0f, 0.0f, 1.0f);
+
+		hm::Matrix4x4 inv[11];
+		bool isInvertible[11];
+		hm::inverse(M, inv, isInvertible, 11);
+
+		const float EPSILON = 1e-5f;
+		for( int i = 0; i < 11; ++i ) {
+			bool expectedInvertible;
+			const auto expected = hm::inverse(M[i], &expectedInvertible);
+			Assert::AreEqual(expectedInvertible, isInvertible[i]);
+			for( int e = 0; e < 16; ++e ) {
+				Assert::AreEqual(expected[e], inv[i][e], EPSILON);
+			}
+		}
+		Assert::IsFalse(isInvertible[6]);
+	}
+
+	TEST_METHOD(NormalMatrix) {
+		hm::Matrix4x4 M[6];
+		for( int i = 0; i < 6; ++i ) {
+			M[i] = hm::makeScale(1.0f + i, 2.0f, (i % 2) ? -0.5f : 0.5f) * hm::makeRotation(0.7f * i, 1.0f, 0.0f, 0.0f) * hm::makeTranslation(3.0f, 1.0f * i, 0.0f);
+		}
+
+		hm::Matrix3x3 normal[6];
+		hm::normalMatrix(M, normal, 6);
+
+		const float EPSILON = 1e-5f;
+		for( int i = 0; i < 6; ++i ) {
+			const auto expected = hm::transpose(hm::inverse(hm::project(M[i])));
+			const auto single = hm::normalMatrix(M[i]);
+			for( int e = 0; e < 9; ++e ) {
+				Assert::AreEqual(expected[e], single[e], EPSILON);
+				Assert::AreEqual(expected[e], normal[i][e], EPSILON);
+			}
+		}
+
+		// without the division only the scale differs, and the orientation is kept
+		const auto unscaled = hm::normalMatrix(M[1], false);
+		const auto expected = hm::transpose(hm::inverse(hm::project(M[1])));
+		const float det = hm::determinant(hm::project(M[1]));
+		for( int e = 0; e < 9; ++e ) {
+			Assert::AreEqual(expected[e] * fabsf(det), unscaled[e], EPSILON);
+		}
+	}
+
+	TEST_METHOD(AlignedArray) {
+		hm::AlignedArray<hm::Matrix4x4> matrices(5);
+		Assert::IsTrue(hm::isAligned(matrices.data(), hm::CacheLineSize));
+		Assert::IsTrue(hm::isAligned(&matrices[1], alignof(hm::Matrix4x4)));
+
+		hm::AlignedArray<hm::Vector4> vectors(3);
+		vectors.push_back(hm::Vector4::one());
+		Assert::IsTrue(hm::isAligned(vectors.data(), hm::CacheLineSize));
+		Assert::AreEqual(1.0f, vectors[3][2], 0.0f);
+
+#if defined(HMATH_ALIGNED_STORAGE)
+		// the Release configurations build with the option; every element of an AlignedArray is aligned
+		Assert::AreEqual(static_cast<size_t>(hm::CacheLineSize), alignof(hm::Matrix4x4));
+		Assert::AreEqual(static_cast<size_t>(16), alignof(hm::Vector4));
+		for( const auto& matrix : matrices ) {
+			Assert::IsTrue(hm::isAligned(&matrix, hm::CacheLineSize));
+		}
+		for( const auto& vector : vectors ) {
+			Assert::IsTrue(hm::isAligned(&vector, 16));
+		}
+#if defined(__cpp_aligned_new)
+		// from C++17 on, std::allocator honors the alignment too
+		std::vector<hm::Matrix4x4> standard(3);
+		Assert::IsTrue(hm::isAligned(&standard[1], hm::CacheLineSize));
+#endif
+#else
+		Assert::AreEqual(alignof(float), alignof(hm::Matrix4x4));
+		Assert::AreEqual(alignof(float), alignof(hm::Vector4));
+#endif
+
+		// sizes that overflow are rejected rather than wrapped around to a small block
+		hm::AlignedAllocator<hm::Matrix4x4> allocator;
+		Assert::ExpectException<std::bad_array_new_length>([&allocator]() {
+			allocator.allocate(allocator.max_size() + 1);
+		});
+		Assert::IsNull(hm::alignedMalloc(std::numeric_limits<std::size_t>::max() - 8, hm::CacheLineSize));
+	}
+
+	template<int N>
+	static void checkGenericInverse() {
+		// diagonally dominant with a row swap needed in the first column
+		hm::Matrix<N, N> M;
+		for( int r = 0; r < N; ++r ) {
+			for( int c = 0; c < N; ++c ) {
+				M(r, c) = (r == c) ? 4.0f + r : 0.25f * ((r * 7 + c * 3) % 5) - 0.5f;
+			}
+		}
+		M(0, 0) = 0.0f;
+
+		bool invertible;
+		const hm::Matrix<N, N> inv = hm::inverse(M, &invertible);
+		Assert::IsTrue(invertible);
+		const hm::Matrix<N, N> product = hm::multiplyAB(M, inv);
+		for( int r = 0; r < N; ++r ) {
+			for( int c = 0; c < N; ++c ) {
+				Assert::AreEqual((r == c) ? 1.0f : 0.0f, product(r, c), 1e-5f);
+			}
+		}
+
+		hm::Matrix<N, N> reference;
+		float referenceDeterminant;
+		hm::GaussianElimination()(N, &M[0], &reference[0], referenceDeterminant, nullptr, nullptr, nullptr, 0, nullptr);
+		const float det = hm::determinant(M);
+		Assert::AreEqual(referenceDeterminant, det, 1e-5f * fabsf(referenceDeterminant));
+		for( int e = 0; e < N * N; ++e ) {
+			Assert::AreEqual(reference[e], inv[e], 1e-5f * (1.0f + fabsf(reference[e])));
+		}
+
+		// singular
+		for( int c = 0; c < N; ++c ) {
+			M(N - 1, c) = 0.0f;
+		}
+		const hm::Matrix<N, N> singular = hm::inverse(M, &invertible);
+		Assert::IsFalse(invertible);
+		Assert::AreEqual(0.0f, hm::determinant(M));
+		Assert::AreEqual(0.0f, singular[N + 1]);
+	}
+
+	template<int Rows, int Cols>
+	static hm::Matrix<Rows, Cols> pattern( int seed ) {
+		hm::Matrix<Rows, Cols> M;
+		for( int i = 0; i < Rows * Cols; ++i ) {
+			M[i] = 0.125f * ((seed * 13 + i * 7) % 17) - 1.0f;
+		}
+		return M;
+	}
+
+	TEST_METHOD(MultiplyBatch) {
+		const int count = 37;
+		hm::AlignedArray<hm::Matrix4x4> A4(count), B4(count), C4(count);
+		std::vector<hm::Matrix<3, 6>> J(count);
+		std::vector<hm::Matrix<6, 3>> K(count);
+		std::vector<hm::Matrix<3, 3>> JK(count);
+		std::vector<hm::Matrix<4, 3>> affineA(count), affineB(count), affineC(count);
+		for( int i = 0; i < count; ++i ) {
+			A4[i] = hm::makeRotation(0.1f * i, 1.0f, 2.0f, 0.5f) * hm::makeTranslation(1.0f * i, -2.0f, 0.5f);
+			B4[i] = pattern<4, 4>(i);
+			J[i] = pattern<3, 6>(i);
+			K[i] = pattern<6, 3>(i + 5);
+			affineA[i] = hm::Matrix<4, 3>({A4[i][0], A4[i][1], A4[i][2], A4[i][4], A4[i][5], A4[i][6], A4[i][8], A4[i][9], A4[i][10], A4[i][12], A4[i][13], A4[i][14]});
+			affineB[i] = pattern<4, 3>(i + 1);
+		}
+
+		const float EPSILON = 1e-5f;
+		hm::multiplyBA(A4.data(), B4.data(), C4.data(), count);
+		hm::multiplyAB(J.data(), K.data(), JK.data(), count);
+		hm::multiplyAffine(affineA.data(), affineB.data(), affineC.data(), count);
+		for( int i = 0; i < count; ++i ) {
+			const hm::Matrix4x4 expected = A4[i] * B4[i];
+			const hm::Matrix<3, 3> expectedJK = hm::multiplyAB(J[i], K[i]);
+			for( int e = 0; e < 16; ++e ) {
+				Assert::AreEqual(expected[e], C4[i][e], EPSILON);
+			}
+			for( int e = 0; e < 9; ++e ) {
+				Assert::AreEqual(expectedJK[e], JK[i][e], EPSILON);
+			}
+
+			// affine composition matches the full 4x4 product
+			hm::Matrix4x4 liftedB = hm::Matrix4x4::identity();
+			for( int r = 0; r < 4; ++r ) {
+				for( int c = 0; c < 3; ++c ) {
+					liftedB(r, c) = affineB[i](r, c);
+				}
+			}
+			const hm::Matrix4x4 full = A4[i] * liftedB;
+			const hm::Matrix<4, 3> single = hm::multiplyAffine(affineA[i], affineB[i]);
+			for( int r = 0; r < 4; ++r ) {
+				for( int c = 0; c < 3; ++c ) {
+					Assert::AreEqual(full(r, c), single(r, c), EPSILON);
+					Assert::AreEqual(full(r, c), affineC[i](r, c), EPSILON);
+				}
+			}
+		}
+
+		// the same products in interleaved blocks
+		const int numBlocks = (count + hm::SimdWidth - 1) / hm::SimdWidth;
+		hm::AlignedArray<hm::MatrixBlock<4, 4>> blockA4(numBlocks), blockB4(numBlocks), blockC4(numBlocks);
+		hm::AlignedArray<hm::MatrixBlock<3, 6>> blockJ(numBlocks);
+		hm::AlignedArray<hm::MatrixBlock<6, 3>> blockK(numBlocks);
+		hm::AlignedArray<hm::MatrixBlock<3, 3>> blockJK(numBlocks);
+		hm::AlignedArray<hm::MatrixBlock<4, 3>> blockAffineA(numBlocks), blockAffineB(numBlocks);
+		hm::packBlocks(A4.data(), count, blockA4.data());
+		hm::packBlocks(B4.data(), count, blockB4.data());
+		hm::packBlocks(J.data(), count, blockJ.data());
+		hm::packBlocks(K.data(), count, blockK.data());
+		hm::packBlocks(affineA.data(), count, blockAffineA.data());
+		hm::packBlocks(affineB.data(), count, blockAffineB.data());
+		Assert::AreEqual(0.0f, blockA4[numBlocks - 1].get(hm::SimdWidth - 1)(3, 3));
+		hm::multiplyBA(blockA4.data(), blockB4.data(), blockC4.data(), numBlocks);
+		hm::multiplyAB(blockJ.data(), blockK.data(), blockJK.data(), numBlocks);
+		hm::multiplyAffine(blockAffineA.data(), blockAffineB.data(), blockAffineB.data(), numBlocks);
+		hm::AlignedArray<hm::Matrix4x4> unpackedC4(count);
+		std::vector<hm::Matrix<3, 3>> unpackedJK(count);
+		std::vector<hm::Matrix<4, 3>> unpackedAffine(count);
+		hm::unpackBlocks(blockC4.data(), count, unpackedC4.data());
+		hm::unpackBlocks(blockJK.data(), count, unpackedJK.data());
+		hm::unpackBlocks(blockAffineB.data(), count, unpackedAffine.data());
+		for( int i = 0; i < count; ++i ) {
+			for( int e = 0; e < 16; ++e ) {
+				Assert::AreEqual(C4[i][e], unpackedC4[i][e], EPSILON);
+			}
+			for( int e = 0; e < 9; ++e ) {
+				Assert::AreEqual(JK[i][e], unpackedJK[i][e], EPSILON);
+				Assert::AreEqual(JK[i][e], blockJK[i / hm::SimdWidth].get(i % hm::SimdWidth)[e], EPSILON);
+			}
+			for( int e = 0; e < 12; ++e ) {
+				Assert::AreEqual(affineC[i][e], unpackedAffine[i][e], EPSILON);
+			}
+		}
+
+		// in place
+		hm::multiplyBA(A4.data(), B4.data(), B4.data(), count);
+		for( int i = 0; i < count; ++i ) {
+			for( int e = 0; e < 16; ++e ) {
+				Assert::AreEqual(C4[i][e], B4[i][e]);
+			}
+		}
+	}
+
+	TEST_METHOD(GenericSizes) {
+		checkGenericInverse<5>();
+		checkGenericInverse<6>();
+		checkGenericInverse<8>();
+		checkGenericInverse<9>();
+
+		const hm::Matrix<3, 4> A = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f};
+		const hm::Matrix<4, 3> At = hm::transpose(A);
+		for( int r = 0; r < 3; ++r ) {
+			for( int c = 0; c < 4; ++c ) {
+				Assert::AreEqual(A(r, c), At(c, r));
+			}
+		}
+
+		// A * A^T
+		const hm::Matrix<3, 3> AAt = hm::multiplyAB(A, At);
+		Assert::AreEqual(30.0f, AAt(0, 0));
+		Assert::AreEqual(70.0f, AAt(0, 1));
+		Assert::AreEqual(278.0f, AAt(2, 1));
+
+		const hm::Vector<4> v({1.0f, -1.0f, 2.0f, 0.5f});
+		const hm::Vector<3> Av = A * v;
+		Assert::AreEqual(7.0f, Av[0]);
+		Assert::AreEqual(17.0f, Av[1]);
+		Assert::AreEqual(27.0f, Av[2]);
+		const hm::Vector<4> vA = hm::Vector<3>({1.0f, 0.0f, -1.0f}) * A;
+		Assert::AreEqual(-8.0f, vA[0]);
+		Assert::AreEqual(-8.0f, vA[3]);
+	}
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <hmath/Morton.hpp>
+#include <hmath/RadixSort.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(MortonTest) {
+	// reference interleave, one bit at a time
+	static std::uint64_t interleave( std::uint64_t x, std::uint64_t y, std::uint64_t z, int bits ) {
+		std::uint64_t code = 0;
+		for( int b = 0; b < bits; ++b ) {
+			code |= ((x >> b) & 1) << (3 * b);
+			code |= ((y >> b) & 1) << (3 * b + 1);
+			code |= ((z >> b) & 1) << (3 * b + 2);
+		}
+		return code;
+	}
+
+	TEST_METHOD(Encode) {
+		std::mt19937 rng(1);
+		for( int i = 0; i < 1000; ++i ) {
+			const std::uint32_t x = rng() & 0x3ff, y = rng() & 0x3ff, z = rng() & 0x3ff;
+			const std::uint32_t code = hm::mortonEncode30(x, y, z);
+			Assert::IsTrue(code == interleave(x, y, z, 10));
+			std::uint32_t dx, dy, dz;
+			hm::mortonDecode30(code, dx, dy, dz);
+			Assert::IsTrue(dx == x && dy == y && dz == z);
+
+			const std::uint64_t X = rng() & 0x1fffff, Y = rng() & 0x1fffff, Z = rng() & 0x1fffff;
+			const std::uint64_t code64 = hm::mortonEncode63(X, Y, Z);
+			Assert::IsTrue(code64 == interleave(X, Y, Z, 21));
+			std::uint64_t DX, DY, DZ;
+			hm::mortonDecode63(code64, DX, DY, DZ);
+			Assert::IsTrue(DX == X && DY == Y && DZ == Z);
+		}
+
+		// quantization within the box, clamped outside of it
+		const hm::Vector3 boxMin({-1.0f, 0.0f, 2.0f});
+		const hm::Vector3 boxMax({1.0f, 4.0f, 3.0f});
+		Assert::IsTrue(hm::mortonCode30(boxMin, boxMin, boxMax) == 0u);
+		Assert::IsTrue(hm::mortonCode30(boxMax, boxMin, boxMax) == 0x3fffffffu);
+		Assert::IsTrue(hm::mortonCode30(hm::Vector3({5.0f, 9.0f, 9.0f}), boxMin, boxMax) == 0x3fffffffu);
+		Assert::IsTrue(hm::mortonCode63(boxMax, boxMin, boxMax) == 0x7fffffffffffffffull);
+
+		std::uniform_real_distribution<float> dist(-1.0f, 4.0f);
+		std::vector<hm::Vector3> points(5000);
+		for( auto& p : points ) {
+			p = {dist(rng), dist(rng), dist(rng)};
+		}
+		std::vector<std::uint32_t> codes(points.size());
+		std::vector<std::uint64_t> codes64(points.size());
+		hm::mortonCodes30(points.data(), static_cast<int>(points.size()), boxMin, boxMax, codes.data(), 3);
+		hm::mortonCodes63(points.data(), static_cast<int>(points.size()), boxMin, boxMax, codes64.data(), 3);
+		for( size_t i = 0; i < points.size(); ++i ) {
+			Assert::IsTrue(codes[i] == hm::mortonCode30(points[i], boxMin, boxMax));
+			Assert::IsTrue(codes64[i] == hm::mortonCode63(points[i], boxMin, boxMax));
+		}
+	}
+
+	template<typename Key>
+	static void checkPermutation( const std::vector<Key>& keys, int numThreads ) {
+		const int count = static_cast<int>(keys.size());
+		std::vector<int> expected(count);
+		std::iota(expected.begin(), expected.end(), 0);
+		std::stable_sort(expected.begin(), expected.end(), [&keys]( int a, int b ) { return keys[a] < keys[b]; });
+		std::vector<int> permutation(count, -1);
+		hm::radixSortPermutation(keys.data(), count, permutation.data(), numThreads);
+		Assert::IsTrue(permutation == expected);
+	}
+
+	TEST_METHOD(RadixSort) {
+		std::mt19937_64 rng(2);
+		for( int count : {0, 1, 7, 1000, 30000} ) {
+			std::vector<std::uint32_t> keys(count);
+			std::vector<std::uint64_t> keys64(count);
+			std::vector<std::uint32_t> fewKeys(count);
+			for( int i = 0; i < count; ++i ) {
+				keys[i] = static_cast<std::uint32_t>(rng());
+				keys64[i] = rng();
+				// many duplicates and uniform high digits, to test stability and skipped passes
+				fewKeys[i] = static_cast<std::uint32_t>(rng() % 5) << 8;
+			}
+			for( int numThreads : {1, 4} ) {
+				checkPermutation(keys, numThreads);
+				checkPermutation(keys64, numThreads);
+				checkPermutation(fewKeys, numThreads);
+			}
+		}
+	}
+
+	TEST_METHOD(SortByKey) {
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+		const int count = 10000;
+		std::vector<hm::Vector3> points(count);
+		std::vector<int> payload(count);
+		for( int i = 0; i < count; ++i ) {
+			points[i] = {dist(rng), dist(rng), dist(rng)};
+			payload[i] = i;
+		}
+		const std::vector<hm::Vector3> original = points;
+
+		std::vector<std::uint32_t> codes(count);
+		hm::mortonCodes30(points.data(), count, hm::Vector3({0.0f, 0.0f, 0.0f}), hm::Vector3({1.0f, 1.0f, 1.0f}), codes.data());
+		hm::radixSortByKey(codes.data(), count, 2, points.data(), payload.data());
+
+		Assert::IsTrue(std::is_sorted(codes.begin(), codes.end()));
+		for( int i = 0; i < count; ++i ) {
+			Assert::IsTrue(hm::sqrDistance(points[i], original[payload[i]]) == 0.0f);
+			Assert::IsTrue(codes[i] == hm::mortonCode30(points[i], hm::Vector3({0.0f, 0.0f, 0.0f}), hm::Vector3({1.0f, 1.0f, 1.0f})));
+		}
+	}
+};
+
+}
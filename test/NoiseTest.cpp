@@ -0,0 +1,116 @@
+#include "CppUnitTest.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <hmath/Aligned.hpp>
+#include <hmath/Noise.hpp>
+#include <hmath/Vector2.hpp>
+#include <hmath/Vector3.hpp>
+#include <hmath/Vector4.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(NoiseTest) {
+	template<int N>
+	static hm::AlignedArray<hm::Vector<N>> randomPoints( int count, unsigned seed ) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> dist(-50.0f, 50.0f);
+		hm::AlignedArray<hm::Vector<N>> points(count);
+		for( auto& p : points ) {
+			for( int k = 0; k < N; ++k ) {
+				p[k] = dist(rng);
+			}
+		}
+		return points;
+	}
+
+	// compares the analytic gradient with central differences
+	template<int N, typename Noise>
+	static void checkGradients( Noise noise ) {
+		const float h = 1e-3f;
+		for( const auto& point : randomPoints<N>(500, N) ) {
+			hm::Vector<N> gradient;
+			const float value = noise(point, &gradient);
+			Assert::IsTrue(std::fabs(value) <= 1.0f);
+			for( int k = 0; k < N; ++k ) {
+				hm::Vector<N> above = point, below = point;
+				above[k] += h;
+				below[k] -= h;
+				Assert::AreEqual((noise(above, nullptr) - noise(below, nullptr)) / (2.0f * h), gradient[k], 2e-2f);
+			}
+		}
+	}
+
+	template<int N>
+	static void checkBatch() {
+		const auto points = randomPoints<N>(77, 10 + N);
+		const int count = static_cast<int>(points.size());
+		std::vector<float> values(count);
+		hm::AlignedArray<hm::Vector<N>> gradients(count);
+
+		hm::simplexNoise(points.data(), count, values.data(), gradients.data());
+		for( int i = 0; i < count; ++i ) {
+			hm::Vector<N> gradient;
+			Assert::AreEqual(hm::simplexNoise(points[i], &gradient), values[i], 1e-5f);
+			for( int k = 0; k < N; ++k ) {
+				Assert::AreEqual(gradient[k], gradients[i][k], 1e-4f);
+			}
+		}
+
+		hm::perlinNoise(points.data(), count, values.data(), gradients.data());
+		for( int i = 0; i < count; ++i ) {
+			hm::Vector<N> gradient;
+			Assert::AreEqual(hm::perlinNoise(points[i], &gradient), values[i], 1e-5f);
+			for( int k = 0; k < N; ++k ) {
+				Assert::AreEqual(gradient[k], gradients[i][k], 1e-4f);
+			}
+		}
+
+		hm::fbm(points.data(), count, 5, 2.0f, 0.5f, values.data());
+		for( int i = 0; i < count; ++i ) {
+			Assert::AreEqual(hm::fbm(points[i], 5), values[i], 1e-5f);
+		}
+	}
+
+	TEST_METHOD(Deterministic) {
+		// fixed reference values; the hash has no state and no tables
+		Assert::AreEqual(0.204595f, hm::simplexNoise(hm::Vector2({0.3f, -1.7f})), 1e-5f);
+		Assert::AreEqual(0.098127f, hm::simplexNoise(hm::Vector3({0.3f, -1.7f, 2.9f})), 1e-5f);
+		Assert::AreEqual(0.197103f, hm::simplexNoise(hm::Vector4({0.3f, -1.7f, 2.9f, 4.1f})), 1e-5f);
+		Assert::AreEqual(-0.036568f, hm::perlinNoise(hm::Vector2({0.3f, -1.7f})), 1e-5f);
+		Assert::AreEqual(-0.014262f, hm::perlinNoise(hm::Vector3({0.3f, -1.7f, 2.9f})), 1e-5f);
+		Assert::AreEqual(0.073486f, hm::perlinNoise(hm::Vector4({0.3f, -1.7f, 2.9f, 4.1f})), 1e-5f);
+
+		// Perlin noise vanishes on the lattice and repeats every 289 units
+		Assert::AreEqual(0.0f, hm::perlinNoise(hm::Vector3({4.0f, -7.0f, 12.0f})), 1e-6f);
+		const hm::Vector2 p({3.25f, 8.5f});
+		Assert::AreEqual(hm::perlinNoise(p), hm::perlinNoise(hm::Vector2({3.25f + 289.0f, 8.5f})), 1e-4f);
+	}
+
+	TEST_METHOD(Gradients) {
+		checkGradients<2>([]( const hm::Vector2& p, hm::Vector2* g ) { return hm::simplexNoise(p, g); });
+		checkGradients<3>([]( const hm::Vector3& p, hm::Vector3* g ) { return hm::simplexNoise(p, g); });
+		checkGradients<4>([]( const hm::Vector4& p, hm::Vector4* g ) { return hm::simplexNoise(p, g); });
+		checkGradients<2>([]( const hm::Vector2& p, hm::Vector2* g ) { return hm::perlinNoise(p, g); });
+		checkGradients<3>([]( const hm::Vector3& p, hm::Vector3* g ) { return hm::perlinNoise(p, g); });
+		checkGradients<4>([]( const hm::Vector4& p, hm::Vector4* g ) { return hm::perlinNoise(p, g); });
+		// three octaves at 1, 2 and 4 times the frequency, scaled down to keep the value within [-1, 1]
+		checkGradients<3>([]( const hm::Vector3& p, hm::Vector3* g ) {
+			const float value = hm::fbm(p, 3, 2.0f, 0.5f, g);
+			if( g ) {
+				*g *= 0.5f;
+			}
+			return 0.5f * value;
+		});
+	}
+
+	TEST_METHOD(Batch) {
+		checkBatch<2>();
+		checkBatch<3>();
+		checkBatch<4>();
+	}
+};
+
+}
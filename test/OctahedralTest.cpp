@@ -0,0 +1,66 @@
+#include "CppUnitTest.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <hmath/Octahedral.hpp>
+#include <hmath/Random.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(OctahedralTest) {
+	// angle between two directions in degrees, in double so that tiny errors are resolved
+	static double angle( const hm::Vector3& a, const hm::Vector3& b ) {
+		const double cx = double(a[1]) * b[2] - double(a[2]) * b[1];
+		const double cy = double(a[2]) * b[0] - double(a[0]) * b[2];
+		const double cz = double(a[0]) * b[1] - double(a[1]) * b[0];
+		const double d = double(a[0]) * b[0] + double(a[1]) * b[1] + double(a[2]) * b[2];
+		return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), d) * 57.29577951308232;
+	}
+
+	TEST_METHOD(Axes) {
+		const hm::Vector3 axes[6] = {hm::Vector3({1.0f, 0.0f, 0.0f}), hm::Vector3({-1.0f, 0.0f, 0.0f}), hm::Vector3({0.0f, 1.0f, 0.0f}), hm::Vector3({0.0f, -1.0f, 0.0f}), hm::Vector3({0.0f, 0.0f, 1.0f}), hm::Vector3({0.0f, 0.0f, -1.0f})};
+		for( const hm::Vector3& axis : axes ) {
+			Assert::IsTrue(hm::sqrDistance(axis, hm::decodeOctahedral32(hm::encodeOctahedral32(axis))) == 0.0f);
+			Assert::IsTrue(hm::sqrDistance(axis, hm::decodeOctahedral16(hm::encodeOctahedral16(axis))) == 0.0f);
+			// unnormalized input
+			Assert::IsTrue(hm::sqrDistance(axis, hm::decodeOctahedral32(hm::encodeOctahedral32(axis * 7.5f))) == 0.0f);
+		}
+		Assert::AreEqual(0u, hm::encodeOctahedral32(hm::Vector3({0.0f, 0.0f, 1.0f})));
+		Assert::AreEqual(0x7fffu, hm::encodeOctahedral32(hm::Vector3({1.0f, 0.0f, 0.0f})));
+		Assert::IsTrue(hm::sqrDistance(hm::Vector3({0.0f, 0.0f, 1.0f}), hm::decodeOctahedral32(hm::encodeOctahedral32(hm::Vector3({0.0f, 0.0f, 0.0f})))) == 0.0f);
+	}
+
+	TEST_METHOD(ErrorBounds) {
+		hm::Random random(5);
+		const int count = 100003;
+		std::vector<hm::Vector3> directions(count);
+		hm::sampleSphere(random, directions.data(), count);
+
+		std::vector<std::uint32_t> codes32(count);
+		std::vector<std::uint16_t> codes16(count);
+		std::vector<hm::Vector3> decoded32(count), decoded16(count);
+		hm::encodeOctahedral32(directions.data(), count, codes32.data());
+		hm::decodeOctahedral32(codes32.data(), count, decoded32.data());
+		hm::encodeOctahedral16(directions.data(), count, codes16.data());
+		hm::decodeOctahedral16(codes16.data(), count, decoded16.data());
+
+		// the documented worst cases are 0.00247 and 0.637 degrees
+		for( int i = 0; i < count; ++i ) {
+			Assert::IsTrue(angle(directions[i], decoded32[i]) < 0.0026);
+			Assert::IsTrue(angle(directions[i], decoded16[i]) < 0.66);
+			Assert::AreEqual(1.0f, hm::length(decoded32[i]), 1e-6f);
+			Assert::AreEqual(1.0f, hm::length(decoded16[i]), 1e-6f);
+
+			// batch and single forms agree up to rounding of the arithmetic
+			Assert::IsTrue(hm::sqrDistance(decoded32[i], hm::decodeOctahedral32(codes32[i])) < 1e-12f);
+			Assert::IsTrue(angle(directions[i], hm::decodeOctahedral32(hm::encodeOctahedral32(directions[i]))) < 0.0026);
+			// and pick the same codes, whether or not the compiler fuses multiply-adds
+			Assert::AreEqual(codes32[i], hm::encodeOctahedral32(directions[i]));
+			Assert::AreEqual(codes16[i], hm::encodeOctahedral16(directions[i]));
+		}
+	}
+};
+
+}
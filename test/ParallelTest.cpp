@@ -0,0 +1,151 @@
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include <hmath/Parallel.hpp>
+#include <hmath/RadixSort.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(ParallelTest) {
+	// runs the workers one after another, last first, counting them
+	class ReverseExecutor : public hm::TaskExecutor {
+	public:
+		ReverseExecutor() : calls(0) {
+		}
+		int concurrency() const override {
+			return 3;
+		}
+		void run( int count, TaskFunction task, void* context ) override {
+			for( int i = count - 1; i >= 0; --i ) {
+				++calls;
+				task(context, i);
+			}
+		}
+		int calls;
+	};
+
+	// checks that every index of [begin, end) is visited exactly once, in ranges of the grain size
+	static void checkCoverage( int begin, int end, int grainSize, int numThreads ) {
+		std::vector<std::atomic<int>> visits(end);
+		for( auto& v : visits ) {
+			v.store(0);
+		}
+		std::atomic<bool> grainsMatch(true);
+		hm::parallelFor(begin, end, grainSize, [&]( int first, int last ) {
+			if( grainSize > 0 && last - first != grainSize && last != end ) {
+				grainsMatch = false;
+			}
+			for( int i = first; i < last; ++i ) {
+				visits[i].fetch_add(1);
+			}
+		}, numThreads);
+		for( int i = 0; i < end; ++i ) {
+			Assert::AreEqual(i < begin ? 0 : 1, visits[i].load());
+		}
+		Assert::IsTrue(grainsMatch.load());
+	}
+
+	TEST_METHOD(ParallelFor) {
+		hm::ThreadPool pool(4);
+		Assert::AreEqual(4, pool.concurrency());
+		hm::setTaskExecutor(&pool);
+		const int grains[] = {0, 1, 7, 64, 5000};
+		for( int grain : grains ) {
+			checkCoverage(0, 10000, grain, 0);
+			checkCoverage(13, 1001, grain, 2);
+			checkCoverage(0, 3, grain, 0);
+		}
+		checkCoverage(5, 5, 1, 0);
+
+		// unbalanced work is stolen, and loops nested in a worker run on it
+		std::atomic<long long> total(0);
+		hm::parallelFor(0, 64, 1, [&]( int first, int last ) {
+			for( int i = first; i < last; ++i ) {
+				const int inner = (i % 8 == 0) ? 20000 : 10;
+				hm::parallelFor(0, inner, 100, [&]( int a, int b ) {
+					total += b - a;
+				});
+			}
+		});
+		Assert::IsTrue(total.load() == 8 * 20000 + 56 * 10);
+		hm::setTaskExecutor(nullptr);
+	}
+
+	TEST_METHOD(ParallelReduce) {
+		std::vector<float> values(100000);
+		for( int i = 0; i < static_cast<int>(values.size()); ++i ) {
+			values[i] = 1.0f / (1.0f + static_cast<float>(i % 977));
+		}
+		const int count = static_cast<int>(values.size());
+		auto sumRange = [&]( int first, int last ) {
+			return std::accumulate(values.begin() + first, values.begin() + last, 0.0f);
+		};
+		auto add = []( float a, float b ) {
+			return a + b;
+		};
+
+		// combined in range order, so the same as a serial sum of the ranges whatever the threads
+		float expected = 0.0f;
+		for( int first = 0; first < count; first += 1000 ) {
+			expected += sumRange(first, std::min(count, first + 1000));
+		}
+		hm::ThreadPool pool(3);
+		hm::setTaskExecutor(&pool);
+		for( int threads = 1; threads <= 3; ++threads ) {
+			Assert::AreEqual(expected, hm::parallelReduce(0, count, 1000, 0.0f, sumRange, add, threads));
+		}
+		hm::setTaskExecutor(nullptr);
+		Assert::AreEqual(expected, hm::parallelReduce(0, count, 1000, 0.0f, sumRange, add));
+		Assert::AreEqual(-1.0f, hm::parallelReduce(4, 4, 1, -1.0f, sumRange, add));
+
+		// min and max in one pass
+		struct Bounds {
+			float lo, hi;
+		};
+		const Bounds bounds = hm::parallelReduce(0, count, 0, Bounds{1e30f, -1e30f}, [&]( int first, int last ) {
+			const auto range = std::minmax_element(values.begin() + first, values.begin() + last);
+			return Bounds{*range.first, *range.second};
+		}, []( Bounds a, Bounds b ) {
+			return Bounds{std::min(a.lo, b.lo), std::max(a.hi, b.hi)};
+		});
+		Assert::AreEqual(1.0f / 977.0f, bounds.lo);
+		Assert::AreEqual(1.0f, bounds.hi);
+	}
+
+	TEST_METHOD(ExternalExecutor) {
+		ReverseExecutor executor;
+		hm::setTaskExecutor(&executor);
+		Assert::IsTrue(&hm::taskExecutor() == &executor);
+
+		std::vector<int> visits(1000, 0);
+		hm::parallelFor(0, 1000, 10, [&]( int first, int last ) {
+			for( int i = first; i < last; ++i ) {
+				++visits[i];
+			}
+		});
+		Assert::AreEqual(3, executor.calls);
+		Assert::IsTrue(std::count(visits.begin(), visits.end(), 1) == 1000);
+
+		// library loops run on the installed executor too
+		std::vector<std::uint32_t> keys(5000);
+		for( int i = 0; i < 5000; ++i ) {
+			keys[i] = static_cast<std::uint32_t>((i * 7919) % 5000);
+		}
+		std::vector<int> permutation(5000);
+		hm::radixSortPermutation(keys.data(), 5000, permutation.data());
+		Assert::IsTrue(executor.calls > 3);
+		for( int i = 0; i < 5000; ++i ) {
+			Assert::IsTrue(keys[permutation[i]] == static_cast<std::uint32_t>(i));
+		}
+
+		hm::setTaskExecutor(nullptr);
+		Assert::IsTrue(&hm::taskExecutor() != &executor);
+	}
+};
+
+}
@@ -0,0 +1,122 @@
+#include "CppUnitTest.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <hmath/Random.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(RandomTest) {
+	// reference xoshiro128+ from the published algorithm
+	struct Reference {
+		std::uint32_t s[4];
+		std::uint32_t next() {
+			const std::uint32_t result = s[0] + s[3];
+			const std::uint32_t t = s[1] << 9;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = (s[3] << 11) | (s[3] >> 21);
+			return result;
+		}
+	};
+
+	TEST_METHOD(Sequence) {
+		// lane 0 is the plain generator seeded by splitmix64
+		std::uint64_t x = 42;
+		const std::uint64_t a = hm::detail::splitMix64(x);
+		const std::uint64_t b = hm::detail::splitMix64(x);
+		Reference reference = {{static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(a >> 32), static_cast<std::uint32_t>(b), static_cast<std::uint32_t>(b >> 32)}};
+		// lane 1 starts 2^64 steps later
+		Reference lane1 = reference;
+		hm::detail::xoshiroJump(lane1.s, hm::detail::XoshiroJump);
+
+		hm::Random random(42);
+		std::vector<std::uint32_t> values(hm::Random::Lanes * 20 + 5);
+		values[0] = random.nextUInt();
+		random.fill(values.data() + 1, static_cast<int>(values.size()) - 1);
+		for( int i = 0; i < 20; ++i ) {
+			Assert::IsTrue(values[i * hm::Random::Lanes] == reference.next());
+			Assert::IsTrue(values[i * hm::Random::Lanes + 1] == lane1.next());
+		}
+
+		// the same seed and stream reproduce the sequence; other streams differ
+		hm::Random same(42);
+		for( std::uint32_t value : values ) {
+			Assert::IsTrue(same.nextUInt() == value);
+		}
+		hm::Random stream1(42, 1);
+		hm::Random jumped(42);
+		jumped.jump();
+		int equal = 0;
+		for( std::uint32_t value : values ) {
+			const std::uint32_t next = stream1.nextUInt();
+			Assert::IsTrue(jumped.nextUInt() == next);
+			equal += (next == value);
+		}
+		Assert::IsTrue(equal < 2);
+
+		// floats are uniform in [0, 1)
+		std::vector<float> floats(100000);
+		random.fill(floats.data(), static_cast<int>(floats.size()));
+		double mean = 0.0;
+		for( float f : floats ) {
+			Assert::IsTrue(f >= 0.0f && f < 1.0f);
+			mean += f;
+		}
+		Assert::AreEqual(0.5, mean / floats.size(), 5e-3);
+	}
+
+	TEST_METHOD(Distributions) {
+		hm::Random random(7);
+		const int count = 20001;
+		std::vector<hm::Vector3> points(count);
+
+		hm::sampleSphere(random, points.data(), count);
+		hm::Vector3 sum({0.0f, 0.0f, 0.0f});
+		for( const auto& p : points ) {
+			Assert::AreEqual(1.0f, hm::length(p), 1e-5f);
+			sum += p;
+		}
+		Assert::AreEqual(0.0f, hm::length(sum) / count, 2e-2f);
+
+		hm::sampleHemisphere(random, points.data(), count);
+		float meanZ = 0.0f;
+		for( const auto& p : points ) {
+			Assert::AreEqual(1.0f, hm::length(p), 1e-5f);
+			Assert::IsTrue(p[2] >= 0.0f);
+			meanZ += p[2];
+		}
+		Assert::AreEqual(0.5f, meanZ / count, 1e-2f);
+
+		// E[cos theta] is 2/3 for the cosine-weighted density
+		hm::sampleCosineHemisphere(random, points.data(), count);
+		meanZ = 0.0f;
+		for( const auto& p : points ) {
+			Assert::AreEqual(1.0f, hm::length(p), 1e-5f);
+			Assert::IsTrue(p[2] >= 0.0f);
+			meanZ += p[2];
+		}
+		Assert::AreEqual(2.0f / 3.0f, meanZ / count, 1e-2f);
+
+		// half of the disk's area lies within radius 1/sqrt(2)
+		std::vector<hm::Vector2> disk(count);
+		hm::sampleDisk(random, disk.data(), count);
+		int inner = 0;
+		for( const auto& p : disk ) {
+			Assert::IsTrue(hm::length(p) <= 1.0f + 1e-6f);
+			inner += (hm::sqrLength(p) < 0.5f);
+		}
+		Assert::AreEqual(0.5f, static_cast<float>(inner) / count, 1.5e-2f);
+
+		Assert::AreEqual(1.0f, hm::length(hm::sampleSphere(random)), 1e-5f);
+		Assert::IsTrue(hm::sampleCosineHemisphere(random)[2] >= 0.0f);
+		Assert::IsTrue(hm::length(hm::sampleDisk(random)) <= 1.0f);
+	}
+};
+
+}
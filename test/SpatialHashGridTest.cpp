@@ -0,0 +1,110 @@
+#include "CppUnitTest.h"
+#include <limits>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include <hmath/SpatialHashGrid.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(SpatialHashGridTest) {
+	static std::vector<hm::Vector3> randomPoints( int count, unsigned seed ) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> dist(-5.0f, 5.0f);
+		std::vector<hm::Vector3> points(count);
+		for( auto& p : points ) {
+			p = {dist(rng), dist(rng), dist(rng)};
+		}
+		return points;
+	}
+
+	TEST_METHOD(Radius) {
+		const auto points = randomPoints(4000, 1);
+		hm::SpatialHashGrid grid;
+		// few buckets, so that many cells collide
+		grid.build(points.data(), static_cast<int>(points.size()), 0.5f, 3, 64);
+		Assert::AreEqual(4000, grid.size());
+
+		const auto queries = randomPoints(20, 2);
+		for( const auto& query : queries ) {
+			// radii spanning more cells than there are buckets, and more than fit into an int
+			for( float radius : {0.4f, 1.3f, 324.75f, 512.0f} ) {
+				std::vector<int> indices;
+				grid.withinRadius(query, radius, indices);
+
+				int expected = 0;
+				for( const auto& p : points ) {
+					expected += (hm::sqrDistance(p, query) <= radius * radius) ? 1 : 0;
+				}
+				Assert::AreEqual(expected, static_cast<int>(indices.size()));
+				for( int index : indices ) {
+					Assert::IsTrue(hm::sqrDistance(points[index], query) <= radius * radius);
+				}
+			}
+		}
+	}
+
+	TEST_METHOD(ExtremeValues) {
+		// points and queries far beyond the int range of cells, infinite and NaN
+		auto points = randomPoints(200, 4);
+		const float inf = std::numeric_limits<float>::infinity();
+		const float nan = std::numeric_limits<float>::quiet_NaN();
+		points.push_back(hm::Vector3({1e30f, 1e30f, 1e30f}));
+		points.push_back(hm::Vector3({1e30f, 1e30f, 1e30f}));
+		points.push_back(hm::Vector3({-inf, 0.0f, 0.0f}));
+		points.push_back(hm::Vector3({nan, 0.0f, 0.0f}));
+		hm::SpatialHashGrid grid;
+		grid.build(points.data(), static_cast<int>(points.size()), 0.5f, 2, 64);
+
+		const struct {
+			hm::Vector3 query;
+			float radius;
+		} queries[] = {
+			{hm::Vector3({1e30f, 1e30f, 1e30f}), 1.0f},
+			{hm::Vector3({0.0f, 0.0f, 0.0f}), 1e30f},
+			{hm::Vector3({0.0f, 0.0f, 0.0f}), inf},
+			{hm::Vector3({-inf, 0.0f, 0.0f}), 1.0f},
+			{hm::Vector3({0.0f, 0.0f, 0.0f}), 3.0f},
+		};
+		for( const auto& q : queries ) {
+			std::vector<int> indices;
+			grid.withinRadius(q.query, q.radius, indices);
+			int expected = 0;
+			for( const auto& p : points ) {
+				expected += (hm::sqrDistance(p, q.query) <= q.radius * q.radius) ? 1 : 0;
+			}
+			Assert::AreEqual(expected, static_cast<int>(indices.size()));
+		}
+
+		// NaN queries find nothing
+		std::vector<int> indices;
+		Assert::AreEqual(0, grid.withinRadius(hm::Vector3({nan, 0.0f, 0.0f}), 1.0f, indices));
+		Assert::AreEqual(0, grid.withinRadius(hm::Vector3({0.0f, 0.0f, 0.0f}), nan, indices));
+		Assert::IsTrue(indices.empty());
+	}
+
+	TEST_METHOD(Pairs) {
+		const auto points = randomPoints(1500, 3);
+		hm::SpatialHashGrid grid;
+		grid.build(points.data(), static_cast<int>(points.size()), 0.6f, 2, 128);
+
+		std::set<std::pair<int, int>> pairs;
+		grid.forEachPair(0.6f, [&pairs]( int i, int j, float ) {
+			const bool inserted = pairs.insert(std::make_pair(std::min(i, j), std::max(i, j))).second;
+			Assert::IsTrue(inserted);
+		});
+
+		size_t expected = 0;
+		for( size_t i = 0; i < points.size(); ++i ) {
+			for( size_t j = i + 1; j < points.size(); ++j ) {
+				expected += (hm::sqrDistance(points[i], points[j]) <= 0.36f) ? 1 : 0;
+			}
+		}
+		Assert::AreEqual(expected, pairs.size());
+	}
+};
+
+}
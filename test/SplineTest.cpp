@@ -0,0 +1,125 @@
+#include "CppUnitTest.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <hmath/Spline.hpp>
+#include <hmath/Vector2.hpp>
+#include <hmath/Vector3.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(SplineTest) {
+	template<int N>
+	static void assertNear( const hm::Vector<N>& expected, const hm::Vector<N>& actual, float tolerance=1e-5f ) {
+		for( int c = 0; c < N; ++c ) {
+			Assert::AreEqual(expected[c], actual[c], tolerance);
+		}
+	}
+
+	// de Casteljau, the scheme the power basis replaces
+	static hm::Vector3 deCasteljau( const hm::Vector3* p, float t ) {
+		const hm::Vector3 a = hm::lerp(p[0], p[1], t), b = hm::lerp(p[1], p[2], t), c = hm::lerp(p[2], p[3], t);
+		const hm::Vector3 d = hm::lerp(a, b, t), e = hm::lerp(b, c, t);
+		return hm::lerp(d, e, t);
+	}
+
+	TEST_METHOD(Curve) {
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+		hm::Vector3 p[4];
+		for( auto& point : p ) {
+			point = {dist(rng), dist(rng), dist(rng)};
+		}
+
+		const auto bezier = hm::CubicCurve<3>::bezier(p[0], p[1], p[2], p[3]);
+		for( float t = 0.0f; t <= 1.0f; t += 0.125f ) {
+			assertNear(deCasteljau(p, t), bezier.evaluate(t));
+			const float h = 1e-2f;
+			const hm::Vector3 slope = (bezier.evaluate(t + h) - bezier.evaluate(t - h)) / (2.0f * h);
+			assertNear(slope, bezier.derivative(t), 1e-2f);
+			Assert::AreEqual(1.0f, hm::length(bezier.tangent(t)), 1e-5f);
+		}
+		assertNear(3.0f * (p[1] - p[0]), bezier.derivative(0.0f));
+
+		const int steps = 200;
+		std::vector<hm::Vector3> points(steps + 1);
+		bezier.tessellate(steps, points.data());
+		for( int i = 0; i <= steps; ++i ) {
+			assertNear(bezier.evaluate(static_cast<float>(i) / steps), points[i], 1e-4f);
+		}
+		assertNear(p[3], points[steps]);
+
+		// Catmull-Rom passes through the inner points with central difference tangents
+		const auto catmullRom = hm::CubicCurve<3>::catmullRom(p[0], p[1], p[2], p[3]);
+		assertNear(p[1], catmullRom.evaluate(0.0f));
+		assertNear(p[2], catmullRom.evaluate(1.0f));
+		assertNear(0.5f * (p[3] - p[1]), catmullRom.derivative(1.0f));
+
+		const hm::CubicCurve<3> curves[] = {bezier, catmullRom};
+		std::vector<hm::Vector3> batch(2 * 9);
+		hm::tessellate(curves, 2, 8, batch.data());
+		assertNear(catmullRom.evaluate(0.5f), batch[9 + 4]);
+	}
+
+	TEST_METHOD(SplineAndArcLength) {
+		// a Catmull-Rom spline through evenly spaced collinear points is the line at uniform speed
+		const hm::Vector2 points[] = {{0.0f, 0.0f}, {1.0f, 1.0f}, {2.0f, 2.0f}, {3.0f, 3.0f}};
+		hm::CubicSpline<2> spline;
+		spline.setCatmullRom(points, 4);
+		Assert::AreEqual(3, spline.numSegments());
+		assertNear(hm::Vector2({1.5f, 1.5f}), spline.evaluate(1.5f));
+		assertNear(points[3], spline.evaluate(7.0f));
+
+		hm::ArcLengthTable<2> table;
+		table.build(spline, 8);
+		Assert::AreEqual(3.0f * std::sqrt(2.0f), table.length(), 1e-4f);
+		Assert::AreEqual(1.5f, table.parameterAt(0.5f * table.length()), 1e-4f);
+		Assert::AreEqual(3.0f, table.parameterAt(100.0f), 0.0f);
+
+		// a quarter circle from Bezier segments has a known length and a constant radius at equal arc steps
+		const float k = 0.5522847f;
+		const hm::Vector2 arc[] = {{1.0f, 0.0f}, {1.0f, k}, {k, 1.0f}, {0.0f, 1.0f}};
+		hm::CubicSpline<2> quarter;
+		quarter.setBezier(arc, 4);
+		table.build(quarter, 64);
+		Assert::AreEqual(0.5f * 3.14159265f, table.length(), 1e-3f);
+		for( int i = 0; i <= 8; ++i ) {
+			const hm::Vector2 point = quarter.evaluate(table.parameterAt(table.length() * i / 8.0f));
+			Assert::AreEqual(3.14159265f / 16.0f * i, std::atan2(point[1], point[0]), 2e-3f);
+		}
+
+		std::vector<hm::Vector2> tessellated(3 * 4 + 1);
+		spline.tessellate(4, tessellated.data());
+		for( int i = 0; i <= 12; ++i ) {
+			assertNear(spline.evaluate(i / 4.0f), tessellated[i]);
+		}
+	}
+
+	TEST_METHOD(Patch) {
+		std::mt19937 rng(2);
+		std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+		hm::Vector3 control[16];
+		for( auto& point : control ) {
+			point = {dist(rng), dist(rng), dist(rng)};
+		}
+		const hm::BezierPatch<3> patch(control);
+		assertNear(control[0], patch.evaluate(0.0f, 0.0f));
+		assertNear(control[3], patch.evaluate(1.0f, 0.0f));
+		assertNear(control[15], patch.evaluate(1.0f, 1.0f));
+		assertNear(3.0f * (control[1] - control[0]), patch.derivativeU(0.0f, 0.0f));
+		assertNear(3.0f * (control[4] - control[0]), patch.derivativeV(0.0f, 0.0f));
+
+		const int uSteps = 7, vSteps = 5;
+		std::vector<hm::Vector3> grid((uSteps + 1) * (vSteps + 1));
+		patch.tessellate(uSteps, vSteps, grid.data());
+		for( int j = 0; j <= vSteps; ++j ) {
+			for( int i = 0; i <= uSteps; ++i ) {
+				assertNear(patch.evaluate(static_cast<float>(i) / uSteps, static_cast<float>(j) / vSteps), grid[j * (uSteps + 1) + i], 1e-4f);
+			}
+		}
+	}
+};
+
+}
@@ -0,0 +1,166 @@
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include <hmath/Parallel.hpp>
+#include <hmath/SweepAndPrune.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace hmath_test {
+
+TEST_CLASS(SweepAndPruneTest) {
+	static std::vector<hm::AxisAlignedBox> randomBoxes( int count, float extent, float maxSize, std::mt19937& rng ) {
+		std::uniform_real_distribution<float> position(-extent, extent);
+		std::uniform_real_distribution<float> size(0.0f, maxSize);
+		std::vector<hm::AxisAlignedBox> boxes(count);
+		for( auto& box : boxes ) {
+			box.lower = {position(rng), position(rng), position(rng)};
+			box.upper = box.lower + hm::Vector3{size(rng), size(rng), size(rng)};
+		}
+		return boxes;
+	}
+
+	static std::set<std::pair<int, int>> bruteForce( const std::vector<hm::AxisAlignedBox>& boxes ) {
+		std::set<std::pair<int, int>> result;
+		for( int i = 0; i < static_cast<int>(boxes.size()); ++i ) {
+			for( int j = i + 1; j < static_cast<int>(boxes.size()); ++j ) {
+				bool overlap = true;
+				for( int a = 0; a < 3; ++a ) {
+					overlap = overlap && boxes[i].lower[a] <= boxes[j].upper[a] && boxes[j].lower[a] <= boxes[i].upper[a];
+				}
+				if( overlap ) {
+					result.insert({i, j});
+				}
+			}
+		}
+		return result;
+	}
+
+	static std::set<std::pair<int, int>> findPairs( const hm::SweepAndPrune& sap, int numThreads ) {
+		std::vector<hm::BoxPair> pairs(1 << 16);
+		const int count = sap.findPairs(pairs.data(), static_cast<int>(pairs.size()), numThreads);
+		Assert::IsTrue(count <= static_cast<int>(pairs.size()));
+		std::set<std::pair<int, int>> result;
+		for( int i = 0; i < count; ++i ) {
+			Assert::IsTrue(pairs[i].first < pairs[i].second);
+			result.insert({pairs[i].first, pairs[i].second});
+		}
+		// no pair is reported twice
+		Assert::AreEqual(count, static_cast<int>(result.size()));
+		return result;
+	}
+
+	TEST_METHOD(Pairs) {
+		std::mt19937 rng(1);
+		// spread along y, so that y becomes the sort axis
+		auto boxes = randomBoxes(2000, 10.0f, 1.0f, rng);
+		for( auto& box : boxes ) {
+			box.lower[1] *= 4.0f;
+			box.upper[1] = box.lower[1] + 1.0f;
+		}
+		// boxes that only touch overlap
+		boxes[0].lower = {100.0f, 100.0f, 100.0f};
+		boxes[0].upper = {101.0f, 101.0f, 101.0f};
+		boxes[1].lower = {101.0f, 100.5f, 100.5f};
+		boxes[1].upper = {102.0f, 102.0f, 102.0f};
+
+		hm::SweepAndPrune sap;
+		sap.update(boxes.data(), static_cast<int>(boxes.size()), 1);
+		Assert::AreEqual(2000, sap.size());
+		Assert::AreEqual(1, sap.sortAxis());
+		const auto expected = bruteForce(boxes);
+		Assert::IsTrue(expected.count({0, 1}) == 1);
+		Assert::IsTrue(findPairs(sap, 1) == expected);
+
+		// empty and single boxes
+		sap.update(boxes.data(), 1, 1);
+		hm::BoxPair pair;
+		Assert::AreEqual(0, sap.findPairs(&pair, 1, 1));
+		sap.update(boxes.data(), 0, 1);
+		Assert::AreEqual(0, sap.findPairs(&pair, 1, 1));
+		sap.clear();
+		Assert::AreEqual(0, sap.size());
+	}
+
+	TEST_METHOD(UnboundedBoxes) {
+		std::mt19937 rng(4);
+		auto boxes = randomBoxes(20, 5.0f, 1.0f, rng);
+		// a slab that is unbounded along every axis, and one that only ends below
+		const float inf = std::numeric_limits<float>::infinity();
+		hm::AxisAlignedBox slab;
+		slab.lower = {-inf, -inf, -inf};
+		slab.upper = {inf, inf, inf};
+		boxes.push_back(slab);
+		slab.lower = {0.0f, 0.0f, 0.0f};
+		boxes.push_back(slab);
+
+		hm::SweepAndPrune sap;
+		for( int numThreads = 1; numThreads <= 2; ++numThreads ) {
+			sap.update(boxes.data(), static_cast<int>(boxes.size()), numThreads);
+			const auto expected = bruteForce(boxes);
+			Assert::IsTrue(expected.count({20, 21}) == 1);
+			Assert::IsTrue(findPairs(sap, numThreads) == expected);
+		}
+	}
+
+	TEST_METHOD(Coherence) {
+		std::mt19937 rng(2);
+		auto boxes = randomBoxes(3000, 20.0f, 1.5f, rng);
+		std::normal_distribution<float> step(0.0f, 0.05f);
+		hm::SweepAndPrune sap;
+		for( int frame = 0; frame < 20; ++frame ) {
+			if( frame == 10 ) {
+				// bodies teleport, so that the insertion sort gives up
+				std::shuffle(boxes.begin(), boxes.end(), rng);
+			}
+			if( frame == 15 ) {
+				// a body is removed, so that the order is rebuilt
+				boxes.pop_back();
+			}
+			sap.update(boxes.data(), static_cast<int>(boxes.size()), 1);
+			Assert::IsTrue(findPairs(sap, 1) == bruteForce(boxes));
+
+			// the sort order stays a permutation
+			std::vector<int> sorted = sap.sortedIndices();
+			std::sort(sorted.begin(), sorted.end());
+			for( int i = 0; i < static_cast<int>(sorted.size()); ++i ) {
+				Assert::AreEqual(i, sorted[i]);
+			}
+
+			for( auto& box : boxes ) {
+				const hm::Vector3 delta{step(rng), step(rng), step(rng)};
+				box.lower = box.lower + delta;
+				box.upper = box.upper + delta;
+			}
+		}
+	}
+
+	TEST_METHOD(Parallel) {
+		hm::ThreadPool pool(4);
+		hm::setTaskExecutor(&pool);
+
+		std::mt19937 rng(3);
+		const auto boxes = randomBoxes(20000, 30.0f, 1.0f, rng);
+		hm::SweepAndPrune sap;
+		sap.update(boxes.data(), static_cast<int>(boxes.size()), 4);
+		const auto expected = findPairs(sap, 1);
+		Assert::IsTrue(findPairs(sap, 4) == expected);
+
+		// too small an output is filled up, and the full count is still returned
+		const int capacity = static_cast<int>(expected.size()) / 2;
+		std::vector<hm::BoxPair> pairs(capacity + 1, hm::BoxPair{-1, -1});
+		Assert::AreEqual(static_cast<int>(expected.size()), sap.findPairs(pairs.data(), capacity, 4));
+		for( int i = 0; i < capacity; ++i ) {
+			Assert::IsTrue(expected.count({pairs[i].first, pairs[i].second}) == 1);
+		}
+		Assert::AreEqual(-1, pairs[capacity].first);
+
+		hm::setTaskExecutor(nullptr);
+	}
+};
+
+}
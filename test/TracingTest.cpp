@@ -0,0 +1,190 @@
+#include "CppUnitTest.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <hmath/Matrix.hpp>
+#include <hmath/Tracing.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// spans are only recorded when the whole project is built with HMATH_TRACING; the Debug configurations build without
+// it, so that the disabled macros are compiled and tested too
+#if defined(HMATH_TRACING)
+
+namespace hmath_test {
+
+TEST_CLASS(TracingTest) {
+	// keeps every event it receives
+	class RecordingSink : public hm::TraceSink {
+	public:
+		void onSpan( const hm::TraceEvent& event ) override {
+			std::lock_guard<std::mutex> lock(mutex);
+			events.push_back(event);
+		}
+
+		std::mutex mutex;
+		std::vector<hm::TraceEvent> events;
+	};
+
+	static std::uint64_t sumBuckets( const hm::SpanHistogram& histogram, int argument ) {
+		std::uint64_t sum = 0;
+		for( int b = 0; b < hm::NumDurationBuckets; ++b ) {
+			sum += histogram.buckets[argument][b];
+		}
+		return sum;
+	}
+
+	TEST_METHOD(Spans) {
+		hm::resetTracing();
+		RecordingSink sink;
+		hm::setTraceSink(&sink);
+
+		// traced entry points and explicit scopes, with arguments past the last bucket
+		bool invertible;
+		hm::inverse(hm::Matrix<5, 5>::identity(), &invertible);
+		Assert::IsTrue(invertible);
+		{
+			HMATH_TRACE_BATCH(CholeskyBatch, 40, 7);
+		}
+		{
+			HMATH_TRACE_SCOPE(CholeskyBatch, -1);
+		}
+		hm::setTraceSink(nullptr);
+		{
+			HMATH_TRACE_SCOPE(CholeskyBatch, 2);
+		}
+
+		hm::TraceSnapshot snapshot;
+		hm::traceSnapshot(snapshot);
+		const hm::SpanHistogram& inverse = snapshot[hm::Span::Inverse];
+		Assert::AreEqual(1ull, static_cast<unsigned long long>(inverse.calls));
+		Assert::AreEqual(1ull, static_cast<unsigned long long>(sumBuckets(inverse, 5)));
+		const hm::SpanHistogram& batch = snapshot[hm::Span::CholeskyBatch];
+		Assert::AreEqual(3ull, static_cast<unsigned long long>(batch.calls));
+		Assert::AreEqual(9ull, static_cast<unsigned long long>(batch.items));
+		Assert::AreEqual(1ull, static_cast<unsigned long long>(sumBuckets(batch, hm::MaxTracedArgument)));
+		Assert::AreEqual(1ull, static_cast<unsigned long long>(sumBuckets(batch, 0)));
+		Assert::AreEqual(1ull, static_cast<unsigned long long>(sumBuckets(batch, 2)));
+		Assert::AreEqual(0ull, static_cast<unsigned long long>(snapshot[hm::Span::ConvexHullBuild].calls));
+
+		// the sink saw the spans completed while it was installed, and only those
+		bool sawInverse = false, sawBatch = false;
+		for( const hm::TraceEvent& event : sink.events ) {
+			sawInverse = sawInverse || (event.span == hm::Span::Inverse && event.argument == 5);
+			sawBatch = sawBatch || (event.span == hm::Span::CholeskyBatch && event.argument == 40 && event.items == 7);
+			Assert::IsTrue(event.span != hm::Span::CholeskyBatch || event.argument != 2);
+		}
+		Assert::IsTrue(sawInverse);
+		Assert::IsTrue(sawBatch);
+		Assert::IsTrue(std::strcmp("cholesky.batch", hm::spanName(hm::Span::CholeskyBatch)) == 0);
+		Assert::IsTrue(hm::traceTicksPerSecond() > 0.0);
+
+		// the snapshot buffer is overwritten when reused
+		hm::resetTracing();
+		hm::traceSnapshot(snapshot);
+		for( int s = 0; s < hm::NumSpans; ++s ) {
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(snapshot.spans[s].calls));
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(snapshot.spans[s].items));
+		}
+		Assert::AreEqual(0ull, static_cast<unsigned long long>(sumBuckets(snapshot[hm::Span::CholeskyBatch], 2)));
+
+		// a thread only allocates the histograms it records into
+		Assert::IsTrue(sizeof(hm::detail::TraceBlock) <= 4096);
+	}
+
+	TEST_METHOD(Threads) {
+		hm::resetTracing();
+		const int numThreads = 4, spansPerThread = 25;
+
+		// threads that have exited are retired into the snapshot
+		std::vector<std::thread> finished;
+		for( int t = 0; t < numThreads; ++t ) {
+			finished.emplace_back([t]() {
+				for( int i = 0; i < spansPerThread; ++i ) {
+					HMATH_TRACE_BATCH(MultiplyBatch, t, 2);
+				}
+			});
+		}
+		for( auto& thread : finished ) {
+			thread.join();
+		}
+
+		// and a thread still running is read live
+		std::atomic<bool> recorded(false), release(false);
+		std::thread running([&]() {
+			{
+				HMATH_TRACE_BATCH(MultiplyBatch, numThreads, 2);
+			}
+			recorded = true;
+			while( !release ) {
+				std::this_thread::yield();
+			}
+		});
+		while( !recorded ) {
+			std::this_thread::yield();
+		}
+		{
+			HMATH_TRACE_BATCH(MultiplyBatch, numThreads, 2);
+		}
+
+		hm::TraceSnapshot snapshot;
+		hm::traceSnapshot(snapshot);
+		release = true;
+		running.join();
+
+		const hm::SpanHistogram& multiply = snapshot[hm::Span::MultiplyBatch];
+		const unsigned long long total = numThreads * spansPerThread + 2;
+		Assert::AreEqual(total, static_cast<unsigned long long>(multiply.calls));
+		Assert::AreEqual(2 * total, static_cast<unsigned long long>(multiply.items));
+		for( int t = 0; t < numThreads; ++t ) {
+			Assert::AreEqual(static_cast<unsigned long long>(spansPerThread), static_cast<unsigned long long>(sumBuckets(multiply, t)));
+		}
+		Assert::AreEqual(2ull, static_cast<unsigned long long>(sumBuckets(multiply, numThreads)));
+		hm::resetTracing();
+	}
+};
+
+}
+
+#else
+
+namespace hmath_test {
+
+TEST_CLASS(TracingTest) {
+	// fails on any event
+	class FailingSink : public hm::TraceSink {
+	public:
+		void onSpan( const hm::TraceEvent& ) override {
+			Assert::Fail();
+		}
+	};
+
+	TEST_METHOD(Disabled) {
+		FailingSink sink;
+		hm::setTraceSink(&sink);
+		bool invertible;
+		hm::inverse(hm::Matrix<5, 5>::identity(), &invertible);
+		Assert::IsTrue(invertible);
+		{
+			HMATH_TRACE_BATCH(CholeskyBatch, 40, 7);
+			HMATH_TRACE_SCOPE(CholeskyBatch, 2);
+		}
+		hm::setTraceSink(nullptr);
+		hm::resetTracing();
+
+		// nothing is recorded, and the snapshot is all zero
+		hm::TraceSnapshot snapshot;
+		hm::traceSnapshot(snapshot);
+		for( int s = 0; s < hm::NumSpans; ++s ) {
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(snapshot.spans[s].calls));
+			Assert::AreEqual(0ull, static_cast<unsigned long long>(snapshot.spans[s].items));
+		}
+		Assert::IsTrue(hm::traceTicksPerSecond() > 0.0);
+	}
+};
+
+}
+
+#endif